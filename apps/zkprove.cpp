@@ -2,6 +2,7 @@
 #include "zkmini/r1cs.hpp"
 #include "zkmini/qap.hpp"
 #include "zkmini/utils.hpp"
+#include "zkmini/witness.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -14,10 +15,12 @@ std::vector<Fr> parse_witness(const std::string& witness_str) {
     std::string token;
     
     while (std::getline(ss, token, ',')) {
-        // TODO: Parse field element from string
-        // For now, just convert to integer
-        uint64_t val = std::stoull(StringUtils::trim(token));
-        witness.push_back(Fr(val));
+        std::string value = StringUtils::trim(token);
+        if (value.compare(0, 2, "0x") == 0) {
+            witness.push_back(Fr::from_hex(value));
+        } else {
+            witness.push_back(Fr::from_decimal(value));
+        }
     }
     
     return witness;
@@ -26,47 +29,65 @@ std::vector<Fr> parse_witness(const std::string& witness_str) {
 int main(int argc, char* argv[]) {
     if (argc != 6) {
         std::cerr << "Usage: " << argv[0] << " <r1cs_file> <pk_file> <public_inputs> <private_inputs> <proof_file>" << std::endl;
-        std::cerr << "  public_inputs: comma-separated field elements" << std::endl;
+        std::cerr << "       " << argv[0] << " <r1cs_file> <pk_file> --witness <wtns_file> <proof_file>" << std::endl;
+        std::cerr << "  public_inputs: comma-separated field elements (decimal or 0x-hex)" << std::endl;
         std::cerr << "  private_inputs: comma-separated field elements" << std::endl;
+        std::cerr << "  wtns_file: full assignment in iden3 .wtns format (e.g. from circom)" << std::endl;
         return 1;
     }
     
     std::string r1cs_file = argv[1];
     std::string pk_file = argv[2];
-    std::string public_str = argv[3];
-    std::string private_str = argv[4];
+    bool from_file = std::string(argv[3]) == "--witness";
+    std::string public_str = from_file ? "" : argv[3];
+    std::string private_str = from_file ? "" : argv[4];
+    std::string witness_file = from_file ? argv[4] : "";
     std::string proof_file = argv[5];
     
     try {
         ZK_TIMER("Prove Phase");
         
         std::cout << "Loading R1CS from: " << r1cs_file << std::endl;
-        R1CS r1cs;
-        // TODO: Implement R1CS loading
+        R1CS r1cs = R1CS::load_iden3(r1cs_file);
         
         std::cout << "Loading proving key from: " << pk_file << std::endl;
-        ProvingKey pk = ProvingKey::load_from_file(pk_file);
+        KeyLoadStats key_stats;
+        ProvingKey pk = ProvingKey::load_from_file(pk_file, false, &key_stats);
+        std::cout << "Proving key: " << key_stats.points << " points in " << key_stats.seconds * 1000
+                  << " ms (" << static_cast<uint64_t>(key_stats.points_per_second()) << " points/s)" << std::endl;
         
         std::cout << "Converting R1CS to QAP..." << std::endl;
-        QAP qap = r1cs_to_qap(r1cs);
-        
-        std::cout << "Parsing witness..." << std::endl;
-        std::vector<Fr> public_inputs = parse_witness(public_str);
-        std::vector<Fr> private_inputs = parse_witness(private_str);
+        SparseQAP qap = r1cs_to_sparse_qap(r1cs);
         
-        std::cout << "Public inputs: " << public_inputs.size() << " elements" << std::endl;
-        std::cout << "Private inputs: " << private_inputs.size() << " elements" << std::endl;
+        std::vector<Fr> full_witness;
+        if (from_file) {
+            std::cout << "Loading witness from: " << witness_file << std::endl;
+            full_witness = WitnessFile::load(witness_file);
+            std::cout << "Witness: " << full_witness.size() << " elements" << std::endl;
+            
+            if (full_witness.size() != r1cs.num_variables() || full_witness[0] != Fr(1)) {
+                std::cerr << "Error: Witness does not match the R1CS (expected " << r1cs.num_variables()
+                          << " wires starting with 1)" << std::endl;
+                return 1;
+            }
+        } else {
+            std::cout << "Parsing witness..." << std::endl;
+            std::vector<Fr> public_inputs = parse_witness(public_str);
+            std::vector<Fr> private_inputs = parse_witness(private_str);
+            
+            std::cout << "Public inputs: " << public_inputs.size() << " elements" << std::endl;
+            std::cout << "Private inputs: " << private_inputs.size() << " elements" << std::endl;
+            
+            full_witness = r1cs.generate_full_assignment(public_inputs, private_inputs);
+        }
         
         // Verify witness satisfies R1CS
         std::cout << "Verifying witness..." << std::endl;
-        if (!r1cs.is_satisfied(public_inputs, private_inputs)) {
+        if (!r1cs.is_satisfied(full_witness)) {
             std::cerr << "Error: Witness does not satisfy R1CS!" << std::endl;
             return 1;
         }
         
-        // Generate full witness
-        std::vector<Fr> full_witness = r1cs.generate_full_assignment(public_inputs, private_inputs);
-        
         std::cout << "Generating proof..." << std::endl;
         Proof proof = Groth16::prove(pk, qap, full_witness);
         
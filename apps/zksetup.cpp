@@ -22,19 +22,16 @@ int main(int argc, char* argv[]) {
         
         std::cout << "Loading R1CS from: " << r1cs_file << std::endl;
         
-        // Load R1CS (placeholder - needs actual file format)
-        R1CS r1cs;
-        // TODO: Implement R1CS loading from file
-        // r1cs = R1CS::load_from_file(r1cs_file);
+        R1CS r1cs = R1CS::load_iden3(r1cs_file);
         
         std::cout << "Converting R1CS to QAP..." << std::endl;
-        QAP qap = r1cs_to_qap(r1cs);
+        SparseQAP qap = r1cs_to_sparse_qap(r1cs);
         
         std::cout << "Generating trusted setup..." << std::endl;
-        CRS crs = Groth16::setup(r1cs);
+        CRS crs = Groth16::setup(qap);
         
         std::cout << "Saving proving key to: " << pk_file << std::endl;
-        crs.pk.save_to_file(pk_file);
+        crs.pk.save_mmap(pk_file);
         
         std::cout << "Saving verifying key to: " << vk_file << std::endl;
         crs.vk.save_to_file(vk_file);
@@ -44,6 +41,7 @@ int main(int argc, char* argv[]) {
         std::cout << "  Variables: " << qap.n << std::endl;
         std::cout << "  Public inputs: " << r1cs.public_inputs().size() << std::endl;
         std::cout << "  Constraints: " << qap.m << std::endl;
+        std::cout << "  Domain size: " << qap.domain_size << std::endl;
         
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
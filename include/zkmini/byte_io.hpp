@@ -0,0 +1,123 @@
+#pragma once
+
+#include "field.hpp"
+#include "g1.hpp"
+#include "g2.hpp"
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace zkmini {
+
+// Little-endian writer behind every serialize()/save_to_file(). In memory it fills
+// one buffer (pre-size it with the constructor's hint and nothing reallocates);
+// given a path it streams through a fixed buffer, so a file is never held whole.
+// Each put writes straight into the buffer: no per-value temporaries. A file writer
+// streams into "<path>.tmp" and only finish() renames it over <path>, so a write that
+// fails part-way (or a writer destroyed before finish()) removes the temp file and
+// leaves whatever was at <path> intact.
+class ByteWriter {
+public:
+    static constexpr size_t FILE_BUFFER = 1 << 20;
+
+    explicit ByteWriter(size_t size_hint = 0);
+    // Throws std::runtime_error if the file cannot be opened.
+    explicit ByteWriter(const std::string& path);
+    ~ByteWriter();
+
+    ByteWriter(const ByteWriter&) = delete;
+    ByteWriter& operator=(const ByteWriter&) = delete;
+
+    // n writable bytes at the end; at most FILE_BUFFER at a time for a file.
+    uint8_t* claim(size_t n) {
+        if (used + n > buf.size()) make_room(n);
+        uint8_t* p = buf.data() + used;
+        used += n;
+        return p;
+    }
+
+    void put_bytes(const void* data, size_t n);
+    void put_u32(uint32_t v) { store(claim(4), v, 4); }
+    void put_u64(uint64_t v) { store(claim(8), v, 8); }
+    void put_fr(const Fr& v);
+    // Points go in compressed form, as Serialization::compress_g1/g2 lay them out.
+    void put_g1(const G1& p);
+    void put_g2(const G2& p);
+    // Compressed back to back, in parallel slices of the buffer.
+    void put_g1_points(const G1Affine* points, size_t n);
+    void put_g2_points(const G2Affine* points, size_t n);
+
+    // Bytes written so far.
+    size_t size() const { return flushed + used; }
+    // The in-memory result.
+    std::vector<uint8_t> take();
+    // Writes out what is buffered, closes the temp file and renames it into place;
+    // throws std::runtime_error if either step failed, in which case the temp file is
+    // removed and the destination is left as it was.
+    void finish();
+
+private:
+    std::vector<uint8_t> buf;
+    size_t used;
+    size_t flushed;
+    std::ofstream file;
+    std::string path;
+    std::string tmp_path;
+    bool to_file;
+
+    static void store(uint8_t* p, uint64_t v, size_t n) {
+        for (size_t i = 0; i < n; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+    void make_room(size_t n);
+    void flush();
+    void discard();
+};
+
+// Bounds-checked reader over bytes already in memory (a vector or a mapped file).
+// Reading past the end, a count the remaining bytes cannot hold, or a malformed
+// value throws std::runtime_error.
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size) : ptr(data), n(size), pos(0) {}
+    explicit ByteReader(const std::vector<uint8_t>& data) : ByteReader(data.data(), data.size()) {}
+
+    // The next n bytes, in place.
+    const uint8_t* take(size_t count) {
+        if (count > n - pos) fail("truncated input");
+        const uint8_t* p = ptr + pos;
+        pos += count;
+        return p;
+    }
+
+    uint32_t get_u32() { return static_cast<uint32_t>(load(take(4), 4)); }
+    uint64_t get_u64() { return load(take(8), 8); }
+    // A u64 count of items that each take at least item_bytes, checked against
+    // the remaining input before anything is allocated for them.
+    size_t get_count(size_t item_bytes);
+    // Canonical limbs; a value not below r is rejected.
+    Fr get_fr();
+    G1 get_g1();
+    // One point, checked to lie in the order-r subgroup. Bulk point arrays are not:
+    // ProvingKey::validate() covers those.
+    G2 get_g2();
+    std::vector<G1Affine> get_g1_points(size_t count);
+    std::vector<G2Affine> get_g2_points(size_t count);
+
+    size_t offset() const { return pos; }
+    size_t remaining() const { return n - pos; }
+    bool at_end() const { return pos == n; }
+
+private:
+    const uint8_t* ptr;
+    size_t n;
+    size_t pos;
+
+    static uint64_t load(const uint8_t* p, size_t bytes) {
+        uint64_t v = 0;
+        for (size_t i = 0; i < bytes; ++i) v |= static_cast<uint64_t>(p[i]) << (8 * i);
+        return v;
+    }
+    [[noreturn]] static void fail(const char* message);
+};
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "field.hpp"
+#include "polynomial.hpp"
+#include "fft.hpp"
+#include <vector>
+
+namespace zkmini {
+class EvalPoly {
+public:
+    // Subgroup: values at w^i.  Coset: values at g*w^i (see FFT::coset_fft).
+    enum class Domain { Subgroup, Coset };
+
+
+    EvalPoly();
+    explicit EvalPoly(size_t domain_size, Domain domain = Domain::Subgroup);
+    EvalPoly(std::vector<Fr> evals, Domain domain = Domain::Subgroup);
+
+
+    // Coefficients are kept as-is and transformed on first access to the values.
+    static EvalPoly from_polynomial(const Polynomial& p, size_t domain_size,
+                                    Domain domain = Domain::Subgroup);
+    static std::vector<EvalPoly> from_polynomials(const std::vector<Polynomial>& polys,
+                                                  size_t domain_size,
+                                                  Domain domain = Domain::Subgroup);
+
+
+    Polynomial to_polynomial() const;
+    EvalPoly to_domain(Domain target) const;
+
+
+    size_t size() const { return n; }
+    Domain domain() const { return dom; }
+    const FFT& fft() const { return FFT::cached(n); }
+    const std::vector<Fr>& evaluations() const;
+    const Fr& operator[](size_t i) const { return evaluations()[i]; }
+    void set(size_t i, const Fr& v);
+
+
+    EvalPoly& operator+=(const EvalPoly& other);
+    EvalPoly& operator-=(const EvalPoly& other);
+    EvalPoly& operator*=(const EvalPoly& other);
+    EvalPoly& operator*=(const Fr& k);
+
+    EvalPoly operator+(const EvalPoly& other) const;
+    EvalPoly operator-(const EvalPoly& other) const;
+    EvalPoly operator*(const EvalPoly& other) const;
+    EvalPoly operator*(const Fr& k) const;
+
+    bool operator==(const EvalPoly& other) const;
+
+private:
+    size_t n;
+    Domain dom;
+
+
+    // Either representation may be stale; the flags say which one is current.
+    // Lazy conversion mutates these from const accessors, so a single EvalPoly
+    // must not be read from several threads before it has been materialised.
+    mutable std::vector<Fr> evals;
+    mutable std::vector<Fr> coeffs;
+    mutable bool has_evals;
+    mutable bool has_coeffs;
+
+    void ensure_evals() const;
+    void ensure_coeffs() const;
+    void check_compatible(const EvalPoly& other) const;
+    void invalidate_coeffs();
+};
+
+}
@@ -16,8 +16,24 @@ public:
     
     std::vector<Fr> ifft(const std::vector<Fr>& evals) const;
     
+    // Evaluation / interpolation over the coset g*H, g = multiplicative generator.
+    std::vector<Fr> coset_fft(const std::vector<Fr>& coeffs) const;
+    std::vector<Fr> coset_ifft(const std::vector<Fr>& evals) const;
+    
+    // In-place transforms of several same-size vectors sharing one pass over the twiddles.
+    void fft_batch(std::vector<std::vector<Fr>>& polys, bool coset = false) const;
+    void ifft_batch(std::vector<std::vector<Fr>>& evals, bool coset = false) const;
+    
+    // Z(X) = X^n - 1 takes the constant value g^n - 1 on every coset point.
+    Fr vanishing_on_coset() const { return coset_vanishing; }
+    const Fr& get_coset_shift() const { return coset_shift; }
+    
+    
+    // Shared, lazily built domain of the given size; reused across calls.
+    static const FFT& cached(size_t domain_size);
     
     static Polynomial multiply(const Polynomial& a, const Polynomial& b);
+    static Polynomial square(const Polynomial& a);
     
     
     std::vector<Fr> evaluate_on_domain(const Polynomial& poly) const;
@@ -25,6 +41,11 @@ public:
     
     Polynomial interpolate_on_domain(const std::vector<Fr>& evals) const;
     
+    // L_j(x) for every j: (x^n - 1) / n * w^j / (x - w^j), one batch inversion.
+    std::vector<Fr> lagrange_basis_at(const Fr& x) const;
+    // The same over domain = (1, w, ..., w^(n-1)) given as points; builds no tables.
+    static std::vector<Fr> lagrange_basis_at(const std::vector<Fr>& domain, const Fr& x);
+    
     
     Fr get_root_of_unity(size_t i) const;
     
@@ -42,16 +63,29 @@ private:
     
     std::vector<Fr> twiddles;
     std::vector<Fr> inv_twiddles;
+    Fr inv_n;
+    
+    
+    Fr coset_shift;
+    Fr coset_vanishing;
+    std::vector<Fr> coset_powers_bitrev;  // g^rev(i), consumed by the first stage
+    std::vector<Fr> coset_inv_scale;      // g^-i / n, applied by the last stage
     
     void compute_domain();
     void compute_twiddles();
+    void compute_coset();
     
     
-    void fft_in_place(std::vector<Fr>& a, bool inverse) const;
+    void fft_in_place(std::vector<Fr>& a, bool inverse,
+                      const Fr* pre_scale = nullptr, const Fr* post_scale = nullptr) const;
+    void transform(std::vector<Fr>* const* polys, size_t count, bool inverse,
+                   const Fr* pre_scale, const Fr* post_scale) const;
     void bit_reverse(std::vector<Fr>& a) const;
     
     
     static Fr find_root_of_unity(size_t n);
+    
+    static constexpr size_t MIN_PARALLEL_BUTTERFLIES = 1 << 10;
 };
 
 }
\ No newline at end of file
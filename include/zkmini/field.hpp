@@ -21,9 +21,40 @@ namespace bn254_fr {
         0x30644e72e131a029ULL
     };
     
-    constexpr std::array<uint64_t, 4> R_BN254 = {0};
-    constexpr std::array<uint64_t, 4> R2_BN254 = {0};
-    constexpr uint64_t INV_BN254 = 0;
+    constexpr std::array<uint64_t, 4> R_BN254 = {
+        0xac96341c4ffffffbULL,
+        0x36fc76959f60cd29ULL,
+        0x666ea36f7879462eULL,
+        0x0e0a77c19a07df2fULL
+    };
+    
+    constexpr std::array<uint64_t, 4> R2_BN254 = {
+        0x1bb8e645ae216da7ULL,
+        0x53fe3ab1e35c59e3ULL,
+        0x8c49833d53bb8085ULL,
+        0x0216d0b17f4e44a5ULL
+    };
+    
+    constexpr uint64_t INV_BN254 = 0xc2e1f593efffffffULL;
+    
+    // r - 1 = 2^28 * t, and 5 generates the full multiplicative group.
+    constexpr size_t TWO_ADICITY = 28;
+    constexpr uint64_t GENERATOR = 5;
+    constexpr std::array<uint64_t, 4> TWO_ADIC_ROOT_OF_UNITY = {
+        0x9bd61b6e725b19f0ULL,
+        0x402d111e41112ed4ULL,
+        0x00e0a7eb8ef62abcULL,
+        0x2a3c09f0a58a7e85ULL
+    };
+    
+    // 2^576 mod r: one Montgomery product with it undoes the 2^-320 left by
+    // Fr::MulAccumulator's five reduction rounds.
+    constexpr std::array<uint64_t, 4> ACC_FIXUP_BN254 = {
+        0x70ffd56836b3c9a9ULL,
+        0xebd0f16a2ead19ebULL,
+        0x0f032333ef494ed2ULL,
+        0x0b03bd4e9ae5b82fULL
+    };
 }
 
 class Fr {
@@ -70,16 +101,38 @@ public:
     Fr pow(uint64_t exponent) const;
     Fr pow(const Fr& exponent) const;
     Fr inverse() const;
+    // Montgomery's trick: inverts every non-zero entry with a single inversion.
+    static void batch_inverse(std::vector<Fr>& elems);
     
     uint64_t to_uint64() const;
     std::vector<uint8_t> to_bytes() const;
     static Fr from_bytes(const std::vector<uint8_t>& bytes);
     std::string to_hex() const;
     static Fr from_hex(const std::string& hex);
+    // Base-10 digits of any length, reduced mod r; throws std::invalid_argument otherwise.
+    static Fr from_decimal(const std::string& dec);
     
     
     static Fr conditional_select(bool condition, const Fr& a, const Fr& b);
     
+    // Coefficients of the form +-k with k < 2^32 (bit-decomposition weights, small
+    // constants). mul_small(k) is a 4x1 limb multiply and one quotient estimate
+    // instead of a full Montgomery product; it requires k < 2^32.
+    bool as_small(uint32_t& magnitude, bool& negative) const;
+    Fr mul_small(uint64_t k) const;
+    
+    // Sum of products kept as an unreduced 576-bit integer: each add_product is a
+    // plain 4x4 limb multiply, and result() reduces once for the whole sum.
+    class MulAccumulator {
+    public:
+        void add_product(const Fr& a, const Fr& b);
+        void add(const Fr& a);
+        Fr result() const;
+    
+    private:
+        uint64_t acc[9] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+    };
+    
     std::string to_string() const;
     bool is_valid() const;
 
@@ -95,6 +148,7 @@ private:
     static std::array<uint64_t, 4> sub_256(const std::array<uint64_t, 4>& a, const std::array<uint64_t, 4>& b);
     static std::array<uint64_t, 4> neg_256(const std::array<uint64_t, 4>& a);
     static std::array<uint64_t, 4> mul_256(const std::array<uint64_t, 4>& a, const std::array<uint64_t, 4>& b);
+    static std::array<uint64_t, 4> mont_mul_256(const std::array<uint64_t, 4>& a, const std::array<uint64_t, 4>& b);
     static std::array<uint64_t, 4> pow_256(const std::array<uint64_t, 4>& base, uint64_t exp);
     static std::array<uint64_t, 4> pow_256(const std::array<uint64_t, 4>& base, const std::array<uint64_t, 4>& exp);
     static std::array<uint64_t, 4> inv_256(const std::array<uint64_t, 4>& a);
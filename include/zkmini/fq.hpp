@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <vector>
 #include <string>
@@ -15,6 +16,8 @@ public:
     
     Fq();
     Fq(uint64_t val);
+    // Canonical limbs, least significant first; reduced if not below p.
+    explicit Fq(const std::array<uint64_t, 4>& limbs);
     
     Fq operator+(const Fq& other) const;
     Fq operator-(const Fq& other) const;
@@ -26,7 +29,16 @@ public:
     bool is_one() const;
     
     Fq inverse() const;
+    // Montgomery's trick, as Fr::batch_inverse: zero entries are left as zero.
+    static void batch_inverse(std::vector<Fq>& elems);
     Fq square() const;
+    // a^((p+1)/4), valid because p = 3 mod 4. Returns false, leaving root alone,
+    // when a is not a square.
+    bool sqrt(Fq& root) const;
+    // a > (p-1)/2, i.e. a is the larger of a and -a; the y sign of compressed points.
+    bool is_lexicographically_largest() const;
+    // Limbs < p. Always true for arithmetic results; raw loaded data may not be.
+    bool is_reduced() const;
     
     uint64_t get_data(int i) const { return data[i]; }
     
@@ -23,6 +23,13 @@ public:
     
     Fq2 inverse() const;
     Fq2 square() const;
+    // False, leaving root alone, when a is not a square in Fq2.
+    bool sqrt(Fq2& root) const;
+    // Replaces each element by sqrt() of it, sharing one Fq inversion. False, with
+    // elems unspecified, if any element is not a square.
+    static bool batch_sqrt(std::vector<Fq2>& elems);
+    // Compares c1 first, then c0.
+    bool is_lexicographically_largest() const;
     Fq2 conjugate() const;
     
     Fq2 frobenius_map(uint64_t power) const;
@@ -2,9 +2,12 @@
 
 #include "field.hpp"
 #include "fq.hpp"
+#include <vector>
 
 namespace zkmini {
 
+struct G1Affine;
+
 class G1 {
 public:
     Fq x, y, z;
@@ -15,6 +18,8 @@ public:
     
     G1 operator+(const G1& other) const;
     G1 operator-(const G1& other) const;
+    // Mixed addition: the other point has z = 1, saving a third of the multiplications.
+    G1 operator+(const G1Affine& other) const;
     G1 operator*(const Fr& scalar) const;
     
     bool operator==(const G1& other) const;
@@ -29,6 +34,33 @@ public:
     static G1 generator();
     
     static G1 random();
+    
+    // Affine forms of many points for the cost of one inversion (Montgomery's trick).
+    static std::vector<G1Affine> batch_normalize(const std::vector<G1>& points);
+};
+
+// Affine point, z = 1 implied, with (0, 0) standing for infinity (it is not on the
+// curve). Two canonical Fq and no padding, 64 bytes, which is also the record of the
+// mapped proving-key format, so an array of these can be read in place from a file.
+struct G1Affine {
+    Fq x, y;
+    
+    G1Affine();
+    G1Affine(const Fq& x, const Fq& y);
+    // One inversion; G1::batch_normalize() amortises it over many points.
+    explicit G1Affine(const G1& p);
+    // The curve point with this x and the larger (or smaller) of the two y; false
+    // when x^3 + 3 is not a square.
+    static bool from_x(const Fq& x, bool y_largest, G1Affine& out);
+    
+    G1 to_jacobian() const;
+    G1Affine negate() const;
+    
+    bool operator==(const G1Affine& other) const;
+    bool is_zero() const;
+    bool is_on_curve() const;
+    // Both coordinates below p.
+    bool is_reduced() const;
 };
 
 }
\ No newline at end of file
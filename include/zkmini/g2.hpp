@@ -2,9 +2,12 @@
 
 #include "field.hpp"
 #include "fq2.hpp"
+#include <vector>
 
 namespace zkmini {
 
+struct G2Affine;
+
 class G2 {
 public:
     Fq2 x, y, z;
@@ -15,11 +18,15 @@ public:
     
     G2 operator+(const G2& other) const;
     G2 operator-(const G2& other) const;
+    G2 operator+(const G2Affine& other) const;
     G2 operator*(const Fr& scalar) const;
     
     bool operator==(const G2& other) const;
     bool is_zero() const;
     bool is_on_curve() const;
+    // r * P = 0. Being on the curve is not enough: the cofactor is divisible by 3
+    // and 1471, so a point can carry a small-order torsion component.
+    bool is_in_subgroup() const;
     
     G2 double_point() const;
     G2 negate() const;
@@ -31,6 +38,29 @@ public:
     static G2 random();
     
     G2 frobenius_map(uint64_t power) const;
+    
+    static std::vector<G2Affine> batch_normalize(const std::vector<G2>& points);
+};
+
+// G1Affine's counterpart: each coordinate is c0 then c1, 128 bytes in all.
+struct G2Affine {
+    Fq2 x, y;
+    
+    G2Affine();
+    G2Affine(const Fq2& x, const Fq2& y);
+    explicit G2Affine(const G2& p);
+    static bool from_x(const Fq2& x, bool y_largest, G2Affine& out);
+    // from_x() for many points at once, sharing the square roots' inversion.
+    static bool from_x_batch(const std::vector<Fq2>& xs, const std::vector<bool>& y_largest,
+                             std::vector<G2Affine>& out);
+    
+    G2 to_jacobian() const;
+    G2Affine negate() const;
+    
+    bool operator==(const G2Affine& other) const;
+    bool is_zero() const;
+    bool is_on_curve() const;
+    bool is_reduced() const;
 };
 
 }
\ No newline at end of file
@@ -17,6 +17,8 @@ struct Proof {
     Proof(const G1& A, const G2& B, const G1& C);
     
     
+    void write(ByteWriter& out) const;
+    static Proof read(ByteReader& in);
     std::vector<uint8_t> serialize() const;
     static Proof deserialize(const std::vector<uint8_t>& data);
     
@@ -32,6 +34,10 @@ public:
     
     static CRS setup(const R1CS& r1cs);
     static Proof prove(const ProvingKey& pk, const QAP& qap, const std::vector<Fr>& full_witness);
+    
+    // Subgroup-domain pipeline; keys from setup(SparseQAP) only pair with prove(pk, SparseQAP).
+    static CRS setup(const SparseQAP& qap);
+    static Proof prove(const ProvingKey& pk, const SparseQAP& qap, const std::vector<Fr>& full_witness);
     static bool verify(const VerifyingKey& vk, const std::vector<Fr>& public_inputs, const Proof& proof);
     
     
@@ -39,12 +45,18 @@ public:
 
 private:
     
-    static void setup_crs_elements(CRS& crs, const QAP& qap, const R1CS& r1cs,
+    static void setup_crs_elements(CRS& crs, const QAPBasisEvaluation& at_tau, size_t degree,
+                                  const std::vector<VarIdx>& public_inputs,
                                   const Fr& tau, const Fr& alpha, const Fr& beta, 
                                   const Fr& gamma, const Fr& delta);
     
     
+    static Proof prove_with_h(const ProvingKey& pk, const std::vector<Fr>& full_witness,
+                              const Polynomial& H_poly);
+    
+    
     static Polynomial compute_h_polynomial(const QAP& qap, const std::vector<Fr>& full_witness);
+    static Polynomial compute_h_polynomial(const SparseQAP& qap, const std::vector<Fr>& full_witness);
     
     
     static G1 compute_vk_ic(const VerifyingKey& vk, const std::vector<Fr>& public_inputs);
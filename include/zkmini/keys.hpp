@@ -3,11 +3,40 @@
 #include "g1.hpp"
 #include "g2.hpp"
 #include "qap.hpp"
+#include "byte_io.hpp"
+#include <memory>
 #include <vector>
 #include <string>
 
 namespace zkmini {
 
+// Read-only array of affine points inside a mapped key file.
+template <typename T>
+class QueryView {
+public:
+    QueryView() : ptr(nullptr), n(0) {}
+    QueryView(const T* data, size_t size) : ptr(data), n(size) {}
+    
+    const T* data() const { return ptr; }
+    size_t size() const { return n; }
+    const T& operator[](size_t i) const { return ptr[i]; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + n; }
+
+private:
+    const T* ptr;
+    size_t n;
+};
+
+// Filled in by the proving-key loaders: points decoded (and validated, if asked)
+// and the wall time it took.
+struct KeyLoadStats {
+    size_t points = 0;
+    double seconds = 0;
+    
+    double points_per_second() const { return seconds > 0 ? points / seconds : 0; }
+};
+
 struct ProvingKey {
     G1 alpha_g1;
     G1 beta_g1;
@@ -16,23 +45,78 @@ struct ProvingKey {
     G2 delta_g2;
     
     
-    std::vector<G1> A_query_g1;    
-    std::vector<G2> B_query_g2;    
-    std::vector<G1> B_query_g1;    
-    std::vector<G1> K_query_g1;    
-    std::vector<G1> H_query_g1;    
+    // Affine: no z to store, and the MSMs add them with mixed additions.
+    std::vector<G1Affine> A_query_g1;    
+    std::vector<G2Affine> B_query_g2;    
+    std::vector<G1Affine> B_query_g1;    
+    std::vector<G1Affine> K_query_g1;    
+    std::vector<G1Affine> H_query_g1;    
     
     size_t num_variables;
     size_t num_public;
     size_t degree;
     
+    // A key from load_mmap() leaves the five query vectors empty and reads the
+    // queries through these views into the mapped file, so a query's pages are
+    // only faulted in when an MSM walks it and are shared between processes.
+    // materialize_queries() copies them into the vectors and drops the mapping.
+    QueryView<G1Affine> A_query_mapped;
+    QueryView<G2Affine> B_query_g2_mapped;
+    QueryView<G1Affine> B_query_g1_mapped;
+    QueryView<G1Affine> K_query_mapped;
+    QueryView<G1Affine> H_query_mapped;
+    
     ProvingKey();
     
+    bool is_mapped() const { return backing != nullptr; }
+    void materialize_queries();
+    
+    // Each query wherever it lives: the mapped file or the vectors.
+    QueryView<G1Affine> A_query_view() const { return query(A_query_mapped, A_query_g1); }
+    QueryView<G2Affine> B_query_g2_view() const { return query(B_query_g2_mapped, B_query_g2); }
+    QueryView<G1Affine> B_query_g1_view() const { return query(B_query_g1_mapped, B_query_g1); }
+    QueryView<G1Affine> K_query_view() const { return query(K_query_mapped, K_query_g1); }
+    QueryView<G1Affine> H_query_view() const { return query(H_query_mapped, H_query_g1); }
+    
+    // Throws std::runtime_error unless every point, mapped or in memory, has
+    // reduced coordinates, lies on its curve and is in the order-r subgroup. G1 has
+    // cofactor 1, so there the curve equation suffices. G2 points each get r * P = 0,
+    // in parallel; the G2 cofactor has small factors, so a random linear combination
+    // of the query would let torsion components through.
+    void validate() const;
+    
+    // Format v1, written from the query views, so a mapped key serializes too.
+    size_t serialized_size() const;
+    void write(ByteWriter& out) const;
+    static ProvingKey read(ByteReader& in);
     std::vector<uint8_t> serialize() const;
-    static ProvingKey deserialize(const std::vector<uint8_t>& data);
+    // Queries are decompressed in parallel chunks. Untrusted keys want validate.
+    static ProvingKey deserialize(const std::vector<uint8_t>& data, bool validate = false,
+                                  KeyLoadStats* stats = nullptr);
     
+    // load_from_file() recognises both formats.
     void save_to_file(const std::string& filename) const;
-    static ProvingKey load_from_file(const std::string& filename);
+    static ProvingKey load_from_file(const std::string& filename, bool validate = false,
+                                     KeyLoadStats* stats = nullptr);
+    
+    // Format v2: a header with a section index, then each query as a 64-byte
+    // aligned array of G1Affine/G2Affine records. load_mmap() maps the file and
+    // only decodes the five fixed points; validate checks every point in place
+    // (and so faults in the whole file).
+    void save_mmap(const std::string& filename) const;
+    static ProvingKey load_mmap(const std::string& filename, bool validate = false,
+                                KeyLoadStats* stats = nullptr);
+    static bool is_mmap_file(const std::string& filename);
+    
+    size_t num_points() const;
+
+private:
+    std::shared_ptr<const void> backing;
+    
+    template <typename T>
+    QueryView<T> query(const QueryView<T>& mapped, const std::vector<T>& points) const {
+        return is_mapped() ? mapped : QueryView<T>(points.data(), points.size());
+    }
 };
 
 struct VerifyingKey {
@@ -48,6 +132,9 @@ struct VerifyingKey {
     
     VerifyingKey();
     
+    size_t serialized_size() const;
+    void write(ByteWriter& out) const;
+    static VerifyingKey read(ByteReader& in);
     std::vector<uint8_t> serialize() const;
     static VerifyingKey deserialize(const std::vector<uint8_t>& data);
     
@@ -59,6 +146,9 @@ struct CRS {
     ProvingKey pk;
     VerifyingKey vk;
     
+    // Each key behind a u64 byte count.
+    void write(ByteWriter& out) const;
+    static CRS read(ByteReader& in);
     std::vector<uint8_t> serialize() const;
     static CRS deserialize(const std::vector<uint8_t>& data);
     
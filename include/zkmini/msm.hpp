@@ -13,6 +13,13 @@ public:
     
     static G2 msm_g2(const std::vector<Fr>& scalars, const std::vector<G2>& points);
     
+    // Affine bases, e.g. proving-key queries, read in place (a mapped key's too); n
+    // must match scalars. Bucket method over the windows in parallel, where every
+    // base goes into its bucket with a mixed addition. The Jacobian overloads above
+    // normalise their bases first and take the same path.
+    static G1 msm_g1(const std::vector<Fr>& scalars, const G1Affine* points, size_t n);
+    static G2 msm_g2(const std::vector<Fr>& scalars, const G2Affine* points, size_t n);
+    
     static G1 windowed_msm_g1(const std::vector<Fr>& scalars, 
                               const std::vector<G1>& points, 
                               size_t window_size = 4);
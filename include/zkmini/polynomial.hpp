@@ -12,6 +12,7 @@ public:
     
     Polynomial();
     Polynomial(const std::vector<Fr>& coeffs);
+    Polynomial(std::vector<Fr>&& coeffs);
     Polynomial(size_t degree); 
     
     
@@ -32,17 +33,39 @@ public:
     
     static Polynomial add(const Polynomial& a, const Polynomial& b);
     static Polynomial sub(const Polynomial& a, const Polynomial& b);
+    // Rvalue overloads reuse the temporary's buffer for the result.
+    static Polynomial add(Polynomial&& a, const Polynomial& b);
+    static Polynomial sub(Polynomial&& a, const Polynomial& b);
     static void add_inplace(Polynomial& dst, const Polynomial& src);
     static void sub_inplace(Polynomial& dst, const Polynomial& src);
     
     
     static Polynomial scalar_mul(const Polynomial& f, const Fr& k);
+    static Polynomial scalar_mul(Polynomial&& f, const Fr& k);
     static void scalar_mul_inplace(Polynomial& f, const Fr& k);
     
+    // dst += k * src in one pass, without materialising k * src.
+    static void axpy(Polynomial& dst, const Fr& k, const Polynomial& src);
+    
+    // sum_i k_i * f_i in one pass over a single output buffer.
+    static Polynomial linear_combination(const std::vector<Fr>& scalars,
+                                         const std::vector<const Polynomial*>& polys);
+    
     
     static Polynomial mul_schoolbook(const Polynomial& f, const Polynomial& g);
+    static Polynomial mul_karatsuba(const Polynomial& f, const Polynomial& g);
+    static Polynomial mul_fft(const Polynomial& f, const Polynomial& g);
+    
+    // Picks schoolbook / Karatsuba / NTT from the shorter operand's length.
+    static Polynomial mul(const Polynomial& f, const Polynomial& g);
     static Polynomial square(const Polynomial& f);
     
+    static constexpr size_t KARATSUBA_THRESHOLD = 16;
+    static constexpr size_t FFT_THRESHOLD = 128;
+    static constexpr size_t NEWTON_DIVISION_THRESHOLD = 256;
+    static constexpr size_t SUBPRODUCT_TREE_THRESHOLD = 64;
+    static constexpr size_t SUBPRODUCT_EVAL_THRESHOLD = 256;
+    
     
     static Fr eval(const Polynomial& f, const Fr& x);
     
@@ -51,12 +74,29 @@ public:
     
     
     static void divrem(const Polynomial& N, const Polynomial& D, Polynomial& Q, Polynomial& R);
+    static void divrem_long(const Polynomial& N, const Polynomial& D, Polynomial& Q, Polynomial& R);
+    static void divrem_newton(const Polynomial& N, const Polynomial& D, Polynomial& Q, Polynomial& R);
+    // As divrem_newton, with rev(D)^-1 mod X^k (k >= deg N - deg D + 1) supplied by the caller.
+    static void divrem_with_inverse(const Polynomial& N, const Polynomial& D,
+                                    const Polynomial& rev_d_inv, Polynomial& Q, Polynomial& R);
+    
+    // f^-1 mod X^k by Newton iteration; requires f(0) != 0.
+    static Polynomial inverse_mod_xk(const Polynomial& f, size_t k);
+    static Polynomial truncate(const Polynomial& f, size_t k);
+    static Polynomial reverse(const Polynomial& f, size_t len);
+    
+    // O(deg) division by Z(X) = X^n - 1; returns {Q, R}.
+    std::pair<Polynomial, Polynomial> divide_by_vanishing(size_t n) const;
+    bool is_subgroup_vanishing(size_t& n) const;
     
     
     static Polynomial vanishing(const std::vector<Fr>& points);
     
     
     static Polynomial lagrange_basis(const std::vector<Fr>& pts, size_t j);
+    // All L_j(x) over pts by the barycentric formula Z(x) / ((x - x_j) * prod_{k!=j}(x_j - x_k)).
+    // O(m) for roots of unity and for evenly spaced points, O(m^2) otherwise.
+    static std::vector<Fr> lagrange_basis_at(const std::vector<Fr>& pts, const Fr& x);
     static Polynomial interpolate(const std::vector<Fr>& pts, const std::vector<Fr>& vals);
     
     
@@ -65,10 +105,22 @@ public:
     bool equals(const Polynomial& other) const;
     
     
-    Polynomial operator+(const Polynomial& other) const;
-    Polynomial operator-(const Polynomial& other) const;
+    Polynomial operator+(const Polynomial& other) const &;
+    Polynomial operator+(const Polynomial& other) &&;
+    Polynomial operator+(Polynomial&& other) const &;
+    Polynomial operator+(Polynomial&& other) &&;
+    Polynomial operator-(const Polynomial& other) const &;
+    Polynomial operator-(const Polynomial& other) &&;
+    Polynomial operator-(Polynomial&& other) const &;
+    Polynomial operator-(Polynomial&& other) &&;
     Polynomial operator*(const Polynomial& other) const;
-    Polynomial operator*(const Fr& scalar) const;
+    Polynomial operator*(const Fr& scalar) const &;
+    Polynomial operator*(const Fr& scalar) &&;
+    
+    Polynomial& operator+=(const Polynomial& other);
+    Polynomial& operator-=(const Polynomial& other);
+    Polynomial& operator*=(const Polynomial& other);
+    Polynomial& operator*=(const Fr& scalar);
     bool operator==(const Polynomial& other) const;
     
     
@@ -3,7 +3,9 @@
 #include "r1cs.hpp"
 #include "polynomial.hpp"
 #include "fft.hpp"
+#include "utils.hpp"
 #include <vector>
+#include <tuple>
 
 namespace zkmini {
 
@@ -40,8 +42,49 @@ struct QAP {
     }
 };
 
+// QAP over the multiplicative subgroup of size domain_size = next_pow2(m): constraint k
+// sits at w^k, rows past m are zero and Z(X) = X^domain_size - 1. The R1CS matrices are
+// kept in CSR form; basis polynomials are never interpolated.
+struct SparseQAP {
+    size_t m;
+    size_t n;
+    size_t domain_size;
+    
+    
+    SparseMatrix A;
+    SparseMatrix B;
+    SparseMatrix C;
+    
+    
+    std::vector<VarIdx> public_indices;
+    
+    
+    SparseQAP() : m(0), n(0), domain_size(0) {}
+    
+    const FFT& fft() const { return FFT::cached(domain_size); }
+    
+    bool is_valid() const {
+        return A.num_rows() == m && B.num_rows() == m && C.num_rows() == m &&
+               domain_size >= m && BitUtils::is_power_of_two(domain_size);
+    }
+};
+
+// Per-variable values A_i(tau), B_i(tau), C_i(tau) and Z(tau).
+struct QAPBasisEvaluation {
+    std::vector<Fr> A;
+    std::vector<Fr> B;
+    std::vector<Fr> C;
+    Fr Z;
+};
+
 QAP r1cs_to_qap(const R1CS& r);
 
+std::vector<Fr> qap_domain_points(size_t m);
+
+// Sums coeff * L_k(tau) over the sparse R1CS rows instead of evaluating
+// interpolated basis polynomials: O(nnz + m) rather than O(n * m).
+QAPBasisEvaluation qap_basis_at(const R1CS& r, const std::vector<Fr>& domain_points, const Fr& tau);
+
 Polynomial assemble_A(const QAP& q, const std::vector<Fr>& x);
 Polynomial assemble_B(const QAP& q, const std::vector<Fr>& x);
 Polynomial assemble_C(const QAP& q, const std::vector<Fr>& x);
@@ -53,6 +96,23 @@ Polynomial compute_H(const Polynomial& A, const Polynomial& B,
 
 bool qap_check(const QAP& q, const std::vector<Fr>& x);
 
+SparseQAP r1cs_to_sparse_qap(const R1CS& r);
+
+// {Az, Bz, Cz} over the domain, zero-padded to domain_size.
+std::vector<std::vector<Fr>> sparse_qap_evaluations(const SparseQAP& q, const std::vector<Fr>& x);
+
+// A(X), B(X), C(X) of the witness: the evaluations above, one IFFT each.
+std::tuple<Polynomial, Polynomial, Polynomial> sparse_qap_polynomials(const SparseQAP& q,
+                                                                     const std::vector<Fr>& x);
+
+// Closed-form Lagrange values over the subgroup; Z(tau) = tau^domain_size - 1.
+QAPBasisEvaluation qap_basis_at(const SparseQAP& q, const Fr& tau);
+
+bool qap_check(const SparseQAP& q, const std::vector<Fr>& x);
+
+// H = (A*B - C) / Z in O(n log n) through the coset g*H; asserts the witness satisfies q.
+Polynomial compute_H(const SparseQAP& q, const std::vector<Fr>& x);
+
 std::pair<Polynomial, Polynomial> qap_num_den(const QAP& q, const std::vector<Fr>& x);
 
 std::string debug_basis(const QAP& q, size_t i);
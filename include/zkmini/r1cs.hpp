@@ -1,12 +1,16 @@
 #pragma once
 
 #include "field.hpp"
+#include "sparse_matrix.hpp"
 #include <vector>
 #include <unordered_map>
 #include <initializer_list>
 #include <string>
 
 namespace zkmini {
+class ByteWriter;
+class ByteReader;
+
 using VarIdx = size_t;
 struct Term {
     VarIdx idx;    
@@ -17,6 +21,42 @@ struct Term {
 };
 using LinearCombination = std::vector<Term>;
 
+// Staging area for R1CS::add_constraints: the A/B/C rows of many constraints packed
+// into one term array, three row offsets per constraint. clear() keeps the capacity,
+// so a builder can refill the same batch without reallocating.
+class ConstraintBatch {
+public:
+    void reserve(size_t constraints, size_t terms);
+    void add(const LinearCombination& a, const LinearCombination& b, const LinearCombination& c);
+    void clear();
+    
+    size_t size() const { return row_ends.size() / 3; }
+    size_t num_terms() const { return terms.size(); }
+
+private:
+    friend class R1CS;
+    
+    std::vector<Term> terms;
+    std::vector<size_t> row_ends;
+    
+    void append_row(const LinearCombination& L);
+};
+
+// Old/new variable numbering produced by R1CS::optimize(). Surviving variables keep
+// their relative order, so public inputs stay in the same order after translation.
+struct VariableMap {
+    static constexpr VarIdx REMOVED = static_cast<VarIdx>(-1);
+    
+    std::vector<VarIdx> old_to_new;
+    std::vector<VarIdx> new_to_old;
+    
+    size_t num_old() const { return old_to_new.size(); }
+    size_t num_new() const { return new_to_old.size(); }
+    
+    // Full assignment of the original system -> full assignment of the optimized one.
+    std::vector<Fr> translate_witness(const std::vector<Fr>& old_witness) const;
+};
+
 class R1CS {
 public:
     
@@ -32,6 +72,14 @@ public:
     std::vector<VarIdx> public_indices;
     
     
+    // Frozen CSR copies of A/B/C built by finalize(), which then releases the rows
+    // (see has_rows()); the CSC (transposed) copies only when finalize(true) asks
+    // for column access. Adding a constraint afterwards unfreezes the system until
+    // the next finalize().
+    SparseMatrix A_csr, B_csr, C_csr;
+    SparseMatrix A_csc, B_csc, C_csc;
+    
+    
     R1CS(size_t n_vars_hint = 1);
     
     
@@ -48,11 +96,23 @@ public:
     static LinearCombination lc_const(const Fr& c);
     static void lc_add_term(LinearCombination& L, VarIdx i, const Fr& c);
     static void lc_compress(LinearCombination& L);
+    // Sorts [begin, end) by variable in place, merges repeats and drops zero
+    // coefficients; returns the new end. Never allocates.
+    static Term* compress_terms(Term* begin, Term* end);
     
     
     void add_constraint(const LinearCombination& A_row,
                        const LinearCombination& B_row, 
                        const LinearCombination& C_row);
+    void add_constraint(LinearCombination&& A_row,
+                       LinearCombination&& B_row,
+                       LinearCombination&& C_row);
+    
+    // Compresses the batch in place and appends every constraint. On a finalized
+    // (or still empty) system the rows go only into the CSR copies, with no per-row
+    // allocation: it stays finalized without a rebuild, A/B/C are released until
+    // materialize_rows(), and the CSC copies are dropped.
+    void add_constraints(ConstraintBatch& batch);
     
     
     void add_mul(VarIdx a, VarIdx b, VarIdx c);  
@@ -65,13 +125,51 @@ public:
     bool is_satisfied_verbose(const std::vector<Fr>& x, size_t& first_bad_row, 
                              Fr& L_val, Fr& R_val, Fr& O_val) const;
     
+    // Az, Bz, Cz in one sparse matrix-vector pass, rows split across threads. Outputs
+    // are grown to the row count if shorter; entries past it are left untouched.
+    static void evaluate_rows(const SparseMatrix& A_rows,
+                              const SparseMatrix& B_rows,
+                              const SparseMatrix& C_rows,
+                              const std::vector<Fr>& x,
+                              std::vector<Fr>& az, std::vector<Fr>& bz, std::vector<Fr>& cz);
+    void evaluate_rows(const std::vector<Fr>& x,
+                       std::vector<Fr>& az, std::vector<Fr>& bz, std::vector<Fr>& cz) const;
+    
+    // Lowest k < rows with az[k] * bz[k] != cz[k], or rows if every row holds.
+    static size_t first_unsatisfied_row(const std::vector<Fr>& az, const std::vector<Fr>& bz,
+                                        const std::vector<Fr>& cz, size_t rows);
+    
     
     std::vector<Fr> column_values(const std::vector<LinearCombination>& M, VarIdx col) const;
     
     
-    void finalize();  
+    static SparseMatrix build_csr(const std::vector<LinearCombination>& M, size_t n_cols);
+    void finalize(bool build_csc = false);
+    bool is_finalized() const { return finalized; }
+    bool has_csc() const { return finalized && csc_built; }
+    
+    // A system from load_mmap() or add_constraints() may only have its CSR copies;
+    // A/B/C stay empty until materialize_rows() expands them. Anything that edits the
+    // system does that itself, and the const readers (serialize, to_json, debug_row,
+    // to_iden3, the dense QAP) fall back to the CSR copies. Only code indexing A/B/C
+    // directly needs the rows.
+    bool has_rows() const { return rows_materialized; }
+    void materialize_rows();
     std::string debug_row(size_t k) const;
     
+    // Row k of M (one of A, B, C) from wherever it currently lives: its length, and
+    // visit(VarIdx, const Fr&) called on each term in order.
+    size_t row_size(const std::vector<LinearCombination>& M, size_t k) const;
+    template <typename Visit>
+    void for_each_term(const std::vector<LinearCombination>& M, size_t k, Visit&& visit) const;
+    
+    // Substitutes away linear constraints (L * const = R, const * L = R) by solving
+    // each for a private variable, then drops constraints that became trivial or
+    // duplicated and variables no constraint mentions. Public inputs and the
+    // constant wire are never eliminated. Rewrites the system in place and returns
+    // the renumbering; a witness of the original translates with it.
+    VariableMap optimize();
+    
     
     bool is_satisfied(const std::vector<Fr>& public_inputs,
                      const std::vector<Fr>& private_inputs) const;
@@ -83,16 +181,49 @@ public:
     static R1CS deserialize(const std::vector<uint8_t>& data);
     static R1CS from_json(const std::string& json_str);
     std::string to_json() const;
+    
+    // iden3/circom binary .r1cs. Wires 1..nPubOut+nPubIn become the public inputs;
+    // constraint chunks are parsed in parallel straight from the mapped file and
+    // the system comes back finalized. Malformed input throws std::runtime_error.
+    static R1CS load_iden3(const std::string& path);
+    static R1CS from_iden3(const uint8_t* data, size_t size);
+    // Requires the public inputs to be wires 1..k, as the format implies.
+    std::vector<uint8_t> to_iden3() const;
+    
+    // Native layout mirroring the CSR copies: 64-byte aligned row offsets, column
+    // indices and coefficient ids per matrix, plus each coefficient table as
+    // canonical limbs. load_mmap() maps the file and hands out views into it
+    // without copying the index arrays. Offsets, column indices and coefficient ids
+    // are always bounds-checked, so a corrupt image throws std::runtime_error rather
+    // than being read out of bounds; validate also checks every coefficient is
+    // reduced (off by default, since files come from save_mmap()).
+    void save_mmap(const std::string& path) const;
+    static R1CS load_mmap(const std::string& path, bool validate = false);
 
 private:
     VarIdx next_var;  
+    bool finalized;
+    bool csc_built;
+    bool rows_materialized;
+    
+    const SparseMatrix& csr_of(const std::vector<LinearCombination>& M) const;
     
     void validate_constraint_index(size_t constraint_idx) const;
     void validate_variable_index(VarIdx var_idx) const;
     
     
-    std::vector<uint8_t> serialize_matrix(const std::vector<std::vector<Term>>& matrix) const;
-    static std::vector<std::vector<Term>> deserialize_matrix(const std::vector<uint8_t>& data, size_t& offset);
+    void serialize_matrix(ByteWriter& out, const std::vector<std::vector<Term>>& matrix) const;
+    static std::vector<std::vector<Term>> deserialize_matrix(ByteReader& in, size_t n_vars);
 };
 
+template <typename Visit>
+void R1CS::for_each_term(const std::vector<LinearCombination>& M, size_t k, Visit&& visit) const {
+    if (rows_materialized) {
+        for (const Term& term : M[k]) visit(term.idx, term.coeff);
+        return;
+    }
+    const SparseMatrix& csr = csr_of(M);
+    for (size_t e = csr.row_begin(k); e < csr.row_end(k); ++e) visit(VarIdx(csr.col(e)), csr.coeff(e));
+}
+
 }
\ No newline at end of file
@@ -41,12 +41,27 @@ public:
     static std::string g2_to_json(const G2& point);
     static G2 g2_from_json(const std::string& json_str);
     
-    
+    // Compressed points: x as little-endian limbs (G2: x.c0 then x.c1) with flags in
+    // the two spare top bits of the last byte, bit 7 set when y is the larger root
+    // and bit 6 alone for infinity. Decompression recovers y with a square root and
+    // throws std::runtime_error for a truncated, unreduced or off-curve encoding.
     static std::vector<uint8_t> serialize_g1_compressed(const G1& point);
     static G1 deserialize_g1_compressed(const std::vector<uint8_t>& data, size_t& offset);
     
     static std::vector<uint8_t> serialize_g2_compressed(const G2& point);
     static G2 deserialize_g2_compressed(const std::vector<uint8_t>& data, size_t& offset);
+    
+    static void compress_g1(const G1Affine& point, uint8_t* out);
+    static G1Affine decompress_g1(const uint8_t* in);
+    static void compress_g2(const G2Affine& point, uint8_t* out);
+    static G2Affine decompress_g2(const uint8_t* in);
+    
+    // n points, back to back, in parallel chunks; one square root per point (two or
+    // three in Fq for G2) and no per-point allocation.
+    static std::vector<uint8_t> compress_g1_batch(const std::vector<G1Affine>& points);
+    static std::vector<G1Affine> decompress_g1_batch(const uint8_t* data, size_t n);
+    static std::vector<uint8_t> compress_g2_batch(const std::vector<G2Affine>& points);
+    static std::vector<G2Affine> decompress_g2_batch(const uint8_t* data, size_t n);
 
     
     static void write_uint64(std::vector<uint8_t>& data, uint64_t value);
@@ -64,8 +79,9 @@ public:
     static constexpr size_t FR_SIZE = 32;  
     static constexpr size_t G1_SIZE = 64;  
     static constexpr size_t G2_SIZE = 128; 
-    static constexpr size_t G1_COMPRESSED_SIZE = 33; 
-    static constexpr size_t G2_COMPRESSED_SIZE = 65; 
+    static constexpr size_t G1_COMPRESSED_SIZE = 32; 
+    static constexpr size_t G2_COMPRESSED_SIZE = 64; 
+    static constexpr size_t PROOF_SIZE = 2 * G1_COMPRESSED_SIZE + G2_COMPRESSED_SIZE;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "field.hpp"
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace zkmini {
+// Cheap hash of a field element's limbs, for interning coefficient tables.
+struct FrLimbHash {
+    size_t operator()(const Fr& a) const {
+        return a.data[0] ^ (a.data[1] * 0x9e3779b97f4a7c15ULL) ^ (a.data[3] >> 7);
+    }
+};
+
+// Compressed sparse rows: the entries of row k are [row_ptr[k], row_ptr[k+1]) in
+// col_idx / coeff_ids. Built by appending rows; the last row stays open until close_row().
+//
+// Coefficients are interned: each entry holds a 32-bit id into a table of distinct
+// values, so a circuit made of 1, -1 and a few powers of two costs 8 bytes per entry.
+//
+// A matrix can also be a read-only view whose three index arrays live in external
+// memory (a mapped file); `backing` keeps that memory alive across copies.
+class SparseMatrix {
+public:
+    SparseMatrix();
+    explicit SparseMatrix(size_t num_cols);
+
+    // The arrays must outlive every copy of the result unless backing owns them;
+    // row_ptr has num_rows + 1 entries. The coefficient table is copied.
+    static SparseMatrix view(size_t num_cols, size_t num_rows, size_t nnz,
+                             const uint32_t* row_ptr, const uint32_t* col_idx,
+                             const uint32_t* coeff_ids, const Fr* table, size_t num_coeffs,
+                             std::shared_ptr<const void> backing);
+    // Takes arrays filled elsewhere (in parallel, say): row_ptr has num_rows + 1
+    // offsets, and each entry's id indexes table. Repeated table values are merged.
+    static SparseMatrix from_arrays(size_t num_cols, std::vector<uint32_t> row_ptr,
+                                    std::vector<uint32_t> col_idx, std::vector<uint32_t> coeff_ids,
+                                    const std::vector<Fr>& table);
+    bool is_view() const { return backing != nullptr; }
+    // Copies a view's arrays into owned storage so it can be appended to.
+    void detach();
+
+
+    void reserve(size_t rows, size_t nnz);
+    void push_term(size_t col, const Fr& coeff);
+    void close_row();
+    void clear();
+
+
+    size_t num_rows() const { return backing ? mapped.rows : row_ptr.size() - 1; }
+    size_t num_cols() const { return cols; }
+    size_t nnz() const { return backing ? mapped.nnz : col_idx.size(); }
+    size_t num_coeffs() const { return coeff_table.size(); }
+
+    const uint32_t* row_ptr_data() const { return backing ? mapped.row_ptr : row_ptr.data(); }
+    const uint32_t* col_idx_data() const { return backing ? mapped.col_idx : col_idx.data(); }
+    const uint32_t* coeff_id_data() const { return backing ? mapped.coeff_ids : coeff_ids.data(); }
+    const Fr& coeff_value(uint32_t id) const { return coeff_table[id]; }
+
+    size_t row_begin(size_t k) const { return row_ptr_data()[k]; }
+    size_t row_end(size_t k) const { return row_ptr_data()[k + 1]; }
+    uint32_t col(size_t e) const { return col_idx_data()[e]; }
+    uint32_t coeff_id(size_t e) const { return coeff_id_data()[e]; }
+    const Fr& coeff(size_t e) const { return coeff_table[coeff_id(e)]; }
+
+    // Coefficients +-k with k < 2^32 carry k here (0 for anything else), so hot
+    // loops add or subtract for +-1 and use Fr::mul_small for the rest.
+    uint32_t small_magnitude(size_t e) const { return coeff_class[coeff_id(e)].magnitude; }
+    bool is_unit(size_t e) const { return small_magnitude(e) == 1; }
+    bool is_negative(size_t e) const { return coeff_class[coeff_id(e)].negative; }
+
+
+    Fr row_dot(size_t k, const std::vector<Fr>& x) const;
+
+    // CSC view: the transpose as another CSR matrix, so column j of this is row j of that.
+    SparseMatrix transpose() const;
+
+    // Heap bytes owned by this matrix; a view's mapped arrays are not counted.
+    size_t memory_bytes() const;
+
+private:
+    struct CoeffClass {
+        uint32_t magnitude;
+        bool negative;
+    };
+
+    size_t cols;
+    std::vector<uint32_t> row_ptr;
+    std::vector<uint32_t> col_idx;
+    std::vector<uint32_t> coeff_ids;
+
+    std::vector<Fr> coeff_table;
+    std::vector<CoeffClass> coeff_class;
+    std::unordered_map<Fr, uint32_t, FrLimbHash> interned;
+
+    struct MappedArrays {
+        const uint32_t* row_ptr;
+        const uint32_t* col_idx;
+        const uint32_t* coeff_ids;
+        size_t rows;
+        size_t nnz;
+    };
+    MappedArrays mapped;
+    std::shared_ptr<const void> backing;
+
+    uint32_t intern(const Fr& coeff);
+};
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "field.hpp"
+#include "polynomial.hpp"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace zkmini {
+class SubproductTree {
+public:
+
+    explicit SubproductTree(const std::vector<Fr>& points);
+
+
+    static std::shared_ptr<const SubproductTree> cached(const std::vector<Fr>& points);
+
+
+    std::vector<Fr> evaluate(const Polynomial& f) const;
+
+
+    // Throws std::invalid_argument if two points coincide.
+    Polynomial interpolate(const std::vector<Fr>& values) const;
+
+
+    const Polynomial& vanishing() const { return levels.back()[0]; }
+
+    const std::vector<Fr>& get_points() const { return points; }
+    size_t size() const { return points.size(); }
+
+
+    static constexpr size_t LEAF_SIZE = 16;
+    static constexpr size_t NEWTON_NODE_DEGREE = 64;
+    static constexpr size_t CACHE_ENTRIES = 4;
+
+private:
+    std::vector<Fr> points;
+
+
+    // levels[0][j] covers points [j*LEAF_SIZE, (j+1)*LEAF_SIZE); each level above
+    // halves the node count, an unpaired last node is carried up unchanged.
+    std::vector<std::vector<Polynomial>> levels;
+
+
+    // 1 / M'(x_i), built on first interpolate()
+    mutable std::once_flag weights_once;
+    mutable std::vector<Fr> inv_weights;
+
+
+    // rev(M_node)^-1 mod X^(deg parent - deg node) for large nodes, built on first evaluate()
+    mutable std::once_flag inverses_once;
+    mutable std::vector<std::vector<Polynomial>> rev_inverses;
+
+    void build();
+    void compute_weights() const;
+    void compute_inverses() const;
+
+    size_t node_begin(size_t level, size_t j) const;
+    size_t node_end(size_t level, size_t j) const;
+};
+
+}
@@ -5,6 +5,8 @@
 #include <iostream>
 #include <cassert>
 #include <vector>
+#include <functional>
+#include <cstdint>
 
 namespace zkmini {
 
@@ -96,6 +98,19 @@ public:
     
     static uint64_t reverse_bits(uint64_t x);
 };
+class Parallel {
+public:
+    
+    static size_t num_threads();
+    
+    // Splits [begin, end) into contiguous chunks of at least min_chunk items and
+    // runs body(chunk_begin, chunk_end) on worker threads. Runs inline when the
+    // range is too small to be worth a thread. The first exception a chunk throws
+    // is rethrown to the caller once every chunk has finished.
+    static void parallel_for(size_t begin, size_t end,
+                             const std::function<void(size_t, size_t)>& body,
+                             size_t min_chunk = 1);
+};
 class StringUtils {
 public:
     
@@ -113,5 +128,28 @@ public:
     
     static std::string join(const std::vector<std::string>& strings, const std::string& delimiter);
 };
+// Read-only view of a whole file, memory-mapped where the platform allows (read
+// into memory otherwise). Throws std::runtime_error if the file cannot be opened.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    const uint8_t* data() const { return ptr; }
+    size_t size() const { return len; }
+
+private:
+    const uint8_t* ptr;
+    size_t len;
+    bool mapped;
+    std::vector<uint8_t> buffer;
+    
+    void release();
+};
 
 }
\ No newline at end of file
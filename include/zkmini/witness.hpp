@@ -0,0 +1,146 @@
+#pragma once
+
+#include "r1cs.hpp"
+#include "sparse_matrix.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace zkmini {
+// Straight-line program that fills every wire of a circuit from its inputs. Each
+// instruction writes wires from wires written before it, so the recording order is
+// already a valid schedule. Linear-combination operands are rows of one SparseMatrix
+// and get the same +-1 / small-constant fast paths as constraint evaluation.
+//
+// run(..., parallel = true) groups instructions by depth (longest path from the
+// inputs): a level only reads earlier levels, so independent sub-circuits fill
+// concurrently, and the divisions of a level share one batched inversion. A serial
+// run takes the same schedule (inline) whenever the program divides more than once.
+class WitnessProgram {
+public:
+    // Reads the input wires, writes every output; out arrives sized. Hints run on
+    // worker threads in parallel mode, so they must be thread-safe and not throw.
+    using HintFn = std::function<void(const std::vector<Fr>& in, std::vector<Fr>& out)>;
+
+    WitnessProgram();
+
+    // w[dst] = public_inputs[slot] / private_inputs[slot]
+    void public_input(VarIdx dst, size_t slot);
+    void private_input(VarIdx dst, size_t slot);
+    // w[dst] = L(w)
+    void linear(VarIdx dst, const LinearCombination& L);
+    // w[dst] = a(w) * b(w)
+    void mul(VarIdx dst, const LinearCombination& a, const LinearCombination& b);
+    // w[dst] = a(w) / b(w), or 0 when b(w) = 0.
+    void div(VarIdx dst, const LinearCombination& a, const LinearCombination& b);
+    // w[dst] = bit `bit` of the canonical value of L(w).
+    void bit(VarIdx dst, const LinearCombination& L, uint32_t bit);
+    void hint(const std::vector<VarIdx>& outputs, const std::vector<VarIdx>& inputs, HintFn fn);
+
+    size_t num_wires() const { return assigned.size(); }
+    size_t num_instructions() const { return code.size(); }
+    size_t num_public_inputs() const { return n_public; }
+    size_t num_private_inputs() const { return n_private; }
+    // True once every wire past the constant one has an instruction.
+    bool is_complete() const;
+
+    // Full assignment with w[0] = 1. Throws std::invalid_argument when the input
+    // counts do not match the program.
+    std::vector<Fr> run(const std::vector<Fr>& public_inputs,
+                        const std::vector<Fr>& private_inputs,
+                        bool parallel = false) const;
+
+private:
+    enum class Op : uint8_t { PublicInput, PrivateInput, Linear, Mul, Div, Bit, Hint };
+
+    struct Instruction {
+        Op op;
+        uint32_t arg;   // input slot, bit index or hint id
+        uint32_t dst;   // target wire
+        uint32_t a;     // operand rows
+        uint32_t b;
+    };
+
+    // The wire list of hint h is hint_wires[begin, begin + n_out + n_in), outputs first.
+    struct Hint {
+        HintFn fn;
+        size_t begin;
+        uint32_t n_out;
+        uint32_t n_in;
+    };
+
+    std::vector<Instruction> code;
+    SparseMatrix operands;
+    std::vector<uint32_t> hint_wires;
+    std::vector<Hint> hints;
+    std::vector<bool> assigned;
+    size_t n_public;
+    size_t n_private;
+    size_t n_divisions;
+
+    uint32_t record_operand(const LinearCombination& L);
+    void claim(VarIdx dst);
+
+    void execute(const Instruction& ins, const std::vector<Fr>& public_inputs,
+                 const std::vector<Fr>& private_inputs, std::vector<Fr>& w) const;
+    void run_levels(const std::vector<Fr>& public_inputs, const std::vector<Fr>& private_inputs,
+                    std::vector<Fr>& w, bool threaded) const;
+};
+
+// Builds an R1CS and its WitnessProgram side by side: each gadget allocates its wires,
+// adds the constraints on them and records how to compute them.
+class CircuitBuilder {
+public:
+    CircuitBuilder();
+
+    // Public wires come first so they are wires 1..k, as generate_full_assignment,
+    // the iden3 format and the prover expect. A public output is computed later by
+    // set_output(), circom-style.
+    VarIdx public_input();
+    VarIdx public_output();
+    VarIdx private_input();
+
+    // out = a * b
+    VarIdx mul(const LinearCombination& a, const LinearCombination& b);
+    // out = L, bound by L * 1 = out
+    VarIdx linear(const LinearCombination& L);
+    void set_output(VarIdx out, const LinearCombination& L);
+    // out * a = 1; the witness is unsatisfiable when a is zero.
+    VarIdx inverse(const LinearCombination& a);
+    // n boolean wires, least significant first, that sum back to a (n <= 253).
+    std::vector<VarIdx> to_bits(const LinearCombination& a, size_t n);
+    void assert_equal(const LinearCombination& a, const LinearCombination& b);
+    // Unconstrained private wires computed by fn; the caller constrains them.
+    std::vector<VarIdx> hint(size_t n_out, const std::vector<VarIdx>& inputs, WitnessProgram::HintFn fn);
+
+    R1CS& r1cs() { return system; }
+    const R1CS& r1cs() const { return system; }
+    const WitnessProgram& program() const { return prog; }
+
+    std::vector<Fr> witness(const std::vector<Fr>& public_inputs,
+                            const std::vector<Fr>& private_inputs,
+                            bool parallel = false) const;
+
+private:
+    R1CS system;
+    WitnessProgram prog;
+    size_t n_public_in;
+    size_t n_private_in;
+    bool private_started;
+
+    VarIdx allocate();
+};
+
+// iden3 .wtns, as written by circom's witness calculators and snarkjs: the full
+// assignment (wire 0 first) as canonical little-endian field elements. load() maps
+// the file and copies the values section straight into the vector in parallel
+// chunks, checking each is below r. Malformed input throws std::runtime_error.
+class WitnessFile {
+public:
+    static std::vector<Fr> load(const std::string& path);
+    static std::vector<Fr> parse(const uint8_t* data, size_t size);
+    static std::vector<uint8_t> encode(const std::vector<Fr>& witness);
+    static void save(const std::string& path, const std::vector<Fr>& witness);
+};
+
+}
@@ -0,0 +1,164 @@
+#include "zkmini/byte_io.hpp"
+#include "zkmini/serialization.hpp"
+#include "zkmini/utils.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace zkmini {
+
+namespace {
+
+// Points per parallel work item when compressing into the buffer.
+constexpr size_t COMPRESS_CHUNK = 256;
+
+}
+
+ByteWriter::ByteWriter(size_t size_hint) : buf(size_hint), used(0), flushed(0), to_file(false) {}
+
+ByteWriter::ByteWriter(const std::string& path)
+    : buf(FILE_BUFFER), used(0), flushed(0), file(path + ".tmp", std::ios::binary), path(path),
+      tmp_path(path + ".tmp"), to_file(true) {
+    if (!file) throw std::runtime_error("Cannot open file for writing: " + tmp_path);
+}
+
+ByteWriter::~ByteWriter() {
+    if (to_file && file.is_open()) discard();
+}
+
+void ByteWriter::make_room(size_t n) {
+    if (to_file) {
+        ZK_ASSERT(n <= FILE_BUFFER, "Claim larger than the file buffer");
+        flush();
+        return;
+    }
+    buf.resize(std::max(used + n, 2 * buf.size()));
+}
+
+void ByteWriter::flush() {
+    file.write(reinterpret_cast<const char*>(buf.data()), used);
+    flushed += used;
+    used = 0;
+}
+
+void ByteWriter::put_bytes(const void* data, size_t n) {
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    while (n > 0) {
+        size_t k = to_file ? std::min(n, FILE_BUFFER) : n;
+        std::memcpy(claim(k), src, k);
+        src += k;
+        n -= k;
+    }
+}
+
+void ByteWriter::put_fr(const Fr& v) {
+    uint8_t* p = claim(Serialization::FR_SIZE);
+    for (size_t i = 0; i < 4; ++i) store(p + 8 * i, v.data[i], 8);
+}
+
+void ByteWriter::put_g1(const G1& p) {
+    Serialization::compress_g1(G1Affine(p), claim(Serialization::G1_COMPRESSED_SIZE));
+}
+
+void ByteWriter::put_g2(const G2& p) {
+    Serialization::compress_g2(G2Affine(p), claim(Serialization::G2_COMPRESSED_SIZE));
+}
+
+void ByteWriter::put_g1_points(const G1Affine* points, size_t n) {
+    const size_t size = Serialization::G1_COMPRESSED_SIZE;
+    while (n > 0) {
+        size_t k = to_file ? std::min(n, FILE_BUFFER / size) : n;
+        uint8_t* out = claim(k * size);
+        Parallel::parallel_for(0, k, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) Serialization::compress_g1(points[i], out + i * size);
+        }, COMPRESS_CHUNK);
+        points += k;
+        n -= k;
+    }
+}
+
+void ByteWriter::put_g2_points(const G2Affine* points, size_t n) {
+    const size_t size = Serialization::G2_COMPRESSED_SIZE;
+    while (n > 0) {
+        size_t k = to_file ? std::min(n, FILE_BUFFER / size) : n;
+        uint8_t* out = claim(k * size);
+        Parallel::parallel_for(0, k, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) Serialization::compress_g2(points[i], out + i * size);
+        }, COMPRESS_CHUNK);
+        points += k;
+        n -= k;
+    }
+}
+
+std::vector<uint8_t> ByteWriter::take() {
+    ZK_ASSERT(!to_file, "take() on a file writer");
+    buf.resize(used);
+    used = 0;
+    return std::move(buf);
+}
+
+void ByteWriter::finish() {
+    ZK_ASSERT(to_file, "finish() on an in-memory writer");
+    ZK_ASSERT(file.is_open(), "finish() called twice");
+    flush();
+    file.close();
+    if (!file) {
+        discard();
+        throw std::runtime_error("Failed writing file: " + tmp_path);
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        throw std::runtime_error("Cannot replace file: " + path);
+    }
+}
+
+// Whatever has been flushed is incomplete: drop it. The destination itself was
+// never touched.
+void ByteWriter::discard() {
+    used = 0;
+    file.close();
+    std::remove(tmp_path.c_str());
+}
+
+void ByteReader::fail(const char* message) {
+    throw std::runtime_error(std::string("Malformed input: ") + message);
+}
+
+size_t ByteReader::get_count(size_t item_bytes) {
+    uint64_t count = get_u64();
+    if (item_bytes > 0 && count > remaining() / item_bytes) fail("count exceeds the remaining input");
+    return static_cast<size_t>(count);
+}
+
+Fr ByteReader::get_fr() {
+    const uint8_t* p = take(Serialization::FR_SIZE);
+    std::array<uint64_t, 4> limbs;
+    for (size_t i = 0; i < 4; ++i) limbs[i] = load(p + 8 * i, 8);
+    Fr v;
+    v.data = limbs;
+    if (!v.is_valid()) fail("field element not below r");
+    return v;
+}
+
+G1 ByteReader::get_g1() {
+    return Serialization::decompress_g1(take(Serialization::G1_COMPRESSED_SIZE)).to_jacobian();
+}
+
+G2 ByteReader::get_g2() {
+    G2 p = Serialization::decompress_g2(take(Serialization::G2_COMPRESSED_SIZE)).to_jacobian();
+    if (!p.is_in_subgroup()) fail("G2 point not in the subgroup");
+    return p;
+}
+
+std::vector<G1Affine> ByteReader::get_g1_points(size_t count) {
+    if (count > remaining() / Serialization::G1_COMPRESSED_SIZE) fail("truncated input");
+    return Serialization::decompress_g1_batch(take(count * Serialization::G1_COMPRESSED_SIZE), count);
+}
+
+std::vector<G2Affine> ByteReader::get_g2_points(size_t count) {
+    if (count > remaining() / Serialization::G2_COMPRESSED_SIZE) fail("truncated input");
+    return Serialization::decompress_g2_batch(take(count * Serialization::G2_COMPRESSED_SIZE), count);
+}
+
+}
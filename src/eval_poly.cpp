@@ -0,0 +1,191 @@
+#include "zkmini/eval_poly.hpp"
+#include "zkmini/utils.hpp"
+
+namespace zkmini {
+
+EvalPoly::EvalPoly() : n(0), dom(Domain::Subgroup), has_evals(true), has_coeffs(true) {}
+
+EvalPoly::EvalPoly(size_t domain_size, Domain domain)
+    : n(domain_size), dom(domain), evals(domain_size, Fr()),
+      has_evals(true), has_coeffs(true) {
+    ZK_ASSERT(BitUtils::is_power_of_two(domain_size), "Domain size must be a power of two");
+}
+
+EvalPoly::EvalPoly(std::vector<Fr> evals, Domain domain)
+    : n(evals.size()), dom(domain), evals(std::move(evals)), has_evals(true), has_coeffs(false) {
+    ZK_ASSERT(BitUtils::is_power_of_two(n), "Domain size must be a power of two");
+}
+
+EvalPoly EvalPoly::from_polynomial(const Polynomial& p, size_t domain_size, Domain domain) {
+    ZK_ASSERT(BitUtils::is_power_of_two(domain_size), "Domain size must be a power of two");
+    ZK_ASSERT(p.coeffs.size() <= domain_size, "Polynomial degree exceeds evaluation domain");
+
+    EvalPoly result;
+    result.n = domain_size;
+    result.dom = domain;
+    result.coeffs = p.coeffs;
+    result.has_evals = false;
+    result.has_coeffs = true;
+    return result;
+}
+
+std::vector<EvalPoly> EvalPoly::from_polynomials(const std::vector<Polynomial>& polys,
+                                                 size_t domain_size, Domain domain) {
+    std::vector<std::vector<Fr>> batch;
+    batch.reserve(polys.size());
+    for (const auto& p : polys) {
+        ZK_ASSERT(p.coeffs.size() <= domain_size, "Polynomial degree exceeds evaluation domain");
+        batch.push_back(p.coeffs);
+    }
+
+    FFT::cached(domain_size).fft_batch(batch, domain == Domain::Coset);
+
+    std::vector<EvalPoly> result;
+    result.reserve(polys.size());
+    for (size_t k = 0; k < polys.size(); ++k) {
+        EvalPoly e(std::move(batch[k]), domain);
+        e.coeffs = polys[k].coeffs;
+        e.has_coeffs = true;
+        result.push_back(std::move(e));
+    }
+    return result;
+}
+
+void EvalPoly::ensure_evals() const {
+    if (has_evals) return;
+    evals = dom == Domain::Coset ? fft().coset_fft(coeffs) : fft().fft(coeffs);
+    has_evals = true;
+}
+
+void EvalPoly::ensure_coeffs() const {
+    if (has_coeffs) return;
+    coeffs = dom == Domain::Coset ? fft().coset_ifft(evals) : fft().ifft(evals);
+    has_coeffs = true;
+}
+
+void EvalPoly::invalidate_coeffs() {
+    has_coeffs = false;
+    coeffs.clear();
+}
+
+void EvalPoly::check_compatible(const EvalPoly& other) const {
+    ZK_ASSERT(n == other.n, "Evaluation domain size mismatch");
+    ZK_ASSERT(dom == other.dom, "Evaluation domain mismatch (subgroup vs coset)");
+}
+
+Polynomial EvalPoly::to_polynomial() const {
+    if (n == 0) return Polynomial();
+    ensure_coeffs();
+    return Polynomial(coeffs);
+}
+
+EvalPoly EvalPoly::to_domain(Domain target) const {
+    if (target == dom) return *this;
+    ensure_coeffs();
+    return from_polynomial(Polynomial(coeffs), n, target);
+}
+
+const std::vector<Fr>& EvalPoly::evaluations() const {
+    ensure_evals();
+    return evals;
+}
+
+void EvalPoly::set(size_t i, const Fr& v) {
+    ZK_ASSERT(i < n, "Evaluation index out of range");
+    ensure_evals();
+    evals[i] = v;
+    invalidate_coeffs();
+}
+
+EvalPoly& EvalPoly::operator+=(const EvalPoly& other) {
+    check_compatible(other);
+    ensure_evals();
+    const std::vector<Fr>& rhs = other.evaluations();
+    for (size_t i = 0; i < n; ++i) {
+        evals[i] = evals[i] + rhs[i];
+    }
+    // Addition commutes with the transform, so keep coefficients if both sides have them.
+    if (has_coeffs && other.has_coeffs) {
+        if (other.coeffs.size() > coeffs.size()) coeffs.resize(other.coeffs.size(), Fr());
+        for (size_t i = 0; i < other.coeffs.size(); ++i) {
+            coeffs[i] = coeffs[i] + other.coeffs[i];
+        }
+    } else {
+        invalidate_coeffs();
+    }
+    return *this;
+}
+
+EvalPoly& EvalPoly::operator-=(const EvalPoly& other) {
+    check_compatible(other);
+    ensure_evals();
+    const std::vector<Fr>& rhs = other.evaluations();
+    for (size_t i = 0; i < n; ++i) {
+        evals[i] = evals[i] - rhs[i];
+    }
+    if (has_coeffs && other.has_coeffs) {
+        if (other.coeffs.size() > coeffs.size()) coeffs.resize(other.coeffs.size(), Fr());
+        for (size_t i = 0; i < other.coeffs.size(); ++i) {
+            coeffs[i] = coeffs[i] - other.coeffs[i];
+        }
+    } else {
+        invalidate_coeffs();
+    }
+    return *this;
+}
+
+EvalPoly& EvalPoly::operator*=(const EvalPoly& other) {
+    check_compatible(other);
+    ensure_evals();
+    const std::vector<Fr>& rhs = other.evaluations();
+    for (size_t i = 0; i < n; ++i) {
+        evals[i] = evals[i] * rhs[i];
+    }
+    // The product is only known modulo the domain's vanishing polynomial;
+    // to_polynomial() recovers the unique representative of degree < n.
+    invalidate_coeffs();
+    return *this;
+}
+
+EvalPoly& EvalPoly::operator*=(const Fr& k) {
+    ensure_evals();
+    for (auto& e : evals) {
+        e = e * k;
+    }
+    if (has_coeffs) {
+        for (auto& c : coeffs) {
+            c = c * k;
+        }
+    }
+    return *this;
+}
+
+EvalPoly EvalPoly::operator+(const EvalPoly& other) const {
+    EvalPoly result = *this;
+    result += other;
+    return result;
+}
+
+EvalPoly EvalPoly::operator-(const EvalPoly& other) const {
+    EvalPoly result = *this;
+    result -= other;
+    return result;
+}
+
+EvalPoly EvalPoly::operator*(const EvalPoly& other) const {
+    EvalPoly result = *this;
+    result *= other;
+    return result;
+}
+
+EvalPoly EvalPoly::operator*(const Fr& k) const {
+    EvalPoly result = *this;
+    result *= k;
+    return result;
+}
+
+bool EvalPoly::operator==(const EvalPoly& other) const {
+    return n == other.n && dom == other.dom && evaluations() == other.evaluations();
+}
+
+}
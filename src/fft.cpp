@@ -1,5 +1,9 @@
 #include "zkmini/fft.hpp"
 #include "zkmini/utils.hpp"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
 
 namespace zkmini {
 
@@ -9,6 +13,7 @@ FFT::FFT(size_t domain_size) : domain_size(domain_size) {
     inv_root_of_unity = root_of_unity.inverse();
     compute_domain();
     compute_twiddles();
+    compute_coset();
 }
 
 std::vector<Fr> FFT::fft(const std::vector<Fr>& coeffs) const {
@@ -22,12 +27,59 @@ std::vector<Fr> FFT::ifft(const std::vector<Fr>& evals) const {
     std::vector<Fr> result = evals;
     ZK_ASSERT(result.size() == domain_size, "Evaluation vector size mismatch");
     fft_in_place(result, true);
+    return result;
+}
+
+std::vector<Fr> FFT::coset_fft(const std::vector<Fr>& coeffs) const {
+    ZK_ASSERT(coeffs.size() <= domain_size, "Coefficient vector larger than domain");
+    std::vector<Fr> result = coeffs;
+    result.resize(domain_size, Fr());
+    fft_in_place(result, false, coset_powers_bitrev.data(), nullptr);
+    return result;
+}
+
+std::vector<Fr> FFT::coset_ifft(const std::vector<Fr>& evals) const {
+    ZK_ASSERT(evals.size() == domain_size, "Evaluation vector size mismatch");
+    std::vector<Fr> result = evals;
+    fft_in_place(result, true, nullptr, coset_inv_scale.data());
+    return result;
+}
+
+void FFT::fft_batch(std::vector<std::vector<Fr>>& polys, bool coset) const {
+    std::vector<std::vector<Fr>*> ptrs;
+    ptrs.reserve(polys.size());
+    for (auto& p : polys) {
+        ZK_ASSERT(p.size() <= domain_size, "Coefficient vector larger than domain");
+        p.resize(domain_size, Fr());
+        ptrs.push_back(&p);
+    }
+    if (ptrs.empty()) return;
+    transform(ptrs.data(), ptrs.size(), false,
+              coset ? coset_powers_bitrev.data() : nullptr, nullptr);
+}
+
+void FFT::ifft_batch(std::vector<std::vector<Fr>>& evals, bool coset) const {
+    std::vector<std::vector<Fr>*> ptrs;
+    ptrs.reserve(evals.size());
+    for (auto& e : evals) {
+        ZK_ASSERT(e.size() == domain_size, "Evaluation vector size mismatch");
+        ptrs.push_back(&e);
+    }
+    if (ptrs.empty()) return;
+    transform(ptrs.data(), ptrs.size(), true,
+              nullptr, coset ? coset_inv_scale.data() : nullptr);
+}
+
+const FFT& FFT::cached(size_t domain_size) {
+    static std::mutex cache_mutex;
+    static std::map<size_t, std::unique_ptr<FFT>> cache;
     
-    Fr inv_n = Fr(domain_size).inverse();
-    for (Fr& val : result) {
-        val = val * inv_n;
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto it = cache.find(domain_size);
+    if (it == cache.end()) {
+        it = cache.emplace(domain_size, std::make_unique<FFT>(domain_size)).first;
     }
-    return result;
+    return *it->second;
 }
 
 Polynomial FFT::multiply(const Polynomial& a, const Polynomial& b) {
@@ -36,22 +88,36 @@ Polynomial FFT::multiply(const Polynomial& a, const Polynomial& b) {
     }
     
     size_t result_size = a.coeffs.size() + b.coeffs.size() - 1;
-    size_t fft_size = 1;
-    while (fft_size < result_size) {
-        fft_size <<= 1;
+    const FFT& fft_mul = cached(BitUtils::next_power_of_two(result_size));
+    
+    std::vector<std::vector<Fr>> evals = {a.coeffs, b.coeffs};
+    fft_mul.fft_batch(evals);
+    
+    std::vector<Fr>& c_evals = evals[0];
+    for (size_t i = 0; i < c_evals.size(); ++i) {
+        c_evals[i] = c_evals[i] * evals[1][i];
     }
     
-    FFT fft_mul(fft_size);
+    std::vector<Fr> result_coeffs = fft_mul.ifft(c_evals);
+    result_coeffs.resize(result_size);
     
-    std::vector<Fr> a_evals = fft_mul.fft(a.coeffs);
-    std::vector<Fr> b_evals = fft_mul.fft(b.coeffs);
+    return Polynomial(result_coeffs);
+}
+
+Polynomial FFT::square(const Polynomial& a) {
+    if (a.coeffs.empty()) {
+        return Polynomial();
+    }
     
-    std::vector<Fr> c_evals(fft_size);
-    for (size_t i = 0; i < fft_size; ++i) {
-        c_evals[i] = a_evals[i] * b_evals[i];
+    size_t result_size = 2 * a.coeffs.size() - 1;
+    const FFT& fft_sq = cached(BitUtils::next_power_of_two(result_size));
+    
+    std::vector<Fr> evals = fft_sq.fft(a.coeffs);
+    for (Fr& e : evals) {
+        e = e.square();
     }
     
-    std::vector<Fr> result_coeffs = fft_mul.ifft(c_evals);
+    std::vector<Fr> result_coeffs = fft_sq.ifft(evals);
     result_coeffs.resize(result_size);
     
     return Polynomial(result_coeffs);
@@ -66,6 +132,37 @@ Polynomial FFT::interpolate_on_domain(const std::vector<Fr>& evals) const {
     return Polynomial(coeffs);
 }
 
+std::vector<Fr> FFT::lagrange_basis_at(const Fr& x) const {
+    return lagrange_basis_at(domain, x);
+}
+
+std::vector<Fr> FFT::lagrange_basis_at(const std::vector<Fr>& domain, const Fr& x) {
+    size_t n = domain.size();
+    std::vector<Fr> result(n, Fr());
+    
+    Fr z = x.pow(static_cast<uint64_t>(n)) - Fr(1);
+    if (z.is_zero()) {
+        for (size_t j = 0; j < n; ++j) {
+            if (domain[j] == x) {
+                result[j] = Fr(1);
+                break;
+            }
+        }
+        return result;
+    }
+    
+    for (size_t j = 0; j < n; ++j) {
+        result[j] = x - domain[j];
+    }
+    Fr::batch_inverse(result);
+    
+    Fr z_over_n = z * Fr(n).inverse();
+    for (size_t j = 0; j < n; ++j) {
+        result[j] = z_over_n * domain[j] * result[j];
+    }
+    return result;
+}
+
 Fr FFT::get_root_of_unity(size_t i) const {
     ZK_ASSERT(i < domain_size, "Index out of bounds");
     return domain[i];
@@ -85,37 +182,112 @@ void FFT::compute_domain() {
 void FFT::compute_twiddles() {
     twiddles.clear();
     twiddles.reserve(domain_size);
+    inv_twiddles.clear();
+    inv_twiddles.reserve(domain_size);
     
-    Fr w = root_of_unity;
     Fr current = Fr(1);
+    Fr inv_current = Fr(1);
     
     for (size_t i = 0; i < domain_size; ++i) {
         twiddles.push_back(current);
-        current = current * w;
+        inv_twiddles.push_back(inv_current);
+        current = current * root_of_unity;
+        inv_current = inv_current * inv_root_of_unity;
     }
+    
+    inv_n = Fr(domain_size).inverse();
 }
 
-void FFT::fft_in_place(std::vector<Fr>& a, bool inverse) const {
-    bit_reverse(a);
+void FFT::compute_coset() {
+    coset_shift = Fr(bn254_fr::GENERATOR);
+    coset_vanishing = coset_shift.pow(static_cast<uint64_t>(domain_size)) - Fr(1);
+    
+    size_t log_n = BitUtils::trailing_zeros(domain_size);
+    Fr inv_shift = coset_shift.inverse();
     
-    Fr w = inverse ? inv_root_of_unity : root_of_unity;
+    coset_powers_bitrev.assign(domain_size, Fr());
+    coset_inv_scale.assign(domain_size, Fr());
     
-    for (size_t len = 2; len <= domain_size; len <<= 1) {
-        Fr wlen = Fr(1);
-        for (size_t i = 0; i < domain_size / len; ++i) {
-            wlen = wlen * w;
+    Fr power = Fr(1);
+    Fr inv_power = inv_n;
+    for (size_t i = 0; i < domain_size; ++i) {
+        size_t rev = log_n == 0 ? 0 : BitUtils::reverse_bits(i) >> (64 - log_n);
+        coset_powers_bitrev[rev] = power;
+        coset_inv_scale[i] = inv_power;
+        power = power * coset_shift;
+        inv_power = inv_power * inv_shift;
+    }
+}
+
+void FFT::fft_in_place(std::vector<Fr>& a, bool inverse,
+                       const Fr* pre_scale, const Fr* post_scale) const {
+    std::vector<Fr>* polys[1] = {&a};
+    transform(polys, 1, inverse, pre_scale, post_scale);
+}
+
+// Runs the same radix-2 transform over `count` vectors at once: each butterfly
+// loads its twiddle once and applies it to every vector, and each stage is split
+// across threads a single time for the whole batch.
+//
+// pre_scale (bit-reversed order) is folded into the first butterfly stage and
+// post_scale (natural order) into the last, so coset transforms cost no extra
+// pass. Inverse transforms without post_scale fold in the 1/n factor instead.
+void FFT::transform(std::vector<Fr>* const* polys, size_t count, bool inverse,
+                    const Fr* pre_scale, const Fr* post_scale) const {
+    Parallel::parallel_for(0, count, [&](size_t lo, size_t hi) {
+        for (size_t p = lo; p < hi; ++p) {
+            bit_reverse(*polys[p]);
+        }
+    });
+    
+    if (domain_size == 1) {
+        for (size_t p = 0; p < count; ++p) {
+            Fr& x = (*polys[p])[0];
+            if (pre_scale) x = x * pre_scale[0];
+            if (post_scale) x = x * post_scale[0];
         }
+        return;
+    }
+    
+    const std::vector<Fr>& tw = inverse ? inv_twiddles : twiddles;
+    size_t half = domain_size / 2;
+    size_t min_chunk = std::max<size_t>(1, MIN_PARALLEL_BUTTERFLIES / count);
+    
+    for (size_t len = 2, log_half = 0; len <= domain_size; len <<= 1, ++log_half) {
+        size_t half_len = len / 2;
+        size_t stride = domain_size / len;
+        bool first = (len == 2) && pre_scale;
+        bool last = (len == domain_size);
+        bool scale_by_inv_n = last && inverse && !post_scale;
         
-        for (size_t i = 0; i < domain_size; i += len) {
-            Fr w_current = Fr(1);
-            for (size_t j = 0; j < len / 2; ++j) {
-                Fr u = a[i + j];
-                Fr v = a[i + j + len / 2] * w_current;
-                a[i + j] = u + v;
-                a[i + j + len / 2] = u - v;
-                w_current = w_current * wlen;
+        Parallel::parallel_for(0, half, [&](size_t lo, size_t hi) {
+            for (size_t k = lo; k < hi; ++k) {
+                size_t j = k & (half_len - 1);
+                size_t i0 = ((k >> log_half) << (log_half + 1)) + j;
+                size_t i1 = i0 + half_len;
+                const Fr& w = tw[j * stride];
+                
+                for (size_t p = 0; p < count; ++p) {
+                    std::vector<Fr>& a = *polys[p];
+                    Fr u = a[i0];
+                    Fr v = a[i1];
+                    if (first) {
+                        u = u * pre_scale[i0];
+                        v = v * pre_scale[i1];
+                    }
+                    v = v * w;
+                    a[i0] = u + v;
+                    a[i1] = u - v;
+                    if (last && post_scale) {
+                        a[i0] = a[i0] * post_scale[i0];
+                        a[i1] = a[i1] * post_scale[i1];
+                    } else if (scale_by_inv_n) {
+                        a[i0] = a[i0] * inv_n;
+                        a[i1] = a[i1] * inv_n;
+                    }
+                }
             }
-        }
+        }, min_chunk);
     }
 }
 
@@ -134,13 +306,14 @@ void FFT::bit_reverse(std::vector<Fr>& a) const {
 }
 
 Fr FFT::find_root_of_unity(size_t n) {
-
-    Fr generator = Fr(5); 
-    
-    Fr field_order_minus_1 = Fr(0x30644e72e131a029b85045b68181585d2833e84879b9709143e1f593f0000000ULL);
+    size_t log_n = BitUtils::trailing_zeros(n);
+    ZK_ASSERT(log_n <= bn254_fr::TWO_ADICITY, "Domain size exceeds field two-adicity");
     
-    Fr exponent = field_order_minus_1 / Fr(n);
-    return generator.pow(exponent);
+    Fr root = Fr(bn254_fr::TWO_ADIC_ROOT_OF_UNITY);
+    for (size_t i = log_n; i < bn254_fr::TWO_ADICITY; ++i) {
+        root = root.square();
+    }
+    return root;
 }
 
 }
\ No newline at end of file
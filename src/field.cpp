@@ -4,6 +4,7 @@
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <stdexcept>
 
 namespace zkmini {
 
@@ -193,6 +194,25 @@ Fr Fr::inverse() const {
     }
 }
 
+void Fr::batch_inverse(std::vector<Fr>& elems) {
+    std::vector<Fr> prefix;
+    prefix.reserve(elems.size());
+    
+    Fr acc = Fr(1);
+    for (const Fr& e : elems) {
+        prefix.push_back(acc);
+        if (!e.is_zero()) acc = acc * e;
+    }
+    
+    Fr inv = acc.inverse();
+    for (size_t i = elems.size(); i-- > 0;) {
+        if (elems[i].is_zero()) continue;
+        Fr next = inv * elems[i];
+        elems[i] = inv * prefix[i];
+        inv = next;
+    }
+}
+
 uint64_t Fr::to_uint64() const {
     ZK_ASSERT(USE_64BIT_DEV, "to_uint64() only valid in development phase");
     return val;
@@ -281,6 +301,31 @@ Fr Fr::from_hex(const std::string& hex) {
     }
 }
 
+Fr Fr::from_decimal(const std::string& dec) {
+    if (dec.empty()) {
+        throw std::invalid_argument("Empty decimal field element");
+    }
+    
+    // Nine digits at a time keep the scale below 2^32, so each step is one mul_small.
+    Fr acc(0);
+    size_t i = 0;
+    while (i < dec.size()) {
+        size_t n = std::min<size_t>(9, dec.size() - i);
+        uint64_t chunk = 0;
+        uint64_t scale = 1;
+        for (size_t k = 0; k < n; ++k, ++i) {
+            char c = dec[i];
+            if (c < '0' || c > '9') {
+                throw std::invalid_argument("Invalid decimal field element: " + dec);
+            }
+            chunk = chunk * 10 + static_cast<uint64_t>(c - '0');
+            scale *= 10;
+        }
+        acc = acc.mul_small(scale) + Fr(chunk);
+    }
+    return acc;
+}
+
 Fr Fr::conditional_select(bool condition, const Fr& a, const Fr& b) {
     if (USE_64BIT_DEV) {
         uint64_t mask = condition ? UINT64_MAX : 0;
@@ -308,7 +353,7 @@ bool Fr::is_valid() const {
     if (USE_64BIT_DEV) {
         return val < MODULUS;
     } else {
-        return true;
+        return is_less_256(data, bn254_fr::MODULUS_BN254);
     }
 }
 
@@ -462,87 +507,175 @@ std::array<uint64_t, 4> Fr::neg_256(const std::array<uint64_t, 4>& a) {
 }
 
 std::array<uint64_t, 4> Fr::mul_256(const std::array<uint64_t, 4>& a, const std::array<uint64_t, 4>& b) {
-    std::array<uint64_t, 8> product = {0};
+    // Values are kept in canonical form, so undo the extra R^-1 with a second
+    // Montgomery product against R^2.
+    return mont_mul_256(mont_mul_256(a, b), bn254_fr::R2_BN254);
+}
+
+std::array<uint64_t, 4> Fr::mont_mul_256(const std::array<uint64_t, 4>& a, const std::array<uint64_t, 4>& b) {
+    const auto& M = bn254_fr::MODULUS_BN254;
+    uint64_t t[6] = {0, 0, 0, 0, 0, 0};
     
     for (int i = 0; i < 4; i++) {
         uint64_t carry = 0;
         for (int j = 0; j < 4; j++) {
-            __uint128_t prod = (__uint128_t)a[i] * b[j] + product[i + j] + carry;
-            product[i + j] = (uint64_t)prod;
+            __uint128_t prod = (__uint128_t)a[j] * b[i] + t[j] + carry;
+            t[j] = (uint64_t)prod;
             carry = prod >> 64;
         }
-        product[i + 4] = carry;
+        __uint128_t sum = (__uint128_t)t[4] + carry;
+        t[4] = (uint64_t)sum;
+        t[5] = sum >> 64;
+        
+        uint64_t m = t[0] * bn254_fr::INV_BN254;
+        __uint128_t red = (__uint128_t)m * M[0] + t[0];
+        carry = red >> 64;
+        for (int j = 1; j < 4; j++) {
+            red = (__uint128_t)m * M[j] + t[j] + carry;
+            t[j - 1] = (uint64_t)red;
+            carry = red >> 64;
+        }
+        sum = (__uint128_t)t[4] + carry;
+        t[3] = (uint64_t)sum;
+        t[4] = t[5] + (uint64_t)(sum >> 64);
     }
     
+    std::array<uint64_t, 4> result = {t[0], t[1], t[2], t[3]};
+    if (t[4] != 0 || !is_less_256(result, M)) {
+        uint64_t borrow = 0;
+        for (int i = 0; i < 4; i++) {
+            __uint128_t diff = (__uint128_t)result[i] - M[i] - borrow;
+            result[i] = (uint64_t)diff;
+            borrow = (diff >> 64) & 1;
+        }
+    }
+    return result;
+}
+
+bool Fr::as_small(uint32_t& magnitude, bool& negative) const {
+    const auto& M = bn254_fr::MODULUS_BN254;
+    if (data[1] == 0 && data[2] == 0 && data[3] == 0 && (data[0] >> 32) == 0) {
+        magnitude = (uint32_t)data[0];
+        negative = false;
+        return true;
+    }
+    // r - k for k < 2^32 only touches the low limb, since M[0] >= 2^32.
+    if (data[1] == M[1] && data[2] == M[2] && data[3] == M[3] && data[0] <= M[0] &&
+        ((M[0] - data[0]) >> 32) == 0) {
+        magnitude = (uint32_t)(M[0] - data[0]);
+        negative = true;
+        return true;
+    }
+    return false;
+}
+
+Fr Fr::mul_small(uint64_t k) const {
+    const auto& M = bn254_fr::MODULUS_BN254;
+    uint64_t p[5];
+    uint64_t carry = 0;
+    for (int i = 0; i < 4; i++) {
+        __uint128_t prod = (__uint128_t)data[i] * k + carry;
+        p[i] = (uint64_t)prod;
+        carry = prod >> 64;
+    }
+    p[4] = carry;
     
-    const int MAX_ITERATIONS = 1000;
-    int iteration_count = 0;
+    // q never exceeds floor(p / r) and falls short of it by at most two, so at
+    // most two conditional subtractions follow.
+    __uint128_t top = ((__uint128_t)p[4] << 64) | p[3];
+    uint64_t q = (uint64_t)(top / ((__uint128_t)M[3] + 1));
     
-    while (iteration_count < MAX_ITERATIONS) {
-        iteration_count++;
-        bool greater_or_equal = false;
-        
-        for (int i = 4; i < 8; i++) {
-            if (product[i] != 0) {
-                greater_or_equal = true;
-                break;
-            }
-        }
-        
-        if (!greater_or_equal) {
-            for (int i = 3; i >= 0; i--) {
-                if (product[i] > bn254_fr::MODULUS_BN254[i]) {
-                    greater_or_equal = true;
-                    break;
-                } else if (product[i] < bn254_fr::MODULUS_BN254[i]) {
-                    break;
-                }
-            }
-            if (!greater_or_equal) {
-                bool exactly_equal = true;
-                for (int i = 0; i < 4; i++) {
-                    if (product[i] != bn254_fr::MODULUS_BN254[i]) {
-                        exactly_equal = false;
-                        break;
-                    }
-                }
-                if (exactly_equal) {
-                    greater_or_equal = true;
-                }
-            }
-        }
-        
-        if (!greater_or_equal) {
-            break;
-        }
-        
-        uint64_t borrow = 0;
+    uint64_t qr[5];
+    carry = 0;
+    for (int i = 0; i < 4; i++) {
+        __uint128_t prod = (__uint128_t)M[i] * q + carry;
+        qr[i] = (uint64_t)prod;
+        carry = prod >> 64;
+    }
+    qr[4] = carry;
+    
+    uint64_t borrow = 0;
+    for (int i = 0; i < 5; i++) {
+        __uint128_t diff = (__uint128_t)p[i] - qr[i] - borrow;
+        p[i] = (uint64_t)diff;
+        borrow = (diff >> 64) & 1;
+    }
+    
+    std::array<uint64_t, 4> v = {p[0], p[1], p[2], p[3]};
+    uint64_t high = p[4];
+    while (high != 0 || !is_less_256(v, M)) {
+        borrow = 0;
         for (int i = 0; i < 4; i++) {
-            __uint128_t diff = (__uint128_t)product[i] - bn254_fr::MODULUS_BN254[i] - borrow;
-            product[i] = (uint64_t)diff;
+            __uint128_t diff = (__uint128_t)v[i] - M[i] - borrow;
+            v[i] = (uint64_t)diff;
             borrow = (diff >> 64) & 1;
         }
-        
-        for (int i = 4; i < 8 && borrow; i++) {
-            if (product[i] >= borrow) {
-                product[i] -= borrow;
-                borrow = 0;
-            } else {
-                product[i] = UINT64_MAX;
-            }
+        high -= borrow;
+    }
+    return Fr(v);
+}
+
+void Fr::MulAccumulator::add_product(const Fr& a, const Fr& b) {
+    for (int i = 0; i < 4; i++) {
+        uint64_t carry = 0;
+        for (int j = 0; j < 4; j++) {
+            __uint128_t prod = (__uint128_t)a.data[j] * b.data[i] + acc[i + j] + carry;
+            acc[i + j] = (uint64_t)prod;
+            carry = prod >> 64;
+        }
+        for (int k = i + 4; carry && k < 9; k++) {
+            __uint128_t sum = (__uint128_t)acc[k] + carry;
+            acc[k] = (uint64_t)sum;
+            carry = sum >> 64;
         }
     }
+}
+
+void Fr::MulAccumulator::add(const Fr& a) {
+    uint64_t carry = 0;
+    for (int k = 0; k < 9 && (k < 4 || carry); k++) {
+        __uint128_t sum = (__uint128_t)acc[k] + (k < 4 ? a.data[k] : 0) + carry;
+        acc[k] = (uint64_t)sum;
+        carry = sum >> 64;
+    }
+}
+
+Fr Fr::MulAccumulator::result() const {
+    const auto& M = bn254_fr::MODULUS_BN254;
+    uint64_t t[10];
+    for (int k = 0; k < 9; k++) t[k] = acc[k];
+    t[9] = 0;
     
-    
-    if (iteration_count >= MAX_ITERATIONS) {
-        std::cerr << "Warning: mul_256 hit maximum iterations, possible infinite loop prevented\n";
-        
-        
+    // Five Montgomery rounds clear the low 320 bits: t[5..9] = (T + m*r) / 2^320,
+    // which is below 2^256 + r since T < 2^576.
+    for (int i = 0; i < 5; i++) {
+        uint64_t m = t[i] * bn254_fr::INV_BN254;
+        uint64_t carry = 0;
+        for (int j = 0; j < 4; j++) {
+            __uint128_t red = (__uint128_t)m * M[j] + t[i + j] + carry;
+            t[i + j] = (uint64_t)red;
+            carry = red >> 64;
+        }
+        for (int k = i + 4; carry && k < 10; k++) {
+            __uint128_t sum = (__uint128_t)t[k] + carry;
+            t[k] = (uint64_t)sum;
+            carry = sum >> 64;
+        }
     }
     
+    std::array<uint64_t, 4> v = {t[5], t[6], t[7], t[8]};
+    uint64_t high = t[9];
+    while (high != 0 || !is_less_256(v, M)) {
+        uint64_t borrow = 0;
+        for (int i = 0; i < 4; i++) {
+            __uint128_t diff = (__uint128_t)v[i] - M[i] - borrow;
+            v[i] = (uint64_t)diff;
+            borrow = (diff >> 64) & 1;
+        }
+        high -= borrow;
+    }
     
-    std::array<uint64_t, 4> result = {product[0], product[1], product[2], product[3]};
-    return result;
+    return Fr(mont_mul_256(v, bn254_fr::ACC_FIXUP_BN254));
 }
 
 std::array<uint64_t, 4> Fr::pow_256(const std::array<uint64_t, 4>& base, const std::array<uint64_t, 4>& exp) {
@@ -584,60 +717,10 @@ std::array<uint64_t, 4> Fr::inv_256(const std::array<uint64_t, 4>& a) {
         return {0, 0, 0, 0};
     }
     
-    std::array<uint64_t, 4> old_r = a;
-    std::array<uint64_t, 4> r = bn254_fr::MODULUS_BN254;
-    std::array<int64_t, 4> old_s = {1, 0, 0, 0};
-    std::array<int64_t, 4> s = {0, 0, 0, 0};
-    if (a[1] == 0 && a[2] == 0 && a[3] == 0) {
-        uint64_t val = a[0];
-        if (val == 0) return {0, 0, 0, 0};
-        if (val == 1) return {1, 0, 0, 0};
-        
-        if (val == 2) {
-            return {
-                0xa1f0fac9f8000001ULL,
-                0x9419f4243cdcb848ULL,
-                0xdc2822db40c0ac2eULL,
-                0x183227397098d014ULL
-            };
-        }
-    }
-    
-    std::array<uint64_t, 4> u = a;
-    std::array<uint64_t, 4> v = bn254_fr::MODULUS_BN254;
-    std::array<uint64_t, 4> x1 = {1, 0, 0, 0};
-    std::array<uint64_t, 4> x2 = {0, 0, 0, 0};
-    
-    for (int iter = 0; iter < 1000 && !is_zero_256(v); iter++) {
-        if (is_even_256(u)) {
-            u = div2_256(u);
-            if (is_even_256(x1)) {
-                x1 = div2_256(x1);
-            } else {
-                x1 = div2_256(add_256(x1, bn254_fr::MODULUS_BN254));
-            }
-        } else if (is_even_256(v)) {
-            v = div2_256(v);
-            if (is_even_256(x2)) {
-                x2 = div2_256(x2);
-            } else {
-                x2 = div2_256(add_256(x2, bn254_fr::MODULUS_BN254));
-            }
-        } else if (is_less_256(v, u)) {
-            u = sub_256(u, v);
-            x1 = sub_256_signed(x1, x2);
-        } else {
-            v = sub_256(v, u);
-            x2 = sub_256_signed(x2, x1);
-        }
-    }
-    
-    if (is_one_256(u)) {
-        reduce_256(x1);
-        return x1;
-    }
-    
-    return {1, 0, 0, 0};
+    // Fermat: a^(r-2) = a^-1 mod r
+    std::array<uint64_t, 4> exp = bn254_fr::MODULUS_BN254;
+    exp[0] -= 2;
+    return pow_256(a, exp);
 }
 
 void Fr::reduce_256(std::array<uint64_t, 4>& a) {
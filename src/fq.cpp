@@ -3,20 +3,106 @@
 
 namespace zkmini {
 
-static void add_with_carry(uint64_t a, uint64_t b, uint64_t& result, uint64_t& carry) {
-    result = a + b;
-    carry = (result < a) ? 1 : 0;
+namespace {
+
+// -p^-1 mod 2^64 and R^2 mod p for R = 2^256: a * b = mont_mul(mont_mul(a, b), R^2).
+constexpr uint64_t INV = 0x87d20782e4866389ULL;
+constexpr uint64_t R2[4] = {
+    0xf32cfc5b538afa89ULL, 0xb5e71911d44501fbULL,
+    0x47ab1eff0a417ff6ULL, 0x06d89f71cab8351fULL
+};
+
+// out = a + b over four limbs; returns the carry out of the top limb.
+uint64_t add_limbs(const uint64_t a[4], const uint64_t b[4], uint64_t out[4]) {
+    uint64_t carry = 0;
+    for (int i = 0; i < 4; i++) {
+        __uint128_t sum = (__uint128_t)a[i] + b[i] + carry;
+        out[i] = (uint64_t)sum;
+        carry = (uint64_t)(sum >> 64);
+    }
+    return carry;
 }
 
-static void sub_with_borrow(uint64_t a, uint64_t b, uint64_t& result, uint64_t& borrow) {
-    result = a - b;
-    borrow = (a < b) ? 1 : 0;
+// out = a - b over four limbs; returns the borrow out of the top limb.
+uint64_t sub_limbs(const uint64_t a[4], const uint64_t b[4], uint64_t out[4]) {
+    uint64_t borrow = 0;
+    for (int i = 0; i < 4; i++) {
+        __uint128_t diff = (__uint128_t)a[i] - b[i] - borrow;
+        out[i] = (uint64_t)diff;
+        borrow = (uint64_t)(diff >> 64) & 1;
+    }
+    return borrow;
+}
+
+bool below_modulus(const uint64_t a[4]) {
+    for (int i = 3; i >= 0; i--) {
+        if (a[i] != Fq::MODULUS[i]) return a[i] < Fq::MODULUS[i];
+    }
+    return false;
+}
+
+// a * b * R^-1 mod p (CIOS) for a, b < p.
+void mont_mul(const uint64_t a[4], const uint64_t b[4], uint64_t out[4]) {
+    uint64_t t[6] = {0, 0, 0, 0, 0, 0};
+    
+    for (int i = 0; i < 4; i++) {
+        uint64_t carry = 0;
+        for (int j = 0; j < 4; j++) {
+            __uint128_t prod = (__uint128_t)a[j] * b[i] + t[j] + carry;
+            t[j] = (uint64_t)prod;
+            carry = (uint64_t)(prod >> 64);
+        }
+        __uint128_t sum = (__uint128_t)t[4] + carry;
+        t[4] = (uint64_t)sum;
+        t[5] = (uint64_t)(sum >> 64);
+        
+        uint64_t m = t[0] * INV;
+        __uint128_t red = (__uint128_t)m * Fq::MODULUS[0] + t[0];
+        carry = (uint64_t)(red >> 64);
+        for (int j = 1; j < 4; j++) {
+            red = (__uint128_t)m * Fq::MODULUS[j] + t[j] + carry;
+            t[j - 1] = (uint64_t)red;
+            carry = (uint64_t)(red >> 64);
+        }
+        sum = (__uint128_t)t[4] + carry;
+        t[3] = (uint64_t)sum;
+        t[4] = t[5] + (uint64_t)(sum >> 64);
+    }
+    
+    for (int i = 0; i < 4; i++) out[i] = t[i];
+    if (t[4] != 0 || !below_modulus(out)) {
+        sub_limbs(out, Fq::MODULUS, out);
+    }
+}
+
+// (p + 1) / 4, the square-root exponent for p = 3 mod 4, and (p - 1) / 2.
+constexpr uint64_t SQRT_EXP[4] = {
+    0x4f082305b61f3f52ULL, 0x65e05aa45a1c72a3ULL,
+    0x6e14116da0605617ULL, 0x0c19139cb84c680aULL
+};
+constexpr uint64_t HALF_MODULUS[4] = {
+    0x9e10460b6c3e7ea3ULL, 0xcbc0b548b438e546ULL,
+    0xdc2822db40c0ac2eULL, 0x183227397098d014ULL
+};
+
+// out = a^exp mod p, square-and-multiply kept in Montgomery form.
+void mont_pow(const uint64_t a[4], const uint64_t exp[4], uint64_t out[4]) {
+    const uint64_t one[4] = {1, 0, 0, 0};
+    uint64_t base[4];
+    uint64_t acc[4];
+    mont_mul(a, R2, base);
+    mont_mul(one, R2, acc);
+    
+    for (int i = 255; i >= 0; i--) {
+        mont_mul(acc, acc, acc);
+        if ((exp[i / 64] >> (i % 64)) & 1) {
+            mont_mul(acc, base, acc);
+        }
+    }
+    
+    mont_mul(acc, one, out);
 }
 
-static void mul_with_carry(uint64_t a, uint64_t b, uint64_t& low, uint64_t& high) {
-    __uint128_t prod = (__uint128_t)a * b;
-    low = (uint64_t)prod;
-    high = (uint64_t)(prod >> 64);
 }
 
 Fq::Fq() : data{0, 0, 0, 0} {}
@@ -27,94 +113,33 @@ Fq::Fq(uint64_t val) : data{val, 0, 0, 0} {
     }
 }
 
+Fq::Fq(const std::array<uint64_t, 4>& limbs) : data{limbs[0], limbs[1], limbs[2], limbs[3]} {
+    reduce();
+}
+
 Fq Fq::operator+(const Fq& other) const {
     Fq result;
-    uint64_t carry = 0;
-    
-    add_with_carry(data[0], other.data[0], result.data[0], carry);
-    add_with_carry(data[1] + carry, other.data[1], result.data[1], carry);
-    add_with_carry(data[2] + carry, other.data[2], result.data[2], carry);
-    add_with_carry(data[3] + carry, other.data[3], result.data[3], carry);
-    
-    result.reduce();
+    uint64_t carry = add_limbs(data, other.data, result.data);
+    if (carry || !below_modulus(result.data)) {
+        sub_limbs(result.data, MODULUS, result.data);
+    }
     return result;
 }
 
 Fq Fq::operator-(const Fq& other) const {
     Fq result;
-    uint64_t borrow = 0;
-    
-    sub_with_borrow(data[0], other.data[0], result.data[0], borrow);
-    sub_with_borrow(data[1] - borrow, other.data[1], result.data[1], borrow);
-    sub_with_borrow(data[2] - borrow, other.data[2], result.data[2], borrow);
-    sub_with_borrow(data[3] - borrow, other.data[3], result.data[3], borrow);
-    
-    if (borrow) {
-        uint64_t carry = 0;
-        add_with_carry(result.data[0], MODULUS[0], result.data[0], carry);
-        add_with_carry(result.data[1] + carry, MODULUS[1], result.data[1], carry);
-        add_with_carry(result.data[2] + carry, MODULUS[2], result.data[2], carry);
-        add_with_carry(result.data[3] + carry, MODULUS[3], result.data[3], carry);
+    if (sub_limbs(data, other.data, result.data)) {
+        add_limbs(result.data, MODULUS, result.data);
     }
-    
     return result;
 }
 
+// Canonical limbs in and out; the two Montgomery products cancel the R factors.
 Fq Fq::operator*(const Fq& other) const {
-    uint64_t result[8] = {0};
-    
-    for (int i = 0; i < 4; i++) {
-        for (int j = 0; j < 4; j++) {
-            if (i + j < 8) {
-                __uint128_t prod = (__uint128_t)data[i] * other.data[j];
-                uint64_t low = (uint64_t)prod;
-                uint64_t high = (uint64_t)(prod >> 64);
-                
-                
-                uint64_t carry = 0;
-                uint64_t temp = result[i + j] + low;
-                if (temp < result[i + j]) carry = 1;
-                result[i + j] = temp;
-                
-                
-                if (i + j + 1 < 8) {
-                    temp = result[i + j + 1] + high + carry;
-                    result[i + j + 1] = temp;
-                }
-            }
-        }
-    }
-    
-    Fq res;
-    res.data[0] = result[0];
-    res.data[1] = result[1]; 
-    res.data[2] = result[2];
-    res.data[3] = result[3];
-    
-    for (int i = 4; i < 8; i++) {
-        if (result[i] > 0) {
-            for (int shift = 0; shift < i - 4; shift++) {
-                uint64_t carry = 0;
-                for (int k = 0; k < 4; k++) {
-                    uint64_t temp = (res.data[k] << 1) | carry;
-                    carry = res.data[k] >> 63;
-                    res.data[k] = temp;
-                }
-                res.reduce();
-            }
-            
-            uint64_t carry = result[i];
-            for (int k = 0; k < 4 && carry > 0; k++) {
-                uint64_t temp = res.data[k] + carry;
-                carry = (temp < res.data[k]) ? 1 : 0;
-                res.data[k] = temp;
-            }
-            res.reduce();
-        }
-    }
-    
-    res.reduce();
-    return res;
+    Fq result;
+    mont_mul(data, other.data, result.data);
+    mont_mul(result.data, R2, result.data);
+    return result;
 }
 
 Fq Fq::operator/(const Fq& other) const {
@@ -134,60 +159,55 @@ bool Fq::is_one() const {
     return data[0] == 1 && data[1] == 0 && data[2] == 0 && data[3] == 0;
 }
 
+// Fermat: a^(p-2).
 Fq Fq::inverse() const {
     if (is_zero()) return Fq();
     
-    Fq u = *this;
-    Fq v;
-    v.data[0] = MODULUS[0];
-    v.data[1] = MODULUS[1];
-    v.data[2] = MODULUS[2];
-    v.data[3] = MODULUS[3];
+    uint64_t exp[4];
+    const uint64_t two[4] = {2, 0, 0, 0};
+    sub_limbs(MODULUS, two, exp);
     
-    Fq s;
-    s.data[0] = 1;
-    Fq r;
+    Fq result;
+    mont_pow(data, exp, result.data);
+    return result;
+}
+
+void Fq::batch_inverse(std::vector<Fq>& elems) {
+    std::vector<Fq> prefix;
+    prefix.reserve(elems.size());
     
-    while (!u.is_zero()) {
-        if (u.data[0] & 1) {
-            if (compare(u, v) >= 0) {
-                u = u - v;
-                s = s - r;
-            } else {
-                v = v - u;
-                r = r - s;
-            }
-        } else if (v.data[0] & 1) {
-            v = v - u;
-            r = r - s;
-        }
-        
-        if (!(u.data[0] & 1)) {
-            u.div2();
-            if (s.data[0] & 1) {
-                uint64_t carry = 0;
-                add_with_carry(s.data[0], MODULUS[0], s.data[0], carry);
-                add_with_carry(s.data[1] + carry, MODULUS[1], s.data[1], carry);
-                add_with_carry(s.data[2] + carry, MODULUS[2], s.data[2], carry);
-                add_with_carry(s.data[3] + carry, MODULUS[3], s.data[3], carry);
-            }
-            s.div2();
-        }
-        
-        if (!(v.data[0] & 1)) {
-            v.div2();
-            if (r.data[0] & 1) {
-                uint64_t carry = 0;
-                add_with_carry(r.data[0], MODULUS[0], r.data[0], carry);
-                add_with_carry(r.data[1] + carry, MODULUS[1], r.data[1], carry);
-                add_with_carry(r.data[2] + carry, MODULUS[2], r.data[2], carry);
-                add_with_carry(r.data[3] + carry, MODULUS[3], r.data[3], carry);
-            }
-            r.div2();
-        }
+    Fq acc = Fq(1);
+    for (const Fq& e : elems) {
+        prefix.push_back(acc);
+        if (!e.is_zero()) acc = acc * e;
     }
     
-    return r;
+    Fq inv = acc.inverse();
+    for (size_t i = elems.size(); i-- > 0;) {
+        if (elems[i].is_zero()) continue;
+        Fq next = inv * elems[i];
+        elems[i] = inv * prefix[i];
+        inv = next;
+    }
+}
+
+bool Fq::sqrt(Fq& root) const {
+    Fq candidate;
+    mont_pow(data, SQRT_EXP, candidate.data);
+    if (!(candidate.square() == *this)) return false;
+    root = candidate;
+    return true;
+}
+
+bool Fq::is_reduced() const {
+    return below_modulus(data);
+}
+
+bool Fq::is_lexicographically_largest() const {
+    for (int i = 3; i >= 0; i--) {
+        if (data[i] != HALF_MODULUS[i]) return data[i] > HALF_MODULUS[i];
+    }
+    return false;
 }
 
 Fq Fq::square() const {
@@ -196,11 +216,7 @@ Fq Fq::square() const {
 
 void Fq::reduce() {
     while (compare_to_modulus() >= 0) {
-        uint64_t borrow = 0;
-        sub_with_borrow(data[0], MODULUS[0], data[0], borrow);
-        sub_with_borrow(data[1] - borrow, MODULUS[1], data[1], borrow);
-        sub_with_borrow(data[2] - borrow, MODULUS[2], data[2], borrow);
-        sub_with_borrow(data[3] - borrow, MODULUS[3], data[3], borrow);
+        sub_limbs(data, MODULUS, data);
     }
 }
 
@@ -2,7 +2,9 @@
 
 namespace zkmini {
 
-const Fq Fq2::NON_RESIDUE = Fq(0x3c208c16d87cfd46ULL);
+// -1, i.e. p - 1: Fq2 = Fq[u] / (u^2 + 1).
+const Fq Fq2::NON_RESIDUE = Fq({0x3c208c16d87cfd46ULL, 0x97816a916871ca8dULL,
+                                0xb85045b68181585dULL, 0x30644e72e131a029ULL});
 
 Fq2::Fq2() : c0(), c1() {}
 
@@ -52,6 +54,74 @@ Fq2 Fq2::square() const {
     return Fq2(c0_plus_c1 * c0_minus_beta_c1 - a - a * NON_RESIDUE, a + a);
 }
 
+// Complex method: (x0 + x1 u)^2 = a gives x0^2 = (c0 +- sqrt(N(a))) / 2 and
+// x1 = c1 / (2 x0), with N(a) = c0^2 - NON_RESIDUE * c1^2 (u^2 = NON_RESIDUE = -1).
+namespace {
+
+// The complex method up to its division: x0 with x0^2 = (c0 +- sqrt(N(a))) / 2.
+bool sqrt_real_part(const Fq2& a, Fq& x0) {
+    static const Fq HALF = Fq(2).inverse();
+    
+    Fq norm_root;
+    if (!(a.c0.square() - a.c1.square() * Fq2::NON_RESIDUE).sqrt(norm_root)) return false;
+    return ((a.c0 + norm_root) * HALF).sqrt(x0) || ((a.c0 - norm_root) * HALF).sqrt(x0);
+}
+
+}
+
+bool Fq2::sqrt(Fq2& root) const {
+    Fq r;
+    if (c1.is_zero()) {
+        if (c0.sqrt(r)) {
+            root = Fq2(r, Fq());
+            return true;
+        }
+        // -1 is not a square mod p, so -c0 is and (r u)^2 = -r^2 = c0.
+        if ((Fq() - c0).sqrt(r)) {
+            root = Fq2(Fq(), r);
+            return true;
+        }
+        return false;
+    }
+    
+    Fq x0;
+    if (!sqrt_real_part(*this, x0)) return false;
+    
+    Fq2 candidate(x0, c1 * (x0 + x0).inverse());
+    if (!(candidate.square() == *this)) return false;
+    root = candidate;
+    return true;
+}
+
+// c1 = 0 needs no division; the rest queue 2 x0 for one batch_inverse. x0 is never
+// zero there, since c1 != 0 makes sqrt(N(a)) != +-c0.
+bool Fq2::batch_sqrt(std::vector<Fq2>& elems) {
+    std::vector<Fq> x0(elems.size());
+    std::vector<Fq> denom(elems.size());
+    for (size_t i = 0; i < elems.size(); ++i) {
+        if (elems[i].c1.is_zero()) continue;
+        if (!sqrt_real_part(elems[i], x0[i])) return false;
+        denom[i] = x0[i] + x0[i];
+    }
+    Fq::batch_inverse(denom);
+    
+    for (size_t i = 0; i < elems.size(); ++i) {
+        Fq2 root;
+        if (elems[i].c1.is_zero()) {
+            if (!elems[i].sqrt(root)) return false;
+        } else {
+            root = Fq2(x0[i], elems[i].c1 * denom[i]);
+            if (!(root.square() == elems[i])) return false;
+        }
+        elems[i] = root;
+    }
+    return true;
+}
+
+bool Fq2::is_lexicographically_largest() const {
+    return c1.is_lexicographically_largest() || (c1.is_zero() && c0.is_lexicographically_largest());
+}
+
 Fq2 Fq2::conjugate() const {
     return Fq2(c0, Fq() - c1);
 }
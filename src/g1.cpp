@@ -166,4 +166,104 @@ G1 G1::random() {
     return generator() * random_scalar;
 }
 
-}
\ No newline at end of file
+G1 G1::operator+(const G1Affine& other) const {
+    if (other.is_zero()) return *this;
+    if (this->is_zero()) return other.to_jacobian();
+    
+    // madd-2007-bl: U1 = X1 and S1 = Y1 because Z2 = 1.
+    Fq Z1Z1 = z * z;
+    Fq U2 = other.x * Z1Z1;
+    Fq S2 = other.y * z * Z1Z1;
+    
+    if (x == U2) {
+        return y == S2 ? this->double_point() : G1();
+    }
+    
+    Fq H = U2 - x;
+    Fq HH = H * H;
+    Fq I = HH + HH + HH + HH;
+    Fq J = H * I;
+    Fq r = S2 - y;
+    r = r + r;
+    Fq V = x * I;
+    
+    Fq X3 = r * r - J - V - V;
+    Fq YJ = y * J;
+    Fq Y3 = r * (V - X3) - YJ - YJ;
+    Fq ZH = z + H;
+    Fq Z3 = ZH * ZH - Z1Z1 - HH;
+    
+    return G1(X3, Y3, Z3);
+}
+
+std::vector<G1Affine> G1::batch_normalize(const std::vector<G1>& points) {
+    std::vector<G1Affine> out(points.size());
+    
+    // prefix[i] = product of the non-zero z before point i.
+    std::vector<Fq> prefix(points.size());
+    Fq acc(1);
+    for (size_t i = 0; i < points.size(); ++i) {
+        prefix[i] = acc;
+        if (!points[i].is_zero()) acc = acc * points[i].z;
+    }
+    
+    Fq inv = acc.inverse();
+    for (size_t i = points.size(); i-- > 0;) {
+        const G1& p = points[i];
+        if (p.is_zero()) continue;
+        Fq z_inv = inv * prefix[i];
+        inv = inv * p.z;
+        Fq z_inv2 = z_inv * z_inv;
+        out[i] = G1Affine(p.x * z_inv2, p.y * z_inv2 * z_inv);
+    }
+    return out;
+}
+
+static_assert(sizeof(G1Affine) == 64, "G1Affine must match the file layout");
+
+G1Affine::G1Affine() : x(), y() {}
+
+G1Affine::G1Affine(const Fq& x, const Fq& y) : x(x), y(y) {}
+
+G1Affine::G1Affine(const G1& p) {
+    auto xy = p.to_affine();
+    x = xy.first;
+    y = xy.second;
+}
+
+bool G1Affine::from_x(const Fq& x, bool y_largest, G1Affine& out) {
+    Fq y;
+    if (!(x * x * x + Fq(3)).sqrt(y)) return false;
+    if (y.is_lexicographically_largest() != y_largest) y = Fq() - y;
+    out = G1Affine(x, y);
+    return true;
+}
+
+G1 G1Affine::to_jacobian() const {
+    if (is_zero()) return G1();
+    return G1(x, y);
+}
+
+G1Affine G1Affine::negate() const {
+    if (is_zero()) return *this;
+    return G1Affine(x, Fq() - y);
+}
+
+bool G1Affine::operator==(const G1Affine& other) const {
+    return x == other.x && y == other.y;
+}
+
+bool G1Affine::is_zero() const {
+    return x.is_zero() && y.is_zero();
+}
+
+bool G1Affine::is_on_curve() const {
+    if (is_zero()) return true;
+    return y * y == x * x * x + Fq(3);
+}
+
+bool G1Affine::is_reduced() const {
+    return x.is_reduced() && y.is_reduced();
+}
+
+}
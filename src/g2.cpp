@@ -119,6 +119,11 @@ bool G2::is_on_curve() const {
     return Y2 == (X3 + bZ6);
 }
 
+// (r - 1) * P = -P, since scalars are taken mod r.
+bool G2::is_in_subgroup() const {
+    return *this * (Fr(0) - Fr(1)) == negate();
+}
+
 G2 G2::double_point() const {
     if (is_zero()) return G2(); 
     
@@ -204,4 +209,117 @@ G2 G2::frobenius_map(uint64_t power) const {
     return G2(x_frob, y_frob, z_frob);
 }
 
-}
\ No newline at end of file
+G2 G2::operator+(const G2Affine& other) const {
+    if (other.is_zero()) return *this;
+    if (this->is_zero()) return other.to_jacobian();
+    
+    // madd-2007-bl, as in G1.
+    Fq2 Z1Z1 = z * z;
+    Fq2 U2 = other.x * Z1Z1;
+    Fq2 S2 = other.y * z * Z1Z1;
+    
+    if (x == U2) {
+        return y == S2 ? this->double_point() : G2();
+    }
+    
+    Fq2 H = U2 - x;
+    Fq2 HH = H * H;
+    Fq2 I = HH + HH + HH + HH;
+    Fq2 J = H * I;
+    Fq2 r = S2 - y;
+    r = r + r;
+    Fq2 V = x * I;
+    
+    Fq2 X3 = r * r - J - V - V;
+    Fq2 YJ = y * J;
+    Fq2 Y3 = r * (V - X3) - YJ - YJ;
+    Fq2 ZH = z + H;
+    Fq2 Z3 = ZH * ZH - Z1Z1 - HH;
+    
+    return G2(X3, Y3, Z3);
+}
+
+std::vector<G2Affine> G2::batch_normalize(const std::vector<G2>& points) {
+    std::vector<G2Affine> out(points.size());
+    
+    std::vector<Fq2> prefix(points.size());
+    Fq2 acc(Fq(1), Fq());
+    for (size_t i = 0; i < points.size(); ++i) {
+        prefix[i] = acc;
+        if (!points[i].is_zero()) acc = acc * points[i].z;
+    }
+    
+    Fq2 inv = acc.inverse();
+    for (size_t i = points.size(); i-- > 0;) {
+        const G2& p = points[i];
+        if (p.is_zero()) continue;
+        Fq2 z_inv = inv * prefix[i];
+        inv = inv * p.z;
+        Fq2 z_inv2 = z_inv * z_inv;
+        out[i] = G2Affine(p.x * z_inv2, p.y * z_inv2 * z_inv);
+    }
+    return out;
+}
+
+static_assert(sizeof(G2Affine) == 128, "G2Affine must match the file layout");
+
+G2Affine::G2Affine() : x(), y() {}
+
+G2Affine::G2Affine(const Fq2& x, const Fq2& y) : x(x), y(y) {}
+
+G2Affine::G2Affine(const G2& p) {
+    auto xy = p.to_affine();
+    x = xy.first;
+    y = xy.second;
+}
+
+bool G2Affine::from_x(const Fq2& x, bool y_largest, G2Affine& out) {
+    // Same b as G2::is_on_curve().
+    Fq2 y;
+    if (!(x * x * x + Fq2(Fq(3), Fq(0))).sqrt(y)) return false;
+    if (y.is_lexicographically_largest() != y_largest) y = Fq2() - y;
+    out = G2Affine(x, y);
+    return true;
+}
+
+bool G2Affine::from_x_batch(const std::vector<Fq2>& xs, const std::vector<bool>& y_largest,
+                            std::vector<G2Affine>& out) {
+    std::vector<Fq2> ys(xs.size());
+    for (size_t i = 0; i < xs.size(); ++i) ys[i] = xs[i] * xs[i] * xs[i] + Fq2(Fq(3), Fq(0));
+    if (!Fq2::batch_sqrt(ys)) return false;
+    
+    out.resize(xs.size());
+    for (size_t i = 0; i < xs.size(); ++i) {
+        if (ys[i].is_lexicographically_largest() != y_largest[i]) ys[i] = Fq2() - ys[i];
+        out[i] = G2Affine(xs[i], ys[i]);
+    }
+    return true;
+}
+
+G2 G2Affine::to_jacobian() const {
+    if (is_zero()) return G2();
+    return G2(x, y);
+}
+
+G2Affine G2Affine::negate() const {
+    if (is_zero()) return *this;
+    return G2Affine(x, Fq2() - y);
+}
+
+bool G2Affine::operator==(const G2Affine& other) const {
+    return x == other.x && y == other.y;
+}
+
+bool G2Affine::is_zero() const {
+    return x.is_zero() && y.is_zero();
+}
+
+bool G2Affine::is_on_curve() const {
+    return to_jacobian().is_on_curve();
+}
+
+bool G2Affine::is_reduced() const {
+    return x.c0.is_reduced() && x.c1.is_reduced() && y.c0.is_reduced() && y.c1.is_reduced();
+}
+
+}
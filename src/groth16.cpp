@@ -2,48 +2,45 @@
 #include "zkmini/random.hpp"
 #include "zkmini/utils.hpp"
 #include "zkmini/serialization.hpp"
+#include "zkmini/eval_poly.hpp"
 #include <fstream>
+#include <stdexcept>
 
 namespace zkmini {
 Proof::Proof() : A(), B(), C() {}
 Proof::Proof(const G1& A, const G2& B, const G1& C) : A(A), B(B), C(C) {}
+// A, B, C compressed: 128 bytes.
+void Proof::write(ByteWriter& out) const {
+    out.put_g1(A);
+    out.put_g2(B);
+    out.put_g1(C);
+}
+
+Proof Proof::read(ByteReader& in) {
+    G1 A = in.get_g1();
+    G2 B = in.get_g2();
+    G1 C = in.get_g1();
+    return Proof(A, B, C);
+}
+
 std::vector<uint8_t> Proof::serialize() const {
-    std::vector<uint8_t> result;
-    
-    
-    auto A_data = Serialization::serialize_g1(A);
-    result.insert(result.end(), A_data.begin(), A_data.end());
-    
-    
-    auto B_data = Serialization::serialize_g2(B);
-    result.insert(result.end(), B_data.begin(), B_data.end());
-    
-    
-    auto C_data = Serialization::serialize_g1(C);
-    result.insert(result.end(), C_data.begin(), C_data.end());
-    
-    return result;
+    ByteWriter out(Serialization::PROOF_SIZE);
+    write(out);
+    return out.take();
 }
 
 Proof Proof::deserialize(const std::vector<uint8_t>& data) {
-    size_t offset = 0;
-    
-    
-    G1 A = Serialization::deserialize_g1(data, offset);
-    
-    
-    G2 B = Serialization::deserialize_g2(data, offset);
-    
-    
-    G1 C = Serialization::deserialize_g1(data, offset);
-    
-    return Proof(A, B, C);
+    if (data.size() != Serialization::PROOF_SIZE) {
+        throw std::runtime_error("Proof must be " + std::to_string(Serialization::PROOF_SIZE) + " bytes");
+    }
+    ByteReader in(data);
+    return read(in);
 }
 
 void Proof::save_to_file(const std::string& filename) const {
-    auto data = serialize();
-    std::ofstream file(filename, std::ios::binary);
-    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    ByteWriter out(filename);
+    write(out);
+    out.finish();
 }
 
 Proof Proof::load_from_file(const std::string& filename) {
@@ -72,7 +69,25 @@ CRS Groth16::setup(const R1CS& r1cs) {
     ZK_TIMER("Groth16 Setup");
     
     
-    QAP qap = r1cs_to_qap(r1cs);
+    // Only the domain is needed here: basis values at tau come straight from the sparse rows.
+    std::vector<Fr> domain_points = qap_domain_points(r1cs.num_constraints());
+    
+    
+    Fr tau = random_fr();
+    Fr alpha = random_fr();  
+    Fr beta = random_fr();
+    Fr gamma = random_fr();
+    Fr delta = random_fr();
+    
+    CRS crs;
+    setup_crs_elements(crs, qap_basis_at(r1cs, domain_points, tau), domain_points.size(),
+                       r1cs.public_inputs(), tau, alpha, beta, gamma, delta);
+    
+    return crs;
+}
+CRS Groth16::setup(const SparseQAP& qap) {
+    ZK_TIMER("Groth16 Setup");
+    ZK_ASSERT(qap.is_valid(), "Malformed sparse QAP");
     
     
     Fr tau = random_fr();
@@ -81,8 +96,10 @@ CRS Groth16::setup(const R1CS& r1cs) {
     Fr gamma = random_fr();
     Fr delta = random_fr();
     
+    // H has degree <= domain_size - 2, so domain_size powers of tau cover it.
     CRS crs;
-    setup_crs_elements(crs, qap, r1cs, tau, alpha, beta, gamma, delta);
+    setup_crs_elements(crs, qap_basis_at(qap, tau), qap.domain_size,
+                       qap.public_indices, tau, alpha, beta, gamma, delta);
     
     return crs;
 }
@@ -92,28 +109,48 @@ Proof Groth16::prove(const ProvingKey& pk, const QAP& qap, const std::vector<Fr>
     ZK_ASSERT(full_witness.size() == pk.num_variables, "Wrong witness size");
     ZK_ASSERT(full_witness[0] == Fr(1), "Witness[0] must be 1");
     
+    return prove_with_h(pk, full_witness, compute_h_polynomial(qap, full_witness));
+}
+Proof Groth16::prove(const ProvingKey& pk, const SparseQAP& qap, const std::vector<Fr>& full_witness) {
+    ZK_TIMER("Groth16 Prove");
+    
+    ZK_ASSERT(full_witness.size() == pk.num_variables, "Wrong witness size");
+    ZK_ASSERT(full_witness[0] == Fr(1), "Witness[0] must be 1");
+    ZK_ASSERT(pk.degree == qap.domain_size, "Proving key was not generated for this QAP domain");
+    
+    return prove_with_h(pk, full_witness, compute_h_polynomial(qap, full_witness));
+}
+Proof Groth16::prove_with_h(const ProvingKey& pk, const std::vector<Fr>& full_witness,
+                            const Polynomial& H_poly) {
+    
     
     Fr r = random_fr();
     Fr s = random_fr();
     
     
-    G1 A_tau = MSM::msm_g1(full_witness, pk.A_query_g1);
-    G2 B_tau_g2 = MSM::msm_g2(full_witness, pk.B_query_g2);
-    G1 B_tau_g1 = MSM::msm_g1(full_witness, pk.B_query_g1);
+    // A mapped key's queries are read in place.
+    QueryView<G1Affine> A_query = pk.A_query_view();
+    QueryView<G2Affine> B_query_g2 = pk.B_query_g2_view();
+    QueryView<G1Affine> B_query_g1 = pk.B_query_g1_view();
+    QueryView<G1Affine> H_query = pk.H_query_view();
+    QueryView<G1Affine> K_query = pk.K_query_view();
+    
+    G1 A_tau = MSM::msm_g1(full_witness, A_query.data(), A_query.size());
+    G2 B_tau_g2 = MSM::msm_g2(full_witness, B_query_g2.data(), B_query_g2.size());
+    G1 B_tau_g1 = MSM::msm_g1(full_witness, B_query_g1.data(), B_query_g1.size());
     
     
-    Polynomial H_poly = compute_h_polynomial(qap, full_witness);
     std::vector<Fr> h_coeffs = H_poly.coefficients();
     h_coeffs.resize(pk.degree, Fr(0)); 
     
-    G1 H_tau = MSM::msm_g1(h_coeffs, pk.H_query_g1);
+    G1 H_tau = MSM::msm_g1(h_coeffs, H_query.data(), H_query.size());
     
     
     std::vector<Fr> private_witness;
     for (size_t i = pk.num_public + 1; i < full_witness.size(); ++i) {
         private_witness.push_back(full_witness[i]);
     }
-    G1 K_contribution = MSM::msm_g1(private_witness, pk.K_query_g1);
+    G1 K_contribution = MSM::msm_g1(private_witness, K_query.data(), K_query.size());
     
     
     Proof proof;
@@ -149,8 +186,8 @@ bool Groth16::test_circuit(const R1CS& r1cs,
     std::cout << "]" << std::endl;
     
     
-    CRS crs = setup(r1cs);
-    QAP qap = r1cs_to_qap(r1cs);
+    SparseQAP qap = r1cs_to_sparse_qap(r1cs);
+    CRS crs = setup(qap);
     
     
     Proof proof = prove(crs.pk, qap, full_witness);
@@ -158,15 +195,16 @@ bool Groth16::test_circuit(const R1CS& r1cs,
     
     return verify(crs.vk, public_inputs, proof);
 }
-void Groth16::setup_crs_elements(CRS& crs, const QAP& qap, const R1CS& r1cs,
+void Groth16::setup_crs_elements(CRS& crs, const QAPBasisEvaluation& at_tau, size_t degree,
+                                const std::vector<VarIdx>& public_inputs,
                                 const Fr& tau, const Fr& alpha, const Fr& beta, 
                                 const Fr& gamma, const Fr& delta) {
-    size_t n = qap.n;
-    size_t m = qap.m;
+    size_t n = at_tau.A.size();
+    size_t m = degree;
     
     
     crs.pk.num_variables = n;
-    crs.pk.num_public = r1cs.public_inputs().size(); 
+    crs.pk.num_public = public_inputs.size(); 
     crs.pk.degree = m;
     crs.vk.num_public = crs.pk.num_public;
     
@@ -183,60 +221,67 @@ void Groth16::setup_crs_elements(CRS& crs, const QAP& qap, const R1CS& r1cs,
     crs.vk.delta_g2 = crs.pk.delta_g2;
     
     
-    crs.pk.A_query_g1.resize(n);
-    crs.pk.B_query_g2.resize(n); 
-    crs.pk.B_query_g1.resize(n);
-    crs.pk.H_query_g1.resize(m);
+    // Every G1 query is computed in Jacobian form into one vector (A, B, K, H) and
+    // normalised to affine with a single shared inversion; likewise the G2 query.
+    std::vector<G1> g1_points;
+    std::vector<G2> B_g2(n);
+    g1_points.reserve(3 * n + m);
+    g1_points.resize(2 * n);
     
+    std::vector<bool> is_public(n, false);
+    is_public[0] = true;
+    for (size_t pub_idx : public_inputs) {
+        is_public[pub_idx] = true;
+    }
     
     for (size_t i = 0; i < n; ++i) {
-        Fr a_i = qap.A_basis[i].evaluate(tau);
-        Fr b_i = qap.B_basis[i].evaluate(tau);
-        Fr c_i = qap.C_basis[i].evaluate(tau);
-        
-        crs.pk.A_query_g1[i] = G1::generator() * a_i;
-        crs.pk.B_query_g2[i] = G2::generator() * b_i;
-        crs.pk.B_query_g1[i] = G1::generator() * b_i;
+        const Fr& a_i = at_tau.A[i];
+        const Fr& b_i = at_tau.B[i];
         
-        
-        bool is_public = (i == 0); 
-        for (size_t pub_idx : r1cs.public_inputs()) {
-            if (i == pub_idx) {
-                is_public = true;
-                break;
-            }
-        }
-        
-        if (!is_public) {
-            Fr k_val = (beta * a_i + alpha * b_i + c_i) / delta;
-            crs.pk.K_query_g1.push_back(G1::generator() * k_val);
-        }
+        g1_points[i] = G1::generator() * a_i;
+        g1_points[n + i] = G1::generator() * b_i;
+        B_g2[i] = G2::generator() * b_i;
     }
     
+    for (size_t i = 0; i < n; ++i) {
+        if (!is_public[i]) {
+            Fr k_val = (beta * at_tau.A[i] + alpha * at_tau.B[i] + at_tau.C[i]) / delta;
+            g1_points.push_back(G1::generator() * k_val);
+        }
+    }
+    size_t k_count = g1_points.size() - 2 * n;
     
-    Fr z_tau = qap.Z.evaluate(tau);
+    const Fr& z_tau = at_tau.Z;
     Fr tau_power = Fr(1);
     for (size_t k = 0; k < m; ++k) {
         Fr h_k = tau_power * z_tau / delta;
-        crs.pk.H_query_g1[k] = G1::generator() * h_k;
+        g1_points.push_back(G1::generator() * h_k);
         tau_power = tau_power * tau;
     }
     
+    std::vector<G1Affine> g1_affine = G1::batch_normalize(g1_points);
+    auto a_begin = g1_affine.begin();
+    auto b_begin = a_begin + n;
+    auto k_begin = b_begin + n;
+    auto h_begin = k_begin + k_count;
+    crs.pk.A_query_g1.assign(a_begin, b_begin);
+    crs.pk.B_query_g1.assign(b_begin, k_begin);
+    crs.pk.K_query_g1.assign(k_begin, h_begin);
+    crs.pk.H_query_g1.assign(h_begin, g1_affine.end());
+    crs.pk.B_query_g2 = G2::batch_normalize(B_g2);
+    
     
     crs.vk.IC_g1.resize(crs.vk.num_public + 1);
     
     
-    Fr a_0 = qap.A_basis[0].evaluate(tau);
-    Fr b_0 = qap.B_basis[0].evaluate(tau); 
-    Fr c_0 = qap.C_basis[0].evaluate(tau);
-    crs.vk.IC_g1[0] = G1::generator() * ((beta * a_0 + alpha * b_0 + c_0) / gamma);
+    crs.vk.IC_g1[0] = G1::generator() * ((beta * at_tau.A[0] + alpha * at_tau.B[0] + at_tau.C[0]) / gamma);
     
     
-    for (size_t j = 0; j < r1cs.public_inputs().size(); ++j) {
-        size_t pub_idx = r1cs.public_inputs()[j];
-        Fr a_pub = qap.A_basis[pub_idx].evaluate(tau);
-        Fr b_pub = qap.B_basis[pub_idx].evaluate(tau);
-        Fr c_pub = qap.C_basis[pub_idx].evaluate(tau);
+    for (size_t j = 0; j < public_inputs.size(); ++j) {
+        size_t pub_idx = public_inputs[j];
+        Fr a_pub = at_tau.A[pub_idx];
+        Fr b_pub = at_tau.B[pub_idx];
+        Fr c_pub = at_tau.C[pub_idx];
         crs.vk.IC_g1[j + 1] = G1::generator() * ((beta * a_pub + alpha * b_pub + c_pub) / gamma);
     }
 }
@@ -247,14 +292,35 @@ Polynomial Groth16::compute_h_polynomial(const QAP& qap, const std::vector<Fr>&
     Polynomial C_poly = assemble_C(qap, full_witness);
     
     
+    size_t n;
+    if (qap.Z.is_subgroup_vanishing(n) && BitUtils::is_power_of_two(n) &&
+        A_poly.coeffs.size() <= n && B_poly.coeffs.size() <= n && C_poly.coeffs.size() <= n) {
+        // Exactness is A*B == C on the subgroup itself; H = (A*B - C) / Z is then
+        // computed pointwise on the coset g*H, where Z is the constant g^n - 1.
+        std::vector<EvalPoly> on_h = EvalPoly::from_polynomials({A_poly, B_poly, C_poly}, n);
+        ZK_ASSERT(on_h[0] * on_h[1] == on_h[2], "H polynomial division must be exact");
+        
+        std::vector<EvalPoly> on_coset = EvalPoly::from_polynomials(
+            {A_poly, B_poly, C_poly}, n, EvalPoly::Domain::Coset);
+        EvalPoly h = on_coset[0] * on_coset[1];
+        h -= on_coset[2];
+        h *= FFT::cached(n).vanishing_on_coset().inverse();
+        return h.to_polynomial();
+    }
+    
     Polynomial numerator = A_poly * B_poly - C_poly;
     
     
-    auto [quotient, remainder] = numerator.divide(qap.Z);
+    auto [quotient, remainder] = qap.Z.is_subgroup_vanishing(n)
+        ? numerator.divide_by_vanishing(n)
+        : numerator.divide(qap.Z);
     
     ZK_ASSERT(remainder.is_zero(), "H polynomial division must be exact");
     return quotient;
 }
+Polynomial Groth16::compute_h_polynomial(const SparseQAP& qap, const std::vector<Fr>& full_witness) {
+    return compute_H(qap, full_witness);
+}
 G1 Groth16::compute_vk_ic(const VerifyingKey& vk, const std::vector<Fr>& public_inputs) {
     ZK_ASSERT(public_inputs.size() == vk.num_public, "Wrong number of public inputs");
     ZK_ASSERT(vk.IC_g1.size() == vk.num_public + 1, "IC size mismatch");
@@ -1,219 +1,238 @@
 #include "zkmini/keys.hpp"
 #include "zkmini/serialization.hpp"
+#include "zkmini/utils.hpp"
+#include <chrono>
+#include <stdexcept>
 
 namespace zkmini {
 
 ProvingKey::ProvingKey() : num_variables(0), num_public(0), degree(0) {}
 
 VerifyingKey::VerifyingKey() : num_public(0) {}
-std::vector<uint8_t> ProvingKey::serialize() const {
-    std::vector<uint8_t> result;
-    
-    Serialization::write_uint64(result, num_variables);
-    Serialization::write_uint64(result, num_public);
-    Serialization::write_uint64(result, degree);
-    
-    auto alpha_data = Serialization::serialize_g1(alpha_g1);
-    result.insert(result.end(), alpha_data.begin(), alpha_data.end());
-    
-    auto beta_data = Serialization::serialize_g1(beta_g1);
-    result.insert(result.end(), beta_data.begin(), beta_data.end());
-    
-    auto delta_data = Serialization::serialize_g1(delta_g1);
-    result.insert(result.end(), delta_data.begin(), delta_data.end());
-    
-    auto beta_g2_data = Serialization::serialize_g2(beta_g2);
-    result.insert(result.end(), beta_g2_data.begin(), beta_g2_data.end());
-    
-    auto delta_g2_data = Serialization::serialize_g2(delta_g2);
-    result.insert(result.end(), delta_g2_data.begin(), delta_g2_data.end());
-    
-    Serialization::write_uint64(result, A_query_g1.size());
-    for (const auto& point : A_query_g1) {
-        auto point_data = Serialization::serialize_g1(point);
-        result.insert(result.end(), point_data.begin(), point_data.end());
-    }
-    
-    Serialization::write_uint64(result, B_query_g1.size());
-    for (const auto& point : B_query_g1) {
-        auto point_data = Serialization::serialize_g1(point);
-        result.insert(result.end(), point_data.begin(), point_data.end());
-    }
-    
-    Serialization::write_uint64(result, B_query_g2.size());
-    for (const auto& point : B_query_g2) {
-        auto point_data = Serialization::serialize_g2(point);
-        result.insert(result.end(), point_data.begin(), point_data.end());
-    }
-    
-    Serialization::write_uint64(result, K_query_g1.size());
-    for (const auto& point : K_query_g1) {
-        auto point_data = Serialization::serialize_g1(point);
-        result.insert(result.end(), point_data.begin(), point_data.end());
-    }
+namespace {
+
+constexpr size_t G1_BYTES = Serialization::G1_COMPRESSED_SIZE;
+constexpr size_t G2_BYTES = Serialization::G2_COMPRESSED_SIZE;
+
+// The count, then that many compressed points.
+void put_query(ByteWriter& out, QueryView<G1Affine> points) {
+    out.put_u64(points.size());
+    out.put_g1_points(points.data(), points.size());
+}
+
+void put_query(ByteWriter& out, QueryView<G2Affine> points) {
+    out.put_u64(points.size());
+    out.put_g2_points(points.data(), points.size());
+}
+
+// A query's point count, which the key's header already fixes.
+uint64_t query_count(ByteReader& in, uint64_t expected) {
+    uint64_t count = in.get_u64();
+    if (count != expected) throw std::runtime_error("Malformed input: query length does not match the key header");
+    return count;
+}
+
+ProvingKey read_pk(ByteReader& in, bool validate, KeyLoadStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+    ProvingKey pk = ProvingKey::read(in);
+    if (validate) pk.validate();
     
-    Serialization::write_uint64(result, H_query_g1.size());
-    for (const auto& point : H_query_g1) {
-        auto point_data = Serialization::serialize_g1(point);
-        result.insert(result.end(), point_data.begin(), point_data.end());
+    if (stats) {
+        stats->points = pk.num_points();
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
     }
-    
-    return result;
+    return pk;
 }
 
-ProvingKey ProvingKey::deserialize(const std::vector<uint8_t>& data) {
-    size_t offset = 0;
+}
+
+// Format v1: every point compressed (32 bytes in G1, 64 in G2).
+size_t ProvingKey::serialized_size() const {
+    return 3 * 8 + 3 * G1_BYTES + 2 * G2_BYTES + 5 * 8 +
+           G1_BYTES * (A_query_view().size() + B_query_g1_view().size() + K_query_view().size() +
+                       H_query_view().size()) +
+           G2_BYTES * B_query_g2_view().size();
+}
+
+void ProvingKey::write(ByteWriter& out) const {
+    out.put_u64(num_variables);
+    out.put_u64(num_public);
+    out.put_u64(degree);
+    
+    out.put_g1(alpha_g1);
+    out.put_g1(beta_g1);
+    out.put_g1(delta_g1);
+    out.put_g2(beta_g2);
+    out.put_g2(delta_g2);
+    
+    put_query(out, A_query_view());
+    put_query(out, B_query_g1_view());
+    put_query(out, B_query_g2_view());
+    put_query(out, K_query_view());
+    put_query(out, H_query_view());
+}
+
+ProvingKey ProvingKey::read(ByteReader& in) {
     ProvingKey result;
     
-    result.num_variables = Serialization::read_uint64(data, offset);
-    result.num_public = Serialization::read_uint64(data, offset);
-    result.degree = Serialization::read_uint64(data, offset);
-    
-    result.alpha_g1 = Serialization::deserialize_g1(data, offset);
-    result.beta_g1 = Serialization::deserialize_g1(data, offset);
-    result.delta_g1 = Serialization::deserialize_g1(data, offset);
-    
-    result.beta_g2 = Serialization::deserialize_g2(data, offset);
-    result.delta_g2 = Serialization::deserialize_g2(data, offset);
-    
-    uint64_t A_size = Serialization::read_uint64(data, offset);
-    result.A_query_g1.resize(A_size);
-    for (size_t i = 0; i < A_size; ++i) {
-        result.A_query_g1[i] = Serialization::deserialize_g1(data, offset);
-    }
-    
-    uint64_t B1_size = Serialization::read_uint64(data, offset);
-    result.B_query_g1.resize(B1_size);
-    for (size_t i = 0; i < B1_size; ++i) {
-        result.B_query_g1[i] = Serialization::deserialize_g1(data, offset);
-    }
-    
-    uint64_t B2_size = Serialization::read_uint64(data, offset);
-    result.B_query_g2.resize(B2_size);
-    for (size_t i = 0; i < B2_size; ++i) {
-        result.B_query_g2[i] = Serialization::deserialize_g2(data, offset);
-    }
+    result.num_variables = in.get_u64();
+    result.num_public = in.get_u64();
+    result.degree = in.get_u64();
     
-    uint64_t K_size = Serialization::read_uint64(data, offset);
-    result.K_query_g1.resize(K_size);
-    for (size_t i = 0; i < K_size; ++i) {
-        result.K_query_g1[i] = Serialization::deserialize_g1(data, offset);
-    }
+    result.alpha_g1 = in.get_g1();
+    result.beta_g1 = in.get_g1();
+    result.delta_g1 = in.get_g1();
+    result.beta_g2 = in.get_g2();
+    result.delta_g2 = in.get_g2();
     
-    uint64_t H_size = Serialization::read_uint64(data, offset);
-    result.H_query_g1.resize(H_size);
-    for (size_t i = 0; i < H_size; ++i) {
-        result.H_query_g1[i] = Serialization::deserialize_g1(data, offset);
+    // Decompressed in parallel chunks straight from the input. The lengths are held
+    // to the header, as load_mmap() does, so a mismatched key fails here, not in prove().
+    if (result.num_public >= result.num_variables) {
+        throw std::runtime_error("Malformed input: more public inputs than variables");
     }
+    uint64_t n = result.num_variables;
+    result.A_query_g1 = in.get_g1_points(query_count(in, n));
+    result.B_query_g1 = in.get_g1_points(query_count(in, n));
+    result.B_query_g2 = in.get_g2_points(query_count(in, n));
+    result.K_query_g1 = in.get_g1_points(query_count(in, n - result.num_public - 1));
+    result.H_query_g1 = in.get_g1_points(query_count(in, result.degree));
     
     return result;
 }
 
+std::vector<uint8_t> ProvingKey::serialize() const {
+    ByteWriter out(serialized_size());
+    write(out);
+    return out.take();
+}
+
+ProvingKey ProvingKey::deserialize(const std::vector<uint8_t>& data, bool validate, KeyLoadStats* stats) {
+    ByteReader in(data);
+    return read_pk(in, validate, stats);
+}
+
 void ProvingKey::save_to_file(const std::string& filename) const {
-    std::vector<uint8_t> data = serialize();
-    Serialization::write_file(filename, data);
+    ByteWriter out(filename);
+    write(out);
+    out.finish();
 }
 
-ProvingKey ProvingKey::load_from_file(const std::string& filename) {
-    std::vector<uint8_t> data = Serialization::read_file(filename);
-    return deserialize(data);
+ProvingKey ProvingKey::load_from_file(const std::string& filename, bool validate, KeyLoadStats* stats) {
+    if (is_mmap_file(filename)) {
+        return load_mmap(filename, validate, stats);
+    }
+    MappedFile file(filename);
+    ByteReader in(file.data(), file.size());
+    return read_pk(in, validate, stats);
 }
 
-std::vector<uint8_t> VerifyingKey::serialize() const {
-    std::vector<uint8_t> result;
-    
-    Serialization::write_uint64(result, num_public);
-    
-    auto alpha_data = Serialization::serialize_g1(alpha_g1);
-    result.insert(result.end(), alpha_data.begin(), alpha_data.end());
-    
-    auto beta_data = Serialization::serialize_g2(beta_g2);
-    result.insert(result.end(), beta_data.begin(), beta_data.end());
-    
-    auto gamma_data = Serialization::serialize_g2(gamma_g2);
-    result.insert(result.end(), gamma_data.begin(), gamma_data.end());
-    
-    auto delta_data = Serialization::serialize_g2(delta_g2);
-    result.insert(result.end(), delta_data.begin(), delta_data.end());
+size_t ProvingKey::num_points() const {
+    return 5 + A_query_view().size() + B_query_g1_view().size() + B_query_g2_view().size() +
+           K_query_view().size() + H_query_view().size();
+}
+
+size_t VerifyingKey::serialized_size() const {
+    return 8 + G1_BYTES + 3 * G2_BYTES + 8 + G1_BYTES * IC_g1.size();
+}
+
+void VerifyingKey::write(ByteWriter& out) const {
+    out.put_u64(num_public);
     
-    Serialization::write_uint64(result, IC_g1.size());
-    for (const auto& point : IC_g1) {
-        auto point_data = Serialization::serialize_g1(point);
-        result.insert(result.end(), point_data.begin(), point_data.end());
-    }
+    out.put_g1(alpha_g1);
+    out.put_g2(beta_g2);
+    out.put_g2(gamma_g2);
+    out.put_g2(delta_g2);
     
-    return result;
+    std::vector<G1Affine> ic = G1::batch_normalize(IC_g1);
+    put_query(out, QueryView<G1Affine>(ic.data(), ic.size()));
 }
 
-VerifyingKey VerifyingKey::deserialize(const std::vector<uint8_t>& data) {
-    size_t offset = 0;
+VerifyingKey VerifyingKey::read(ByteReader& in) {
     VerifyingKey result;
     
-    result.num_public = Serialization::read_uint64(data, offset);
+    result.num_public = in.get_u64();
     
-    result.alpha_g1 = Serialization::deserialize_g1(data, offset);
-    result.beta_g2 = Serialization::deserialize_g2(data, offset);
-    result.gamma_g2 = Serialization::deserialize_g2(data, offset);
-    result.delta_g2 = Serialization::deserialize_g2(data, offset);
+    result.alpha_g1 = in.get_g1();
+    result.beta_g2 = in.get_g2();
+    result.gamma_g2 = in.get_g2();
+    result.delta_g2 = in.get_g2();
     
-    uint64_t IC_size = Serialization::read_uint64(data, offset);
-    result.IC_g1.resize(IC_size);
-    for (size_t i = 0; i < IC_size; ++i) {
-        result.IC_g1[i] = Serialization::deserialize_g1(data, offset);
+    // One IC point per public input plus the constant.
+    if (result.num_public == UINT64_MAX) throw std::runtime_error("Malformed input: public input count");
+    std::vector<G1Affine> ic = in.get_g1_points(query_count(in, result.num_public + 1));
+    result.IC_g1.reserve(ic.size());
+    for (const G1Affine& point : ic) {
+        result.IC_g1.push_back(point.to_jacobian());
     }
     
     return result;
 }
 
+std::vector<uint8_t> VerifyingKey::serialize() const {
+    ByteWriter out(serialized_size());
+    write(out);
+    return out.take();
+}
+
+VerifyingKey VerifyingKey::deserialize(const std::vector<uint8_t>& data) {
+    ByteReader in(data);
+    return read(in);
+}
+
 void VerifyingKey::save_to_file(const std::string& filename) const {
-    std::vector<uint8_t> data = serialize();
-    Serialization::write_file(filename, data);
+    ByteWriter out(filename);
+    write(out);
+    out.finish();
 }
 
 VerifyingKey VerifyingKey::load_from_file(const std::string& filename) {
-    std::vector<uint8_t> data = Serialization::read_file(filename);
-    return deserialize(data);
+    MappedFile file(filename);
+    ByteReader in(file.data(), file.size());
+    return read(in);
 }
 
-std::vector<uint8_t> CRS::serialize() const {
-    std::vector<uint8_t> pk_data = pk.serialize();
-    std::vector<uint8_t> vk_data = vk.serialize();
-    
-    std::vector<uint8_t> result;
-    
-    Serialization::write_uint64(result, pk_data.size());
-    result.insert(result.end(), pk_data.begin(), pk_data.end());
-    
-    Serialization::write_uint64(result, vk_data.size());
-    result.insert(result.end(), vk_data.begin(), vk_data.end());
-    
-    return result;
+void CRS::write(ByteWriter& out) const {
+    out.put_u64(pk.serialized_size());
+    pk.write(out);
+    out.put_u64(vk.serialized_size());
+    vk.write(out);
 }
 
-CRS CRS::deserialize(const std::vector<uint8_t>& data) {
-    size_t offset = 0;
+CRS CRS::read(ByteReader& in) {
     CRS result;
     
-    uint64_t pk_size = Serialization::read_uint64(data, offset);
-    std::vector<uint8_t> pk_data(data.begin() + offset, data.begin() + offset + pk_size);
-    offset += pk_size;
-    result.pk = ProvingKey::deserialize(pk_data);
+    size_t pk_size = in.get_count(1);
+    ByteReader pk_in(in.take(pk_size), pk_size);
+    result.pk = ProvingKey::read(pk_in);
     
-    uint64_t vk_size = Serialization::read_uint64(data, offset);
-    std::vector<uint8_t> vk_data(data.begin() + offset, data.begin() + offset + vk_size);
-    result.vk = VerifyingKey::deserialize(vk_data);
+    size_t vk_size = in.get_count(1);
+    ByteReader vk_in(in.take(vk_size), vk_size);
+    result.vk = VerifyingKey::read(vk_in);
     
     return result;
 }
 
+std::vector<uint8_t> CRS::serialize() const {
+    ByteWriter out(8 + pk.serialized_size() + 8 + vk.serialized_size());
+    write(out);
+    return out.take();
+}
+
+CRS CRS::deserialize(const std::vector<uint8_t>& data) {
+    ByteReader in(data);
+    return read(in);
+}
+
 void CRS::save_to_file(const std::string& filename) const {
-    std::vector<uint8_t> data = serialize();
-    Serialization::write_file(filename, data);
+    ByteWriter out(filename);
+    write(out);
+    out.finish();
 }
 
 CRS CRS::load_from_file(const std::string& filename) {
-    std::vector<uint8_t> data = Serialization::read_file(filename);
-    return deserialize(data);
+    MappedFile file(filename);
+    ByteReader in(file.data(), file.size());
+    return read(in);
 }
 
 void CRS::save_keys(const std::string& pk_file, const std::string& vk_file) const {
@@ -0,0 +1,228 @@
+#include "zkmini/keys.hpp"
+#include "zkmini/utils.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace zkmini {
+
+namespace {
+
+// Layout (host byte order, checked through BYTE_ORDER_MARK):
+//   0    magic "ZKPKEY\0\0" | version u32 | byte-order mark u32
+//   16   num_variables u64 | num_public u64 | degree u64 | n_sections u64
+//   48   section index, n_sections entries of id u32 | record bytes u32 | offset u64 | count u64
+//   256  sections, each an array of G1Affine / G2Affine starting on a 64-byte boundary
+constexpr char MAGIC[8] = {'Z', 'K', 'P', 'K', 'E', 'Y', 0, 0};
+constexpr uint32_t PK_VERSION = 2;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr size_t HEADER_BYTES = 256;
+constexpr size_t INDEX_OFFSET = 48;
+constexpr size_t INDEX_ENTRY_BYTES = 24;
+constexpr size_t MAX_SECTIONS = (HEADER_BYTES - INDEX_OFFSET) / INDEX_ENTRY_BYTES;
+constexpr size_t ARRAY_ALIGN = 64;
+
+// Points per parallel work item when copying or validating.
+constexpr size_t POINT_CHUNK = 1 << 12;
+
+enum SectionId : uint32_t {
+    SECTION_FIXED_G1 = 1,   // alpha, beta, delta
+    SECTION_FIXED_G2 = 2,   // beta, delta
+    SECTION_A_G1 = 3,
+    SECTION_B_G1 = 4,
+    SECTION_B_G2 = 5,
+    SECTION_K_G1 = 6,
+    SECTION_H_G1 = 7,
+};
+
+struct SectionEntry {
+    uint32_t id;
+    uint32_t record_bytes;
+    uint64_t offset;
+    uint64_t count;
+};
+
+uint64_t align_up(uint64_t x) {
+    return (x + ARRAY_ALIGN - 1) & ~uint64_t(ARRAY_ALIGN - 1);
+}
+
+void require(bool ok, const char* message) {
+    if (!ok) throw std::runtime_error(std::string("Invalid proving key file: ") + message);
+}
+
+template <typename Affine>
+std::vector<Affine> copy_all(const QueryView<Affine>& records) {
+    std::vector<Affine> out(records.size());
+    Parallel::parallel_for(0, records.size(), [&](size_t lo, size_t hi) {
+        std::copy(records.begin() + lo, records.begin() + hi, out.begin() + lo);
+    }, POINT_CHUNK);
+    return out;
+}
+
+}
+
+void ProvingKey::save_mmap(const std::string& filename) const {
+    std::vector<G1Affine> fixed_g1 = G1::batch_normalize({alpha_g1, beta_g1, delta_g1});
+    std::vector<G2Affine> fixed_g2 = G2::batch_normalize({beta_g2, delta_g2});
+
+    struct Section {
+        uint32_t id;
+        uint32_t record_bytes;
+        const void* data;
+        uint64_t count;
+    };
+    auto g1 = [](uint32_t id, QueryView<G1Affine> v) {
+        return Section{id, sizeof(G1Affine), v.data(), v.size()};
+    };
+    auto g2 = [](uint32_t id, QueryView<G2Affine> v) {
+        return Section{id, sizeof(G2Affine), v.data(), v.size()};
+    };
+    // The in-memory queries already have the record layout and are written as they are.
+    const Section sections[] = {
+        g1(SECTION_FIXED_G1, QueryView<G1Affine>(fixed_g1.data(), fixed_g1.size())),
+        g2(SECTION_FIXED_G2, QueryView<G2Affine>(fixed_g2.data(), fixed_g2.size())),
+        g1(SECTION_A_G1, A_query_view()),
+        g1(SECTION_B_G1, B_query_g1_view()),
+        g2(SECTION_B_G2, B_query_g2_view()),
+        g1(SECTION_K_G1, K_query_view()),
+        g1(SECTION_H_G1, H_query_view()),
+    };
+    const size_t n_sections = sizeof(sections) / sizeof(sections[0]);
+    static_assert(sizeof(sections) / sizeof(sections[0]) <= MAX_SECTIONS, "Section index overflows the header");
+
+    uint8_t header[HEADER_BYTES] = {};
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    std::memcpy(header + 8, &PK_VERSION, 4);
+    std::memcpy(header + 12, &BYTE_ORDER_MARK, 4);
+    uint64_t counts[4] = {num_variables, num_public, degree, n_sections};
+    std::memcpy(header + 16, counts, sizeof(counts));
+
+    uint64_t offset = HEADER_BYTES;
+    for (size_t s = 0; s < n_sections; ++s) {
+        SectionEntry e = {sections[s].id, sections[s].record_bytes, offset, sections[s].count};
+        std::memcpy(header + INDEX_OFFSET + INDEX_ENTRY_BYTES * s, &e, INDEX_ENTRY_BYTES);
+        offset = align_up(offset + e.count * e.record_bytes);
+    }
+
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) throw std::runtime_error("Cannot open file for writing: " + filename);
+    out.write(reinterpret_cast<const char*>(header), HEADER_BYTES);
+
+    static const char zeros[ARRAY_ALIGN] = {};
+    uint64_t pos = HEADER_BYTES;
+    for (size_t s = 0; s < n_sections; ++s) {
+        uint64_t bytes = sections[s].count * sections[s].record_bytes;
+        out.write(static_cast<const char*>(sections[s].data), bytes);
+        pos += bytes;
+        out.write(zeros, align_up(pos) - pos);
+        pos = align_up(pos);
+    }
+
+    out.flush();
+    if (!out) throw std::runtime_error("Failed writing proving key: " + filename);
+}
+
+bool ProvingKey::is_mmap_file(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    char magic[sizeof(MAGIC)] = {};
+    in.read(magic, sizeof(magic));
+    return in && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+ProvingKey ProvingKey::load_mmap(const std::string& filename, bool validate, KeyLoadStats* stats) {
+    static_assert(sizeof(SectionEntry) == INDEX_ENTRY_BYTES, "SectionEntry must match the file layout");
+    auto start = std::chrono::steady_clock::now();
+
+    auto file = std::make_shared<MappedFile>(filename);
+    const uint8_t* base = file->data();
+    uint64_t size = file->size();
+
+    require(size >= HEADER_BYTES && std::memcmp(base, MAGIC, sizeof(MAGIC)) == 0, "bad magic");
+    uint32_t version, mark;
+    std::memcpy(&version, base + 8, 4);
+    std::memcpy(&mark, base + 12, 4);
+    require(version == PK_VERSION, "unsupported version");
+    require(mark == BYTE_ORDER_MARK, "written with a different byte order");
+
+    uint64_t counts[4];
+    std::memcpy(counts, base + 16, sizeof(counts));
+    require(counts[3] <= MAX_SECTIONS, "too many sections");
+
+    ProvingKey pk;
+    pk.num_variables = counts[0];
+    pk.num_public = counts[1];
+    pk.degree = counts[2];
+
+    // Sections are found by id, so their order in the file does not matter.
+    SectionEntry found[SECTION_H_G1 + 1] = {};
+    for (uint64_t s = 0; s < counts[3]; ++s) {
+        SectionEntry e;
+        std::memcpy(&e, base + INDEX_OFFSET + INDEX_ENTRY_BYTES * s, INDEX_ENTRY_BYTES);
+        if (e.id < SECTION_FIXED_G1 || e.id > SECTION_H_G1) continue;
+        require(e.offset % ARRAY_ALIGN == 0, "misaligned section");
+        require(e.offset <= size && e.count <= (size - e.offset) / std::max<uint32_t>(e.record_bytes, 1),
+                "section out of bounds");
+        found[e.id] = e;
+    }
+
+    auto g1_section = [&](uint32_t id) {
+        const SectionEntry& e = found[id];
+        require(e.id == id && e.record_bytes == sizeof(G1Affine), "missing G1 section");
+        return QueryView<G1Affine>(reinterpret_cast<const G1Affine*>(base + e.offset), e.count);
+    };
+    auto g2_section = [&](uint32_t id) {
+        const SectionEntry& e = found[id];
+        require(e.id == id && e.record_bytes == sizeof(G2Affine), "missing G2 section");
+        return QueryView<G2Affine>(reinterpret_cast<const G2Affine*>(base + e.offset), e.count);
+    };
+
+    QueryView<G1Affine> fixed_g1 = g1_section(SECTION_FIXED_G1);
+    QueryView<G2Affine> fixed_g2 = g2_section(SECTION_FIXED_G2);
+    require(fixed_g1.size() == 3 && fixed_g2.size() == 2, "bad fixed point count");
+    for (const auto& p : fixed_g1) require(p.is_reduced(), "coordinate not reduced");
+    for (const auto& p : fixed_g2) require(p.is_reduced(), "coordinate not reduced");
+    pk.alpha_g1 = fixed_g1[0].to_jacobian();
+    pk.beta_g1 = fixed_g1[1].to_jacobian();
+    pk.delta_g1 = fixed_g1[2].to_jacobian();
+    pk.beta_g2 = fixed_g2[0].to_jacobian();
+    pk.delta_g2 = fixed_g2[1].to_jacobian();
+
+    pk.A_query_mapped = g1_section(SECTION_A_G1);
+    pk.B_query_g1_mapped = g1_section(SECTION_B_G1);
+    pk.B_query_g2_mapped = g2_section(SECTION_B_G2);
+    pk.K_query_mapped = g1_section(SECTION_K_G1);
+    pk.H_query_mapped = g1_section(SECTION_H_G1);
+    require(pk.num_public < pk.num_variables && pk.A_query_mapped.size() == pk.num_variables &&
+            pk.B_query_g1_mapped.size() == pk.num_variables && pk.B_query_g2_mapped.size() == pk.num_variables &&
+            pk.K_query_mapped.size() == pk.num_variables - pk.num_public - 1 &&
+            pk.H_query_mapped.size() == pk.degree, "query lengths do not match the header");
+
+    pk.backing = std::move(file);
+    if (validate) pk.validate();
+
+    if (stats) {
+        stats->points = pk.num_points();
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return pk;
+}
+
+void ProvingKey::materialize_queries() {
+    if (!backing) return;
+    A_query_g1 = copy_all(A_query_mapped);
+    B_query_g1 = copy_all(B_query_g1_mapped);
+    B_query_g2 = copy_all(B_query_g2_mapped);
+    K_query_g1 = copy_all(K_query_mapped);
+    H_query_g1 = copy_all(H_query_mapped);
+
+    A_query_mapped = QueryView<G1Affine>();
+    B_query_g1_mapped = QueryView<G1Affine>();
+    B_query_g2_mapped = QueryView<G2Affine>();
+    K_query_mapped = QueryView<G1Affine>();
+    H_query_mapped = QueryView<G1Affine>();
+    backing.reset();
+}
+
+}
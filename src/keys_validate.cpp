@@ -0,0 +1,67 @@
+#include "zkmini/keys.hpp"
+#include "zkmini/utils.hpp"
+#include <atomic>
+#include <stdexcept>
+
+namespace zkmini {
+
+namespace {
+
+// Points per parallel work item; a curve check is a handful of multiplications.
+constexpr size_t CHECK_CHUNK = 1 << 12;
+// A subgroup check is a full scalar multiplication.
+constexpr size_t SUBGROUP_CHUNK = 16;
+
+void require(bool ok, const char* message) {
+    if (!ok) throw std::runtime_error(std::string("Invalid proving key: ") + message);
+}
+
+template <typename Affine>
+bool all_on_curve(const QueryView<Affine>& points) {
+    std::atomic<bool> bad(false);
+    Parallel::parallel_for(0, points.size(), [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            if (bad.load(std::memory_order_relaxed)) return;
+            if (!points[i].is_reduced() || !points[i].is_on_curve()) {
+                bad.store(true, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }, CHECK_CHUNK);
+    return !bad.load();
+}
+
+// One r * P_i = 0 per point. A random combination sum(rho_i * P_i) is not enough:
+// the cofactor is divisible by 3 and 1471, and a torsion component of order 3 drops
+// out whenever rho_i happens to be a multiple of 3.
+bool all_in_subgroup(const QueryView<G2Affine>& points) {
+    std::atomic<bool> bad(false);
+    Parallel::parallel_for(0, points.size(), [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            if (bad.load(std::memory_order_relaxed)) return;
+            if (!points[i].to_jacobian().is_in_subgroup()) {
+                bad.store(true, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }, SUBGROUP_CHUNK);
+    return !bad.load();
+}
+
+}
+
+void ProvingKey::validate() const {
+    for (const G1& p : {alpha_g1, beta_g1, delta_g1}) {
+        require(p.is_on_curve(), "fixed G1 point not on the curve");
+    }
+    for (const G2& p : {beta_g2, delta_g2}) {
+        require(p.is_on_curve() && p.is_in_subgroup(), "fixed G2 point not in the subgroup");
+    }
+    
+    require(all_on_curve(A_query_view()) && all_on_curve(B_query_g1_view()) &&
+            all_on_curve(K_query_view()) && all_on_curve(H_query_view()), "G1 query point not on the curve");
+    require(all_on_curve(B_query_g2_view()), "G2 query point not on the curve");
+    require(all_in_subgroup(B_query_g2_view()), "G2 query point not in the subgroup");
+}
+
+}
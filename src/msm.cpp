@@ -1,26 +1,81 @@
 #include "zkmini/msm.hpp"
 #include "zkmini/utils.hpp"
+#include <algorithm>
 
 namespace zkmini {
 
-G1 MSM::msm_g1(const std::vector<Fr>& scalars, const std::vector<G1>& points) {
-    ZK_ASSERT(scalars.size() == points.size(), "Scalar and point vectors must have same size");
+namespace {
+
+// Bits [bit, bit + width) of a canonical scalar; width < 64.
+uint64_t scalar_window(const Fr& s, size_t bit, size_t width) {
+    size_t limb = bit / 64;
+    size_t shift = bit % 64;
+    uint64_t v = s.data[limb] >> shift;
+    if (shift + width > 64 && limb + 1 < 4) v |= s.data[limb + 1] << (64 - shift);
+    return v & ((uint64_t(1) << width) - 1);
+}
+
+// Scalars are below r < 2^254.
+constexpr size_t SCALAR_BITS = 254;
+
+// Largest bucket window: 2^16 buckets per window being summed.
+constexpr size_t MAX_WINDOW = 16;
+
+template <typename Point, typename Affine>
+Point bucket_msm(const std::vector<Fr>& scalars, const Affine* points, size_t n, size_t c) {
+    size_t num_windows = (SCALAR_BITS + c - 1) / c;
+    std::vector<Point> window_sums(num_windows);
     
-    G1 result;
-    for (size_t i = 0; i < scalars.size(); ++i) {
-        result = result + (points[i] * scalars[i]);
+    Parallel::parallel_for(0, num_windows, [&](size_t lo, size_t hi) {
+        std::vector<Point> buckets((size_t(1) << c) - 1);
+        for (size_t w = lo; w < hi; ++w) {
+            std::fill(buckets.begin(), buckets.end(), Point());
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t d = scalar_window(scalars[i], w * c, c);
+                if (d != 0) buckets[d - 1] = buckets[d - 1] + points[i];
+            }
+            // sum_d d * bucket[d], as a running sum from the top bucket down.
+            Point running, sum;
+            for (size_t d = buckets.size(); d-- > 0;) {
+                running = running + buckets[d];
+                sum = sum + running;
+            }
+            window_sums[w] = sum;
+        }
+    });
+    
+    Point result;
+    for (size_t w = num_windows; w-- > 0;) {
+        for (size_t k = 0; k < c; ++k) result = result.double_point();
+        result = result + window_sums[w];
     }
     return result;
 }
 
+}
+
+G1 MSM::msm_g1(const std::vector<Fr>& scalars, const std::vector<G1>& points) {
+    ZK_ASSERT(scalars.size() == points.size(), "Scalar and point vectors must have same size");
+    std::vector<G1Affine> bases = G1::batch_normalize(points);
+    return msm_g1(scalars, bases.data(), bases.size());
+}
+
 G2 MSM::msm_g2(const std::vector<Fr>& scalars, const std::vector<G2>& points) {
     ZK_ASSERT(scalars.size() == points.size(), "Scalar and point vectors must have same size");
-    
-    G2 result;
-    for (size_t i = 0; i < scalars.size(); ++i) {
-        result = result + (points[i] * scalars[i]);
-    }
-    return result;
+    std::vector<G2Affine> bases = G2::batch_normalize(points);
+    return msm_g2(scalars, bases.data(), bases.size());
+}
+
+G1 MSM::msm_g1(const std::vector<Fr>& scalars, const G1Affine* points, size_t n) {
+    ZK_ASSERT(scalars.size() == n, "Scalar and point vectors must have same size");
+    if (n == 0) return G1();
+    return bucket_msm<G1>(scalars, points, n, optimal_window_size(n));
+}
+
+G2 MSM::msm_g2(const std::vector<Fr>& scalars, const G2Affine* points, size_t n) {
+    ZK_ASSERT(scalars.size() == n, "Scalar and point vectors must have same size");
+    if (n == 0) return G2();
+    return bucket_msm<G2>(scalars, points, n, optimal_window_size(n));
 }
 
 G1 MSM::windowed_msm_g1(const std::vector<Fr>& scalars, 
@@ -217,16 +272,21 @@ G2 MSM::G2Table::multiply(const Fr& scalar) const {
     return result;
 }
 
+// A window of c bits costs about n additions to fill its buckets and 2^(c+1) to sum
+// them, over SCALAR_BITS / c windows. The c minimising that grows like log2(n) minus
+// a little; MAX_WINDOW bounds the bucket memory on huge inputs.
 size_t MSM::optimal_window_size(size_t num_points) {
-    
-    
-    if (num_points < 8) return 2;
-    if (num_points < 32) return 3;
-    if (num_points < 128) return 4;
-    if (num_points < 512) return 5;
-    if (num_points < 2048) return 6;
-    if (num_points < 8192) return 7;
-    return 8; 
+    size_t best = 2;
+    double best_cost = 0;
+    for (size_t c = 2; c <= MAX_WINDOW; ++c) {
+        double windows = static_cast<double>((SCALAR_BITS + c - 1) / c);
+        double cost = windows * (static_cast<double>(num_points) + static_cast<double>(size_t(2) << c));
+        if (c == 2 || cost < best_cost) {
+            best = c;
+            best_cost = cost;
+        }
+    }
+    return best;
 }
 
 std::vector<std::vector<size_t>> MSM::bucket_sort(const std::vector<Fr>& scalars, 
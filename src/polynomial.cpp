@@ -1,9 +1,62 @@
 #include "zkmini/polynomial.hpp"
 #include "zkmini/random.hpp"
+#include "zkmini/fft.hpp"
+#include "zkmini/subproduct_tree.hpp"
 #include <cassert>
 #include <sstream>
+#include <algorithm>
 
 namespace zkmini {
+
+namespace {
+
+constexpr size_t KARATSUBA_BASE = 8;
+
+// out[0 .. na+nb-1) += a * b
+void schoolbook_acc(const Fr* a, size_t na, const Fr* b, size_t nb, Fr* out) {
+    for (size_t i = 0; i < na; ++i) {
+        if (a[i].is_zero()) continue;
+        for (size_t j = 0; j < nb; ++j) {
+            out[i + j] = out[i + j] + a[i] * b[j];
+        }
+    }
+}
+
+// out[0 .. 2n-1) = a * b for two length-n operands; out must be zeroed.
+void karatsuba_rec(const Fr* a, const Fr* b, size_t n, Fr* out) {
+    if (n <= KARATSUBA_BASE) {
+        schoolbook_acc(a, n, b, n, out);
+        return;
+    }
+    
+    size_t m = n / 2;
+    size_t h = n - m;
+    
+    karatsuba_rec(a, b, m, out);
+    karatsuba_rec(a + m, b + m, h, out + 2 * m);
+    
+    std::vector<Fr> sa(a + m, a + n);
+    std::vector<Fr> sb(b + m, b + n);
+    for (size_t i = 0; i < m; ++i) {
+        sa[i] = sa[i] + a[i];
+        sb[i] = sb[i] + b[i];
+    }
+    
+    std::vector<Fr> mid(2 * h - 1, Fr());
+    karatsuba_rec(sa.data(), sb.data(), h, mid.data());
+    
+    for (size_t i = 0; i + 1 < 2 * m; ++i) {
+        mid[i] = mid[i] - out[i];
+    }
+    for (size_t i = 0; i + 1 < 2 * h; ++i) {
+        mid[i] = mid[i] - out[2 * m + i];
+    }
+    for (size_t i = 0; i < mid.size(); ++i) {
+        out[m + i] = out[m + i] + mid[i];
+    }
+}
+
+}
 const Fr Polynomial::ZERO_FR = Fr();
 Polynomial::Polynomial() {}
 
@@ -11,6 +64,10 @@ Polynomial::Polynomial(const std::vector<Fr>& coeffs) : coeffs(coeffs) {
     normalize();
 }
 
+Polynomial::Polynomial(std::vector<Fr>&& coeffs) : coeffs(std::move(coeffs)) {
+    normalize();
+}
+
 Polynomial::Polynomial(size_t degree) : coeffs(degree + 1, Fr()) {}
 Polynomial Polynomial::zero() {
     return Polynomial();
@@ -54,37 +111,44 @@ void Polynomial::normalize() {
 }
 
 Polynomial Polynomial::add(const Polynomial& a, const Polynomial& b) {
-    size_t max_size = std::max(a.coeffs.size(), b.coeffs.size());
-    std::vector<Fr> result;
-    result.reserve(max_size);
+    const Polynomial& longer = a.coeffs.size() >= b.coeffs.size() ? a : b;
+    const Polynomial& shorter = a.coeffs.size() >= b.coeffs.size() ? b : a;
     
-    for (size_t i = 0; i < max_size; ++i) {
-        Fr sum = Fr();
-        if (i < a.coeffs.size()) sum = a.coeffs[i];
-        if (i < b.coeffs.size()) sum = sum + b.coeffs[i];
-        result.push_back(sum);
+    std::vector<Fr> result(longer.coeffs.size());
+    for (size_t i = 0; i < shorter.coeffs.size(); ++i) {
+        result[i] = a.coeffs[i] + b.coeffs[i];
     }
+    std::copy(longer.coeffs.begin() + shorter.coeffs.size(), longer.coeffs.end(),
+              result.begin() + shorter.coeffs.size());
     
-    Polynomial p(result);
-    p.normalize();
-    return p;
+    return Polynomial(std::move(result));
 }
 
 Polynomial Polynomial::sub(const Polynomial& a, const Polynomial& b) {
-    size_t max_size = std::max(a.coeffs.size(), b.coeffs.size());
-    std::vector<Fr> result;
-    result.reserve(max_size);
+    size_t common = std::min(a.coeffs.size(), b.coeffs.size());
+    std::vector<Fr> result(std::max(a.coeffs.size(), b.coeffs.size()));
     
-    for (size_t i = 0; i < max_size; ++i) {
-        Fr diff = Fr();
-        if (i < a.coeffs.size()) diff = a.coeffs[i];
-        if (i < b.coeffs.size()) diff = diff - b.coeffs[i];
-        result.push_back(diff);
+    for (size_t i = 0; i < common; ++i) {
+        result[i] = a.coeffs[i] - b.coeffs[i];
+    }
+    for (size_t i = common; i < a.coeffs.size(); ++i) {
+        result[i] = a.coeffs[i];
+    }
+    for (size_t i = common; i < b.coeffs.size(); ++i) {
+        result[i] = Fr() - b.coeffs[i];
     }
     
-    Polynomial p(result);
-    p.normalize();
-    return p;
+    return Polynomial(std::move(result));
+}
+
+Polynomial Polynomial::add(Polynomial&& a, const Polynomial& b) {
+    add_inplace(a, b);
+    return std::move(a);
+}
+
+Polynomial Polynomial::sub(Polynomial&& a, const Polynomial& b) {
+    sub_inplace(a, b);
+    return std::move(a);
 }
 
 void Polynomial::add_inplace(Polynomial& dst, const Polynomial& src) {
@@ -114,15 +178,17 @@ Polynomial Polynomial::scalar_mul(const Polynomial& f, const Fr& k) {
     if (k.is_zero()) return Polynomial::zero();
     if (f.is_zero()) return Polynomial::zero();
     
-    std::vector<Fr> result;
-    result.reserve(f.coeffs.size());
-    
-    for (const Fr& coeff : f.coeffs) {
-        result.push_back(coeff * k);
+    std::vector<Fr> result(f.coeffs.size());
+    for (size_t i = 0; i < f.coeffs.size(); ++i) {
+        result[i] = f.coeffs[i] * k;
     }
     
-    Polynomial p(result);
-    return p;
+    return Polynomial(std::move(result));
+}
+
+Polynomial Polynomial::scalar_mul(Polynomial&& f, const Fr& k) {
+    scalar_mul_inplace(f, k);
+    return std::move(f);
 }
 
 void Polynomial::scalar_mul_inplace(Polynomial& f, const Fr& k) {
@@ -138,6 +204,47 @@ void Polynomial::scalar_mul_inplace(Polynomial& f, const Fr& k) {
     
     f.normalize();
 }
+
+void Polynomial::axpy(Polynomial& dst, const Fr& k, const Polynomial& src) {
+    if (k.is_zero() || src.is_zero()) return;
+    if (src.coeffs.size() > dst.coeffs.size()) {
+        dst.coeffs.resize(src.coeffs.size(), Fr());
+    }
+    
+    if (k.is_one()) {
+        for (size_t i = 0; i < src.coeffs.size(); ++i) {
+            dst.coeffs[i] = dst.coeffs[i] + src.coeffs[i];
+        }
+    } else {
+        for (size_t i = 0; i < src.coeffs.size(); ++i) {
+            dst.coeffs[i] = dst.coeffs[i] + k * src.coeffs[i];
+        }
+    }
+    
+    dst.normalize();
+}
+
+Polynomial Polynomial::linear_combination(const std::vector<Fr>& scalars,
+                                          const std::vector<const Polynomial*>& polys) {
+    assert(scalars.size() == polys.size() && "Scalars and polynomials size mismatch");
+    
+    size_t max_size = 0;
+    for (size_t j = 0; j < polys.size(); ++j) {
+        if (!scalars[j].is_zero()) max_size = std::max(max_size, polys[j]->coeffs.size());
+    }
+    
+    std::vector<Fr> result(max_size, Fr());
+    for (size_t j = 0; j < polys.size(); ++j) {
+        const Fr& k = scalars[j];
+        if (k.is_zero()) continue;
+        const std::vector<Fr>& src = polys[j]->coeffs;
+        for (size_t i = 0; i < src.size(); ++i) {
+            result[i] = result[i] + k * src[i];
+        }
+    }
+    
+    return Polynomial(std::move(result));
+}
 Polynomial Polynomial::mul_schoolbook(const Polynomial& f, const Polynomial& g) {
     if (f.is_zero() || g.is_zero()) return Polynomial::zero();
     
@@ -158,8 +265,73 @@ Polynomial Polynomial::mul_schoolbook(const Polynomial& f, const Polynomial& g)
     return p;
 }
 
+Polynomial Polynomial::mul_karatsuba(const Polynomial& f, const Polynomial& g) {
+    if (f.is_zero() || g.is_zero()) return Polynomial::zero();
+    
+    const Polynomial& shorter = f.coeffs.size() <= g.coeffs.size() ? f : g;
+    const Polynomial& longer = f.coeffs.size() <= g.coeffs.size() ? g : f;
+    size_t ns = shorter.coeffs.size();
+    size_t nl = longer.coeffs.size();
+    
+    std::vector<Fr> result(ns + nl - 1, Fr());
+    std::vector<Fr> block(ns, Fr());
+    std::vector<Fr> partial(2 * ns - 1, Fr());
+    
+    // Split the longer operand into ns-sized blocks so each product is balanced.
+    for (size_t off = 0; off < nl; off += ns) {
+        size_t len = std::min(ns, nl - off);
+        std::fill(block.begin(), block.end(), Fr());
+        std::copy(longer.coeffs.begin() + off, longer.coeffs.begin() + off + len, block.begin());
+        std::fill(partial.begin(), partial.end(), Fr());
+        
+        karatsuba_rec(block.data(), shorter.coeffs.data(), ns, partial.data());
+        
+        size_t valid = std::min(partial.size(), result.size() - off);
+        for (size_t i = 0; i < valid; ++i) {
+            result[off + i] = result[off + i] + partial[i];
+        }
+    }
+    
+    Polynomial p;
+    p.coeffs = std::move(result);
+    p.normalize();
+    return p;
+}
+
+Polynomial Polynomial::mul_fft(const Polynomial& f, const Polynomial& g) {
+    return FFT::multiply(f, g);
+}
+
+Polynomial Polynomial::mul(const Polynomial& f, const Polynomial& g) {
+    if (f.is_zero() || g.is_zero()) return Polynomial::zero();
+    
+    size_t shorter = std::min(f.coeffs.size(), g.coeffs.size());
+    if (shorter < KARATSUBA_THRESHOLD) return mul_schoolbook(f, g);
+    if (shorter < FFT_THRESHOLD) return mul_karatsuba(f, g);
+    return mul_fft(f, g);
+}
+
 Polynomial Polynomial::square(const Polynomial& f) {
-    return mul_schoolbook(f, f);
+    if (f.is_zero()) return Polynomial::zero();
+    
+    size_t n = f.coeffs.size();
+    if (n >= FFT_THRESHOLD) return FFT::square(f);
+    if (n >= KARATSUBA_THRESHOLD) return mul_karatsuba(f, f);
+    
+    // Schoolbook squaring: cross terms computed once and doubled.
+    std::vector<Fr> result(2 * n - 1, Fr());
+    for (size_t i = 0; i < n; ++i) {
+        result[2 * i] = result[2 * i] + f.coeffs[i].square();
+        Fr twice = f.coeffs[i] + f.coeffs[i];
+        for (size_t j = i + 1; j < n; ++j) {
+            result[i + j] = result[i + j] + twice * f.coeffs[j];
+        }
+    }
+    
+    Polynomial p;
+    p.coeffs = std::move(result);
+    p.normalize();
+    return p;
 }
 Fr Polynomial::eval(const Polynomial& f, const Fr& x) {
     if (f.is_zero() || f.coeffs.empty()) return Fr();
@@ -184,42 +356,193 @@ Polynomial Polynomial::mul_xk(const Polynomial& f, size_t k) {
 void Polynomial::divrem(const Polynomial& N, const Polynomial& D, Polynomial& Q, Polynomial& R) {
     assert(!D.is_zero() && "Divisor cannot be zero");
     
-    Polynomial Ncopy = N;
-    Polynomial Dcopy = D;
-    Ncopy.normalize();
-    Dcopy.normalize();
+    int dn = D.deg();
+    int qn = N.deg() - dn + 1;
+    if (dn >= static_cast<int>(NEWTON_DIVISION_THRESHOLD) &&
+        qn >= static_cast<int>(NEWTON_DIVISION_THRESHOLD)) {
+        size_t nnz = 0;
+        for (const Fr& c : D.coeffs) {
+            if (!c.is_zero()) ++nnz;
+        }
+        if (nnz >= NEWTON_DIVISION_THRESHOLD) {
+            divrem_newton(N, D, Q, R);
+            return;
+        }
+    }
+    
+    divrem_long(N, D, Q, R);
+}
+
+void Polynomial::divrem_long(const Polynomial& N, const Polynomial& D, Polynomial& Q, Polynomial& R) {
+    assert(!D.is_zero() && "Divisor cannot be zero");
+    
+    std::vector<Fr> rem = N.coeffs;
+    while (!rem.empty() && rem.back().is_zero()) rem.pop_back();
+    
+    size_t d_size = D.coeffs.size();
+    while (d_size > 0 && D.coeffs[d_size - 1].is_zero()) --d_size;
     
-    if (Ncopy.deg() < Dcopy.deg()) {
+    if (rem.size() < d_size) {
         Q = Polynomial::zero();
-        R = Ncopy;
+        R.coeffs = std::move(rem);
         return;
     }
     
-    Q = Polynomial::zero();
-    R = Ncopy;
+    size_t dn = d_size - 1;
+    Fr lead_inv = D.coeffs[dn].inverse();
     
-    while (R.deg() >= Dcopy.deg() && !R.is_zero()) {
-        int k = R.deg() - Dcopy.deg();
-        Fr leadR = R.coeffs.back();
-        Fr leadD = Dcopy.coeffs.back();
-        
-        assert(!leadD.is_zero() && "Leading coefficient of divisor cannot be zero");
+    // Only the non-zero lower terms of D take part in each elimination step,
+    // so sparse divisors (e.g. X^n - c) cost O(deg N * nnz(D)).
+    std::vector<std::pair<size_t, Fr>> terms;
+    for (size_t i = 0; i < dn; ++i) {
+        if (!D.coeffs[i].is_zero()) terms.emplace_back(i, D.coeffs[i]);
+    }
+    
+    std::vector<Fr> quot(rem.size() - dn, Fr());
+    for (size_t k = quot.size(); k-- > 0;) {
+        const Fr& top = rem[k + dn];
+        if (top.is_zero()) continue;
         
-        Fr leadD_inv = leadD.inverse();
-        Fr t = leadR * leadD_inv;
+        Fr t = lead_inv.is_one() ? top : top * lead_inv;
+        quot[k] = t;
+        for (const auto& [idx, c] : terms) {
+            rem[k + idx] = rem[k + idx] - t * c;
+        }
+        rem[k + dn] = Fr();
+    }
+    
+    rem.resize(dn);
+    Q.coeffs = std::move(quot);
+    R.coeffs = std::move(rem);
+    Q.normalize();
+    R.normalize();
+}
+
+Polynomial Polynomial::truncate(const Polynomial& f, size_t k) {
+    Polynomial p;
+    p.coeffs.assign(f.coeffs.begin(), f.coeffs.begin() + std::min(k, f.coeffs.size()));
+    p.normalize();
+    return p;
+}
+
+Polynomial Polynomial::reverse(const Polynomial& f, size_t len) {
+    Polynomial p;
+    p.coeffs.assign(len, Fr());
+    for (size_t i = 0; i < len && i < f.coeffs.size(); ++i) {
+        p.coeffs[len - 1 - i] = f.coeffs[i];
+    }
+    p.normalize();
+    return p;
+}
+
+Polynomial Polynomial::inverse_mod_xk(const Polynomial& f, size_t k) {
+    assert(!f.coeff(0).is_zero() && "Constant term must be invertible");
+    if (k == 0) return Polynomial::zero();
+    
+    // Newton iteration: g <- g * (2 - f * g) mod X^(2l), doubling precision each step.
+    Polynomial g({f.coeffs[0].inverse()});
+    for (size_t l = 1; l < k;) {
+        size_t next = std::min(2 * l, k);
+        Polynomial fg = truncate(mul(truncate(f, next), g), next);
         
-        Q.set_coeff(k, Q.coeff(k) + t);
+        Polynomial correction;
+        correction.coeffs.resize(fg.coeffs.size(), Fr());
+        for (size_t i = 0; i < fg.coeffs.size(); ++i) {
+            correction.coeffs[i] = Fr() - fg.coeffs[i];
+        }
+        if (correction.coeffs.empty()) correction.coeffs.push_back(Fr());
+        correction.coeffs[0] = correction.coeffs[0] + Fr(2);
+        correction.normalize();
         
-        Polynomial temp = scalar_mul(Dcopy, t);
-        temp = mul_xk(temp, k);
-        R = sub(R, temp);
-        R.normalize();
+        g = truncate(mul(g, correction), next);
+        l = next;
+    }
+    return g;
+}
+
+void Polynomial::divrem_newton(const Polynomial& N, const Polynomial& D, Polynomial& Q, Polynomial& R) {
+    assert(!D.is_zero() && "Divisor cannot be zero");
+    
+    Polynomial Nn = N;
+    Nn.normalize();
+    Polynomial Dn = D;
+    Dn.normalize();
+    
+    if (Nn.deg() < Dn.deg()) {
+        Q = Polynomial::zero();
+        R = Nn;
+        return;
     }
     
+    // rev(N) = rev(Q) * rev(D) mod X^(m-n+1), with rev(D)(0) = lead(D) != 0.
+    size_t qlen = Nn.coeffs.size() - Dn.coeffs.size() + 1;
+    Polynomial rev_d_inv = inverse_mod_xk(reverse(Dn, Dn.coeffs.size()), qlen);
+    divrem_with_inverse(Nn, Dn, rev_d_inv, Q, R);
+}
+
+void Polynomial::divrem_with_inverse(const Polynomial& N, const Polynomial& D,
+                                     const Polynomial& rev_d_inv, Polynomial& Q, Polynomial& R) {
+    if (N.deg() < D.deg()) {
+        Q = Polynomial::zero();
+        R = N;
+        return;
+    }
+    
+    size_t m = N.coeffs.size();
+    size_t n = D.coeffs.size();
+    size_t qlen = m - n + 1;
+    
+    Polynomial rev_q = truncate(mul(truncate(reverse(N, m), qlen), truncate(rev_d_inv, qlen)), qlen);
+    Polynomial q = reverse(rev_q, qlen);
+    
+    // Only the low n-1 coefficients of N - Q*D can be non-zero.
+    Polynomial qd = truncate(mul(q, D), n - 1);
+    Polynomial r = truncate(N, n - 1);
+    sub_inplace(r, qd);
+    
+    Q = std::move(q);
+    R = std::move(r);
+}
+
+std::pair<Polynomial, Polynomial> Polynomial::divide_by_vanishing(size_t n) const {
+    assert(n > 0 && "Vanishing degree must be positive");
+    
+    if (coeffs.size() <= n) {
+        return {Polynomial::zero(), *this};
+    }
+    
+    // X^n = 1 mod (X^n - 1): fold every coefficient at i >= n down onto i - n,
+    // walking from the top so each fold also carries into the quotient.
+    std::vector<Fr> rem = coeffs;
+    std::vector<Fr> quot(coeffs.size() - n, Fr());
+    for (size_t i = rem.size(); i-- > n;) {
+        quot[i - n] = rem[i];
+        rem[i - n] = rem[i - n] + rem[i];
+    }
+    rem.resize(n);
+    
+    Polynomial Q, R;
+    Q.coeffs = std::move(quot);
+    R.coeffs = std::move(rem);
     Q.normalize();
     R.normalize();
+    return {Q, R};
+}
+
+bool Polynomial::is_subgroup_vanishing(size_t& n) const {
+    if (coeffs.size() < 2) return false;
+    if (!coeffs.back().is_one() || coeffs[0] != Fr(0) - Fr(1)) return false;
+    for (size_t i = 1; i + 1 < coeffs.size(); ++i) {
+        if (!coeffs[i].is_zero()) return false;
+    }
+    n = coeffs.size() - 1;
+    return true;
 }
 Polynomial Polynomial::vanishing(const std::vector<Fr>& points) {
+    if (points.size() >= SUBPRODUCT_TREE_THRESHOLD) {
+        return SubproductTree::cached(points)->vanishing();
+    }
+    
     Polynomial Z = Polynomial::one();
     
     for (const Fr& s : points) {
@@ -268,16 +591,86 @@ Polynomial Polynomial::lagrange_basis(const std::vector<Fr>& pts, size_t j) {
     return scalar_mul(Nj, Dj_inv);
 }
 
+std::vector<Fr> Polynomial::lagrange_basis_at(const std::vector<Fr>& pts, const Fr& x) {
+    size_t m = pts.size();
+    std::vector<Fr> result(m, Fr());
+    if (m == 0) return result;
+    
+    // pts are the m-th roots of unity in order when they are powers of a w with
+    // w^m = 1 and (m a power of two) w^(m/2) != 1. Checked in place, so evaluating
+    // at one point does not build and cache an FFT domain.
+    if (m > 1 && (m & (m - 1)) == 0 && pts[0].is_one()) {
+        bool roots_of_unity = pts[m - 1] * pts[1] == Fr(1) && !pts[m / 2].is_one();
+        for (size_t k = 2; k < m && roots_of_unity; ++k) {
+            roots_of_unity = pts[k] == pts[k - 1] * pts[1];
+        }
+        if (roots_of_unity) return FFT::lagrange_basis_at(pts, x);
+    }
+    
+    for (size_t j = 0; j < m; ++j) {
+        if (pts[j] == x) {
+            result[j] = Fr(1);
+            return result;
+        }
+    }
+    
+    // Barycentric weights w_j = prod_{k!=j} (x_j - x_k). For x_k = x_0 + k*h this is
+    // h^(m-1) * j! * (m-1-j)! * (-1)^(m-1-j), so only factorials are needed.
+    std::vector<Fr> weights(m);
+    Fr h = m > 1 ? pts[1] - pts[0] : Fr(1);
+    bool evenly_spaced = true;
+    for (size_t k = 1; k < m && evenly_spaced; ++k) {
+        evenly_spaced = pts[k] - pts[k - 1] == h;
+    }
+    
+    if (evenly_spaced) {
+        assert(!h.is_zero() && "Duplicate points not allowed");
+        std::vector<Fr> fact(m);
+        fact[0] = Fr(1);
+        for (size_t k = 1; k < m; ++k) {
+            fact[k] = fact[k - 1] * Fr(k);
+        }
+        Fr h_pow = h.pow(static_cast<uint64_t>(m - 1));
+        for (size_t j = 0; j < m; ++j) {
+            Fr w = h_pow * fact[j] * fact[m - 1 - j];
+            weights[j] = ((m - 1 - j) & 1) ? Fr() - w : w;
+        }
+    } else {
+        for (size_t j = 0; j < m; ++j) {
+            Fr w = Fr(1);
+            for (size_t k = 0; k < m; ++k) {
+                if (k != j) w = w * (pts[j] - pts[k]);
+            }
+            assert(!w.is_zero() && "Duplicate points not allowed");
+            weights[j] = w;
+        }
+    }
+    
+    Fr z = Fr(1);
+    for (size_t j = 0; j < m; ++j) {
+        z = z * (x - pts[j]);
+        result[j] = (x - pts[j]) * weights[j];
+    }
+    Fr::batch_inverse(result);
+    for (size_t j = 0; j < m; ++j) {
+        result[j] = z * result[j];
+    }
+    return result;
+}
+
 Polynomial Polynomial::interpolate(const std::vector<Fr>& pts, const std::vector<Fr>& vals) {
     assert(pts.size() == vals.size() && "Points and values size mismatch");
     assert(!pts.empty() && "Cannot interpolate with empty points");
     
+    if (pts.size() >= SUBPRODUCT_TREE_THRESHOLD) {
+        return SubproductTree::cached(pts)->interpolate(vals);
+    }
+    
     Polynomial P = Polynomial::zero();
     
     for (size_t j = 0; j < pts.size(); ++j) {
         Polynomial Lj = lagrange_basis(pts, j);
-        Polynomial term = scalar_mul(Lj, vals[j]);
-        P = add(P, term);
+        axpy(P, vals[j], Lj);
     }
     
     P.normalize();
@@ -325,22 +718,76 @@ bool Polynomial::equals(const Polynomial& other) const {
     b.normalize();
     return a.coeffs == b.coeffs;
 }
-Polynomial Polynomial::operator+(const Polynomial& other) const {
+Polynomial Polynomial::operator+(const Polynomial& other) const & {
     return add(*this, other);
 }
 
-Polynomial Polynomial::operator-(const Polynomial& other) const {
+Polynomial Polynomial::operator+(const Polynomial& other) && {
+    return add(std::move(*this), other);
+}
+
+Polynomial Polynomial::operator+(Polynomial&& other) const & {
+    return add(std::move(other), *this);
+}
+
+Polynomial Polynomial::operator+(Polynomial&& other) && {
+    return coeffs.size() >= other.coeffs.size() ? add(std::move(*this), other)
+                                                : add(std::move(other), *this);
+}
+
+Polynomial Polynomial::operator-(const Polynomial& other) const & {
     return sub(*this, other);
 }
 
+Polynomial Polynomial::operator-(const Polynomial& other) && {
+    return sub(std::move(*this), other);
+}
+
+Polynomial Polynomial::operator-(Polynomial&& other) const & {
+    // this - other = -(other - this), computed in other's buffer
+    for (Fr& c : other.coeffs) {
+        c = Fr() - c;
+    }
+    add_inplace(other, *this);
+    return std::move(other);
+}
+
+Polynomial Polynomial::operator-(Polynomial&& other) && {
+    return sub(std::move(*this), other);
+}
+
 Polynomial Polynomial::operator*(const Polynomial& other) const {
-    return mul_schoolbook(*this, other);
+    return mul(*this, other);
 }
 
-Polynomial Polynomial::operator*(const Fr& scalar) const {
+Polynomial Polynomial::operator*(const Fr& scalar) const & {
     return scalar_mul(*this, scalar);
 }
 
+Polynomial Polynomial::operator*(const Fr& scalar) && {
+    return scalar_mul(std::move(*this), scalar);
+}
+
+Polynomial& Polynomial::operator+=(const Polynomial& other) {
+    add_inplace(*this, other);
+    return *this;
+}
+
+Polynomial& Polynomial::operator-=(const Polynomial& other) {
+    sub_inplace(*this, other);
+    return *this;
+}
+
+Polynomial& Polynomial::operator*=(const Polynomial& other) {
+    *this = mul(*this, other);
+    return *this;
+}
+
+Polynomial& Polynomial::operator*=(const Fr& scalar) {
+    scalar_mul_inplace(*this, scalar);
+    return *this;
+}
+
 bool Polynomial::operator==(const Polynomial& other) const {
     return equals(other);
 }
@@ -349,6 +796,10 @@ Fr Polynomial::evaluate(const Fr& x) const {
 }
 
 std::vector<Fr> Polynomial::evaluate_batch(const std::vector<Fr>& x_vec) const {
+    if (x_vec.size() >= SUBPRODUCT_EVAL_THRESHOLD && coeffs.size() >= SUBPRODUCT_EVAL_THRESHOLD) {
+        return SubproductTree::cached(x_vec)->evaluate(*this);
+    }
+    
     std::vector<Fr> result;
     result.reserve(x_vec.size());
     for (const Fr& x : x_vec) {
@@ -1,6 +1,8 @@
 #include "zkmini/qap.hpp"
 #include "zkmini/utils.hpp"
+#include "zkmini/eval_poly.hpp"
 #include <stdexcept>
+#include <algorithm>
 
 namespace zkmini {
 
@@ -10,11 +12,7 @@ QAP r1cs_to_qap(const R1CS& r) {
     
     QAP q(m, n);
     
-    q.domain_points.clear();
-    q.domain_points.reserve(m);
-    for (size_t i = 0; i < m; ++i) {
-        q.domain_points.push_back(Fr(i + 1));
-    }
+    q.domain_points = qap_domain_points(m);
     
     for (size_t i = 0; i < n; ++i) {
         std::vector<Fr> vals_A = r.column_values(r.A, i);
@@ -31,6 +29,68 @@ QAP r1cs_to_qap(const R1CS& r) {
     return q;
 }
 
+namespace {
+
+// out[col] += coeff * weights[row] over every entry of M
+void scatter_rows(const SparseMatrix& M, const std::vector<Fr>& weights, std::vector<Fr>& out) {
+    for (size_t k = 0; k < M.num_rows(); ++k) {
+        const Fr& w = weights[k];
+        if (w.is_zero()) continue;
+        for (size_t e = M.row_begin(k); e < M.row_end(k); ++e) {
+            Fr& dst = out[M.col(e)];
+            uint32_t magnitude = M.small_magnitude(e);
+            if (magnitude != 0) {
+                Fr t = magnitude == 1 ? w : w.mul_small(magnitude);
+                dst = M.is_negative(e) ? dst - t : dst + t;
+            } else {
+                dst = dst + M.coeff(e) * w;
+            }
+        }
+    }
+}
+
+}
+
+std::vector<Fr> qap_domain_points(size_t m) {
+    std::vector<Fr> points;
+    points.reserve(m);
+    for (size_t i = 0; i < m; ++i) {
+        points.push_back(Fr(i + 1));
+    }
+    return points;
+}
+
+QAPBasisEvaluation qap_basis_at(const R1CS& r, const std::vector<Fr>& domain_points, const Fr& tau) {
+    ZK_ASSERT(domain_points.size() == r.num_constraints(), "Domain size must match constraint count");
+    
+    std::vector<Fr> lagrange = Polynomial::lagrange_basis_at(domain_points, tau);
+    
+    QAPBasisEvaluation result;
+    result.A.assign(r.num_variables(), Fr());
+    result.B.assign(r.num_variables(), Fr());
+    result.C.assign(r.num_variables(), Fr());
+    
+    if (r.is_finalized()) {
+        scatter_rows(r.A_csr, lagrange, result.A);
+        scatter_rows(r.B_csr, lagrange, result.B);
+        scatter_rows(r.C_csr, lagrange, result.C);
+    } else {
+        for (size_t k = 0; k < r.num_constraints(); ++k) {
+            const Fr& l = lagrange[k];
+            if (l.is_zero()) continue;
+            for (const auto& term : r.A[k]) result.A[term.idx] = result.A[term.idx] + term.coeff * l;
+            for (const auto& term : r.B[k]) result.B[term.idx] = result.B[term.idx] + term.coeff * l;
+            for (const auto& term : r.C[k]) result.C[term.idx] = result.C[term.idx] + term.coeff * l;
+        }
+    }
+    
+    result.Z = Fr(1);
+    for (const Fr& x : domain_points) {
+        result.Z = result.Z * (tau - x);
+    }
+    return result;
+}
+
 Polynomial assemble_A(const QAP& q, const std::vector<Fr>& x) {
     ZK_ASSERT(x.size() == q.n, "Witness size mismatch");
     ZK_ASSERT(!x.empty() && x[0] == Fr(1), "First element must be 1");
@@ -39,8 +99,7 @@ Polynomial assemble_A(const QAP& q, const std::vector<Fr>& x) {
     
     for (size_t i = 0; i < q.n; ++i) {
         if (!x[i].is_zero()) {
-            Polynomial term = Polynomial::scalar_mul(q.A_basis[i], x[i]);
-            Polynomial::add_inplace(result, term);
+            Polynomial::axpy(result, x[i], q.A_basis[i]);
         }
     }
     
@@ -56,8 +115,7 @@ Polynomial assemble_B(const QAP& q, const std::vector<Fr>& x) {
     
     for (size_t i = 0; i < q.n; ++i) {
         if (!x[i].is_zero()) {
-            Polynomial term = Polynomial::scalar_mul(q.B_basis[i], x[i]);
-            Polynomial::add_inplace(result, term);
+            Polynomial::axpy(result, x[i], q.B_basis[i]);
         }
     }
     
@@ -73,8 +131,7 @@ Polynomial assemble_C(const QAP& q, const std::vector<Fr>& x) {
     
     for (size_t i = 0; i < q.n; ++i) {
         if (!x[i].is_zero()) {
-            Polynomial term = Polynomial::scalar_mul(q.C_basis[i], x[i]);
-            Polynomial::add_inplace(result, term);
+            Polynomial::axpy(result, x[i], q.C_basis[i]);
         }
     }
     
@@ -94,8 +151,8 @@ bool divides(const Polynomial& N, const Polynomial& D) {
 
 Polynomial compute_H(const Polynomial& A, const Polynomial& B, 
                     const Polynomial& C, const Polynomial& Z) {
-    Polynomial AB = Polynomial::mul_schoolbook(A, B);
-    Polynomial numerator = Polynomial::sub(AB, C);
+    Polynomial AB = Polynomial::mul(A, B);
+    Polynomial numerator = Polynomial::sub(std::move(AB), C);
     
     Polynomial H, remainder;
     Polynomial::divrem(numerator, Z, H, remainder);
@@ -113,8 +170,16 @@ bool qap_check(const QAP& q, const std::vector<Fr>& x) {
         Polynomial B = assemble_B(q, x);
         Polynomial C = assemble_C(q, x);
         
-        Polynomial AB = Polynomial::mul_schoolbook(A, B);
-        Polynomial numerator = Polynomial::sub(AB, C);
+        // Over a subgroup domain Z | A*B - C iff A*B == C at every root of unity.
+        size_t n;
+        if (q.Z.is_subgroup_vanishing(n) && BitUtils::is_power_of_two(n) &&
+            A.coeffs.size() <= n && B.coeffs.size() <= n && C.coeffs.size() <= n) {
+            std::vector<EvalPoly> evals = EvalPoly::from_polynomials({A, B, C}, n);
+            return evals[0] * evals[1] == evals[2];
+        }
+        
+        Polynomial AB = Polynomial::mul(A, B);
+        Polynomial numerator = Polynomial::sub(std::move(AB), C);
         
         return divides(numerator, q.Z);
     } catch (...) {
@@ -122,13 +187,103 @@ bool qap_check(const QAP& q, const std::vector<Fr>& x) {
     }
 }
 
+SparseQAP r1cs_to_sparse_qap(const R1CS& r) {
+    SparseQAP q;
+    q.m = r.num_constraints();
+    q.n = r.num_variables();
+    q.domain_size = BitUtils::next_power_of_two(std::max<size_t>(q.m, 1));
+    if (r.is_finalized()) {
+        q.A = r.A_csr;
+        q.B = r.B_csr;
+        q.C = r.C_csr;
+    } else {
+        q.A = R1CS::build_csr(r.A, q.n);
+        q.B = R1CS::build_csr(r.B, q.n);
+        q.C = R1CS::build_csr(r.C, q.n);
+    }
+    q.public_indices = r.public_inputs();
+    return q;
+}
+
+std::vector<std::vector<Fr>> sparse_qap_evaluations(const SparseQAP& q, const std::vector<Fr>& x) {
+    ZK_ASSERT(x.size() == q.n, "Witness size mismatch");
+    ZK_ASSERT(!x.empty() && x[0] == Fr(1), "First element must be 1");
+    
+    std::vector<std::vector<Fr>> evals(3, std::vector<Fr>(q.domain_size, Fr()));
+    R1CS::evaluate_rows(q.A, q.B, q.C, x, evals[0], evals[1], evals[2]);
+    return evals;
+}
+
+std::tuple<Polynomial, Polynomial, Polynomial> sparse_qap_polynomials(const SparseQAP& q,
+                                                                     const std::vector<Fr>& x) {
+    std::vector<std::vector<Fr>> evals = sparse_qap_evaluations(q, x);
+    q.fft().ifft_batch(evals);
+    return {Polynomial(std::move(evals[0])), Polynomial(std::move(evals[1])),
+            Polynomial(std::move(evals[2]))};
+}
+
+QAPBasisEvaluation qap_basis_at(const SparseQAP& q, const Fr& tau) {
+    std::vector<Fr> lagrange = q.fft().lagrange_basis_at(tau);
+    
+    QAPBasisEvaluation result;
+    result.A.assign(q.n, Fr());
+    result.B.assign(q.n, Fr());
+    result.C.assign(q.n, Fr());
+    
+    scatter_rows(q.A, lagrange, result.A);
+    scatter_rows(q.B, lagrange, result.B);
+    scatter_rows(q.C, lagrange, result.C);
+    
+    result.Z = tau.pow(static_cast<uint64_t>(q.domain_size)) - Fr(1);
+    return result;
+}
+
+bool qap_check(const SparseQAP& q, const std::vector<Fr>& x) {
+    // Z | A*B - C exactly when A*B == C at every domain point, i.e. row by row.
+    if (x.size() != q.n || x.empty() || x[0] != Fr(1)) return false;
+    
+    std::vector<Fr> az, bz, cz;
+    R1CS::evaluate_rows(q.A, q.B, q.C, x, az, bz, cz);
+    return R1CS::first_unsatisfied_row(az, bz, cz, q.m) == q.m;
+}
+
+// H = (A*B - C) / Z without ever forming A*B: Az, Bz, Cz are A, B, C on the subgroup;
+// one IFFT and one coset FFT move each onto g*H where Z is the constant g^n - 1, the
+// quotient is taken pointwise there, and a coset IFFT returns its coefficients.
+Polynomial compute_H(const SparseQAP& q, const std::vector<Fr>& x) {
+    std::vector<std::vector<Fr>> evals = sparse_qap_evaluations(q, x);
+    std::vector<Fr>& a = evals[0];
+    std::vector<Fr>& b = evals[1];
+    std::vector<Fr>& c = evals[2];
+    
+    // Exactness of the division is A*B == C on the subgroup itself.
+    ZK_ASSERT(R1CS::first_unsatisfied_row(a, b, c, q.m) == q.m, "H polynomial division must be exact");
+    
+    // The batched transforms run the three IFFT / coset-FFT pairs together, each
+    // butterfly stage split across threads once for all three vectors.
+    const FFT& fft = q.fft();
+    fft.ifft_batch(evals);
+    fft.fft_batch(evals, true);
+    
+    Fr z_inv = fft.vanishing_on_coset().inverse();
+    Parallel::parallel_for(0, q.domain_size, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            a[i] = (a[i] * b[i] - c[i]) * z_inv;
+        }
+    }, 1 << 12);
+    
+    std::vector<Fr> h = fft.coset_ifft(a);
+    ZK_ASSERT(h.back().is_zero(), "H polynomial degree must be below domain_size - 1");
+    return Polynomial(std::move(h));
+}
+
 std::pair<Polynomial, Polynomial> qap_num_den(const QAP& q, const std::vector<Fr>& x) {
     Polynomial A = assemble_A(q, x);
     Polynomial B = assemble_B(q, x);
     Polynomial C = assemble_C(q, x);
     
-    Polynomial AB = Polynomial::mul_schoolbook(A, B);
-    Polynomial numerator = Polynomial::sub(AB, C);
+    Polynomial AB = Polynomial::mul(A, B);
+    Polynomial numerator = Polynomial::sub(std::move(AB), C);
     
     return {numerator, q.Z};
 }
@@ -1,13 +1,16 @@
 #include "zkmini/r1cs.hpp"
 #include "zkmini/utils.hpp"
-#include "zkmini/serialization.hpp"
+#include "zkmini/byte_io.hpp"
 #include <sstream>
 #include <algorithm>
-#include <unordered_map>
+#include <atomic>
+#include <stdexcept>
 
 namespace zkmini {
 
-R1CS::R1CS(size_t n_vars_hint) : n_vars(1), n_cons(0), next_var(1) {
+R1CS::R1CS(size_t n_vars_hint)
+    : n_vars(1), n_cons(0), next_var(1), finalized(false), csc_built(false),
+      rows_materialized(true) {
     
     if (n_vars_hint > 1) {
         n_vars = n_vars_hint;
@@ -17,7 +20,9 @@ R1CS::R1CS(size_t n_vars_hint) : n_vars(1), n_cons(0), next_var(1) {
 VarIdx R1CS::allocate_var() {
     VarIdx var = next_var++;
     if (var >= n_vars) {
+        materialize_rows();
         n_vars = next_var;
+        finalized = false;
     }
     return var;
 }
@@ -53,55 +58,180 @@ void R1CS::lc_add_term(LinearCombination& L, VarIdx i, const Fr& c) {
     L.push_back(Term(i, c));
 }
 
-void R1CS::lc_compress(LinearCombination& L) {
-    if (L.empty()) return;
-    
-    
-    std::unordered_map<VarIdx, Fr> coeff_map;
-    for (const auto& term : L) {
-        coeff_map[term.idx] = coeff_map[term.idx] + term.coeff;
+namespace {
+
+// Rows emitted by circuit builders are short and usually already ordered, where
+// insertion sort beats std::sort's setup.
+constexpr size_t INSERTION_SORT_MAX = 16;
+
+}
+
+Term* R1CS::compress_terms(Term* begin, Term* end) {
+    if (begin == end) return end;
+    
+    auto by_idx = [](const Term& a, const Term& b) { return a.idx < b.idx; };
+    size_t len = end - begin;
+    if (len <= INSERTION_SORT_MAX) {
+        for (Term* i = begin + 1; i < end; ++i) {
+            if (!(i->idx < (i - 1)->idx)) continue;
+            Term t = *i;
+            Term* j = i;
+            for (; j > begin && t.idx < (j - 1)->idx; --j) {
+                *j = *(j - 1);
+            }
+            *j = t;
+        }
+    } else if (!std::is_sorted(begin, end, by_idx)) {
+        std::sort(begin, end, by_idx);
     }
     
-    
-    L.clear();
-    for (const auto& pair : coeff_map) {
-        if (pair.second != Fr(0)) {
-            L.push_back(Term(pair.first, pair.second));
+    Term* out = begin;
+    for (Term* i = begin; i < end;) {
+        Fr sum = i->coeff;
+        VarIdx idx = i->idx;
+        for (++i; i < end && i->idx == idx; ++i) {
+            sum += i->coeff;
+        }
+        if (!sum.is_zero()) {
+            out->idx = idx;
+            out->coeff = sum;
+            ++out;
         }
     }
-    
-    
-    std::sort(L.begin(), L.end(), [](const Term& a, const Term& b) {
-        return a.idx < b.idx;
-    });
+    return out;
+}
+
+void R1CS::lc_compress(LinearCombination& L) {
+    Term* end = compress_terms(L.data(), L.data() + L.size());
+    L.erase(L.begin() + (end - L.data()), L.end());
+}
+
+void ConstraintBatch::reserve(size_t constraints, size_t num_terms) {
+    row_ends.reserve(3 * constraints);
+    terms.reserve(num_terms);
+}
+
+void ConstraintBatch::append_row(const LinearCombination& L) {
+    terms.insert(terms.end(), L.begin(), L.end());
+    row_ends.push_back(terms.size());
+}
+
+void ConstraintBatch::add(const LinearCombination& a, const LinearCombination& b,
+                          const LinearCombination& c) {
+    append_row(a);
+    append_row(b);
+    append_row(c);
 }
+
+void ConstraintBatch::clear() {
+    terms.clear();
+    row_ends.clear();
+}
+
 void R1CS::add_constraint(const LinearCombination& A_row,
                          const LinearCombination& B_row, 
                          const LinearCombination& C_row) {
-    
-    LinearCombination a_compressed = A_row;
-    LinearCombination b_compressed = B_row;
-    LinearCombination c_compressed = C_row;
-    
-    lc_compress(a_compressed);
-    lc_compress(b_compressed);
-    lc_compress(c_compressed);
+    add_constraint(LinearCombination(A_row), LinearCombination(B_row), LinearCombination(C_row));
+}
+
+void R1CS::add_constraint(LinearCombination&& A_row,
+                         LinearCombination&& B_row,
+                         LinearCombination&& C_row) {
+    materialize_rows();
+    lc_compress(A_row);
+    lc_compress(B_row);
+    lc_compress(C_row);
     
     
-    for (const auto& term : a_compressed) {
+    for (const auto& term : A_row) {
         ZK_ASSERT(term.idx < n_vars, "Variable index out of bounds in A row");
     }
-    for (const auto& term : b_compressed) {
+    for (const auto& term : B_row) {
         ZK_ASSERT(term.idx < n_vars, "Variable index out of bounds in B row");
     }
-    for (const auto& term : c_compressed) {
+    for (const auto& term : C_row) {
         ZK_ASSERT(term.idx < n_vars, "Variable index out of bounds in C row");
     }
     
-    A.push_back(a_compressed);
-    B.push_back(b_compressed);
-    C.push_back(c_compressed);
+    A.push_back(std::move(A_row));
+    B.push_back(std::move(B_row));
+    C.push_back(std::move(C_row));
     n_cons++;
+    finalized = false;
+}
+
+void R1CS::add_constraints(ConstraintBatch& batch) {
+    size_t count = batch.size();
+    if (count == 0) return;
+    
+    // A finalized (or empty) system takes the rows straight into its CSR copies and
+    // leaves A/B/C to materialize_rows(), so no per-row vector is allocated.
+    bool append_csr = (finalized && !A_csr.is_view()) || n_cons == 0;
+    if (!append_csr) materialize_rows();
+    
+    // Compress each row where it sits, then slide it down over the gaps left by
+    // merged terms so the arena stays contiguous.
+    Term* base = batch.terms.data();
+    size_t read = 0;
+    size_t write = 0;
+    for (size_t r = 0; r < batch.row_ends.size(); ++r) {
+        size_t row_end = batch.row_ends[r];
+        Term* end = compress_terms(base + read, base + row_end);
+        for (Term* t = base + read; t < end; ++t) {
+            ZK_ASSERT(t->idx < n_vars, "Variable index out of bounds in batched constraint");
+            if (write != read) base[write + (t - (base + read))] = *t;
+        }
+        write += end - (base + read);
+        read = row_end;
+        batch.row_ends[r] = write;
+    }
+    batch.terms.erase(batch.terms.begin() + write, batch.terms.end());
+    
+    if (n_cons == 0) {
+        A_csr = SparseMatrix(n_vars);
+        B_csr = SparseMatrix(n_vars);
+        C_csr = SparseMatrix(n_vars);
+    }
+    
+    size_t begin = 0;
+    if (append_csr) {
+        // The CSR copies hold every row, so the row vectors are dropped rather than
+        // kept half up to date.
+        if (rows_materialized) {
+            std::vector<LinearCombination>().swap(A);
+            std::vector<LinearCombination>().swap(B);
+            std::vector<LinearCombination>().swap(C);
+            rows_materialized = false;
+        }
+        SparseMatrix* csrs[3] = {&A_csr, &B_csr, &C_csr};
+        for (auto* csr : csrs) csr->reserve(csr->num_rows() + count, csr->nnz() + write);
+        for (size_t r = 0; r < batch.row_ends.size(); ++r) {
+            size_t end = batch.row_ends[r];
+            SparseMatrix& csr = *csrs[r % 3];
+            for (size_t t = begin; t < end; ++t) {
+                csr.push_term(batch.terms[t].idx, batch.terms[t].coeff);
+            }
+            csr.close_row();
+            begin = end;
+        }
+    } else {
+        std::vector<LinearCombination>* mats[3] = {&A, &B, &C};
+        for (auto* M : mats) M->reserve(M->size() + count);
+        for (size_t r = 0; r < batch.row_ends.size(); ++r) {
+            size_t end = batch.row_ends[r];
+            mats[r % 3]->emplace_back(batch.terms.begin() + begin, batch.terms.begin() + end);
+            begin = end;
+        }
+    }
+    n_cons += count;
+    
+    finalized = append_csr;
+    if (csc_built) {
+        A_csc.clear();
+        B_csc.clear();
+        C_csc.clear();
+        csc_built = false;
+    }
 }
 void R1CS::add_mul(VarIdx a, VarIdx b, VarIdx c) {
     add_constraint(lc_var(a), lc_var(b), lc_var(c));
@@ -115,30 +245,114 @@ void R1CS::add_lin_eq(const LinearCombination& L, const LinearCombination& R) {
     
     add_constraint(L, lc_const(Fr(1)), R);
 }
+namespace {
+
+constexpr size_t MIN_PARALLEL_ROWS = 256;
+
+// +-1 and other small coefficients are applied with additions and Fr::mul_small;
+// only the remaining terms go through the accumulator.
+Fr dot_row(const LinearCombination& L, const std::vector<Fr>& x) {
+    Fr cheap;
+    Fr::MulAccumulator acc;
+    size_t products = 0;
+    const Term* last_product = nullptr;
+    
+    for (const auto& term : L) {
+        const Fr& v = x[term.idx];
+        uint32_t magnitude;
+        bool negative;
+        if (term.coeff.as_small(magnitude, negative)) {
+            Fr t = magnitude == 1 ? v : v.mul_small(magnitude);
+            cheap = negative ? cheap - t : cheap + t;
+        } else {
+            if (products == 1) acc.add_product(last_product->coeff, x[last_product->idx]);
+            if (products >= 1) acc.add_product(term.coeff, v);
+            last_product = &term;
+            ++products;
+        }
+    }
+    
+    if (products == 0) return cheap;
+    if (products == 1) return cheap + last_product->coeff * x[last_product->idx];
+    return cheap + acc.result();
+}
+
+}
+
 Fr R1CS::eval_lc(const LinearCombination& L, const std::vector<Fr>& x) {
-    Fr result = Fr(0);
     for (const auto& term : L) {
         ZK_ASSERT(term.idx < x.size(), "Variable index out of bounds in evaluation");
-        result = result + (term.coeff * x[term.idx]);
     }
-    return result;
+    return dot_row(L, x);
 }
 
-bool R1CS::is_satisfied(const std::vector<Fr>& x) const {
+void R1CS::evaluate_rows(const SparseMatrix& A_rows,
+                         const SparseMatrix& B_rows,
+                         const SparseMatrix& C_rows,
+                         const std::vector<Fr>& x,
+                         std::vector<Fr>& az, std::vector<Fr>& bz, std::vector<Fr>& cz) {
+    size_t rows = A_rows.num_rows();
+    ZK_ASSERT(B_rows.num_rows() == rows && C_rows.num_rows() == rows, "Matrix row counts differ");
+    ZK_ASSERT(x.size() >= A_rows.num_cols() && x.size() >= B_rows.num_cols() &&
+              x.size() >= C_rows.num_cols(), "Witness shorter than matrix width");
+    if (az.size() < rows) az.resize(rows);
+    if (bz.size() < rows) bz.resize(rows);
+    if (cz.size() < rows) cz.resize(rows);
+    
+    Parallel::parallel_for(0, rows, [&](size_t lo, size_t hi) {
+        for (size_t k = lo; k < hi; ++k) {
+            az[k] = A_rows.row_dot(k, x);
+            bz[k] = B_rows.row_dot(k, x);
+            cz[k] = C_rows.row_dot(k, x);
+        }
+    }, MIN_PARALLEL_ROWS);
+}
+
+void R1CS::evaluate_rows(const std::vector<Fr>& x,
+                         std::vector<Fr>& az, std::vector<Fr>& bz, std::vector<Fr>& cz) const {
     ZK_ASSERT(x.size() == n_vars, "Wrong witness size");
-    ZK_ASSERT(x[0] == Fr(1), "x[0] must be 1");
+    if (finalized) {
+        evaluate_rows(A_csr, B_csr, C_csr, x, az, bz, cz);
+        return;
+    }
     
-    for (size_t k = 0; k < n_cons; ++k) {
-        Fr L = eval_lc(A[k], x);
-        Fr R = eval_lc(B[k], x);
-        Fr O = eval_lc(C[k], x);
-        
-        if (!((L * R) == O)) {
-            return false;
+    if (az.size() < n_cons) az.resize(n_cons);
+    if (bz.size() < n_cons) bz.resize(n_cons);
+    if (cz.size() < n_cons) cz.resize(n_cons);
+    
+    Parallel::parallel_for(0, n_cons, [&](size_t lo, size_t hi) {
+        for (size_t k = lo; k < hi; ++k) {
+            az[k] = dot_row(A[k], x);
+            bz[k] = dot_row(B[k], x);
+            cz[k] = dot_row(C[k], x);
         }
-    }
+    }, MIN_PARALLEL_ROWS);
+}
+
+size_t R1CS::first_unsatisfied_row(const std::vector<Fr>& az, const std::vector<Fr>& bz,
+                                   const std::vector<Fr>& cz, size_t rows) {
+    std::atomic<size_t> first(rows);
+    
+    Parallel::parallel_for(0, rows, [&](size_t lo, size_t hi) {
+        for (size_t k = lo; k < hi && k < first.load(std::memory_order_relaxed); ++k) {
+            if (az[k] * bz[k] != cz[k]) {
+                size_t seen = first.load(std::memory_order_relaxed);
+                while (k < seen && !first.compare_exchange_weak(seen, k)) {}
+                return;
+            }
+        }
+    }, MIN_PARALLEL_ROWS);
     
-    return true;
+    return first.load();
+}
+
+bool R1CS::is_satisfied(const std::vector<Fr>& x) const {
+    ZK_ASSERT(x.size() == n_vars, "Wrong witness size");
+    ZK_ASSERT(x[0] == Fr(1), "x[0] must be 1");
+    
+    std::vector<Fr> az, bz, cz;
+    evaluate_rows(x, az, bz, cz);
+    return first_unsatisfied_row(az, bz, cz, n_cons) == n_cons;
 }
 
 bool R1CS::is_satisfied_verbose(const std::vector<Fr>& x, size_t& first_bad_row, 
@@ -146,25 +360,43 @@ bool R1CS::is_satisfied_verbose(const std::vector<Fr>& x, size_t& first_bad_row,
     ZK_ASSERT(x.size() == n_vars, "Wrong witness size");
     ZK_ASSERT(x[0] == Fr(1), "x[0] must be 1");
     
-    for (size_t k = 0; k < n_cons; ++k) {
-        Fr L = eval_lc(A[k], x);
-        Fr R = eval_lc(B[k], x);
-        Fr O = eval_lc(C[k], x);
-        
-        if (!((L * R) == O)) {
-            first_bad_row = k;
-            L_val = L;
-            R_val = R;
-            O_val = O;
-            return false;
-        }
-    }
+    std::vector<Fr> az, bz, cz;
+    evaluate_rows(x, az, bz, cz);
     
-    return true;
+    size_t k = first_unsatisfied_row(az, bz, cz, n_cons);
+    if (k == n_cons) return true;
+    
+    first_bad_row = k;
+    L_val = az[k];
+    R_val = bz[k];
+    O_val = cz[k];
+    return false;
 }
 std::vector<Fr> R1CS::column_values(const std::vector<LinearCombination>& M, VarIdx col) const {
     std::vector<Fr> vals(n_cons, Fr(0));
     
+    const SparseMatrix* csc = nullptr;
+    if (has_csc()) {
+        if (&M == &A) csc = &A_csc;
+        else if (&M == &B) csc = &B_csc;
+        else if (&M == &C) csc = &C_csc;
+    }
+    if (csc) {
+        for (size_t e = csc->row_begin(col); e < csc->row_end(col); ++e) {
+            vals[csc->col(e)] = csc->coeff(e);
+        }
+        return vals;
+    }
+    if (!rows_materialized) {
+        const SparseMatrix& csr = csr_of(M);
+        for (size_t k = 0; k < n_cons; ++k) {
+            for (size_t e = csr.row_begin(k); e < csr.row_end(k); ++e) {
+                if (csr.col(e) == col) vals[k] = csr.coeff(e);
+            }
+        }
+        return vals;
+    }
+    
     for (size_t k = 0; k < n_cons; ++k) {
         for (const auto& term : M[k]) {
             if (term.idx == col) {
@@ -176,25 +408,84 @@ std::vector<Fr> R1CS::column_values(const std::vector<LinearCombination>& M, Var
     
     return vals;
 }
-void R1CS::finalize() {
+SparseMatrix R1CS::build_csr(const std::vector<LinearCombination>& M, size_t n_cols) {
+    size_t nnz = 0;
+    for (const auto& row : M) nnz += row.size();
     
-    for (auto& lc : A) {
-        lc_compress(lc);
-        lc.shrink_to_fit();
-    }
-    for (auto& lc : B) {
-        lc_compress(lc);
-        lc.shrink_to_fit();
+    SparseMatrix csr(n_cols);
+    csr.reserve(M.size(), nnz);
+    for (const auto& row : M) {
+        for (const auto& term : row) {
+            csr.push_term(term.idx, term.coeff);
+        }
+        csr.close_row();
     }
-    for (auto& lc : C) {
-        lc_compress(lc);
-        lc.shrink_to_fit();
+    return csr;
+}
+
+const SparseMatrix& R1CS::csr_of(const std::vector<LinearCombination>& M) const {
+    ZK_ASSERT(&M == &A || &M == &B || &M == &C, "Not one of this system's matrices");
+    return &M == &A ? A_csr : &M == &B ? B_csr : C_csr;
+}
+
+size_t R1CS::row_size(const std::vector<LinearCombination>& M, size_t k) const {
+    if (rows_materialized) return M[k].size();
+    const SparseMatrix& csr = csr_of(M);
+    return csr.row_end(k) - csr.row_begin(k);
+}
+
+void R1CS::materialize_rows() {
+    if (rows_materialized) return;
+    
+    A.assign(n_cons, LinearCombination());
+    B.assign(n_cons, LinearCombination());
+    C.assign(n_cons, LinearCombination());
+    Parallel::parallel_for(0, n_cons, [&](size_t lo, size_t hi) {
+        for (size_t k = lo; k < hi; ++k) {
+            for (auto pair : {std::make_pair(&A_csr, &A[k]), std::make_pair(&B_csr, &B[k]),
+                              std::make_pair(&C_csr, &C[k])}) {
+                const SparseMatrix& M = *pair.first;
+                LinearCombination& row = *pair.second;
+                row.reserve(M.row_end(k) - M.row_begin(k));
+                for (size_t e = M.row_begin(k); e < M.row_end(k); ++e) {
+                    row.push_back(Term(M.col(e), M.coeff(e)));
+                }
+            }
+        }
+    }, MIN_PARALLEL_ROWS);
+    rows_materialized = true;
+}
+
+void R1CS::finalize(bool build_csc) {
+    // The CSR copies become the only copy: the 40-byte row terms are released once
+    // they are interned, and materialize_rows() brings them back on demand. Without
+    // rows the CSR copies are already current.
+    if (rows_materialized) {
+        for (auto* M : {&A, &B, &C}) {
+            for (auto& lc : *M) lc_compress(lc);
+        }
+        A_csr = build_csr(A, n_vars);
+        B_csr = build_csr(B, n_vars);
+        C_csr = build_csr(C, n_vars);
+        
+        std::vector<LinearCombination>().swap(A);
+        std::vector<LinearCombination>().swap(B);
+        std::vector<LinearCombination>().swap(C);
+        rows_materialized = false;
     }
-    
-    A.shrink_to_fit();
-    B.shrink_to_fit();
-    C.shrink_to_fit();
     public_indices.shrink_to_fit();
+    
+    csc_built = build_csc;
+    if (build_csc) {
+        A_csc = A_csr.transpose();
+        B_csc = B_csr.transpose();
+        C_csc = C_csr.transpose();
+    } else {
+        A_csc.clear();
+        B_csc.clear();
+        C_csc.clear();
+    }
+    finalized = true;
 }
 
 std::string R1CS::debug_row(size_t k) const {
@@ -202,26 +493,23 @@ std::string R1CS::debug_row(size_t k) const {
     
     std::stringstream ss;
     ss << "Constraint " << k << ":\n";
+    auto print_term = [&](VarIdx idx, const Fr& coeff) {
+        ss << "(" << idx << "," << coeff.to_string() << ") ";
+    };
     
     
     ss << "  A[" << k << "]: ";
-    for (const auto& term : A[k]) {
-        ss << "(" << term.idx << "," << term.coeff.to_string() << ") ";
-    }
+    for_each_term(A, k, print_term);
     ss << "\n";
     
     
     ss << "  B[" << k << "]: ";
-    for (const auto& term : B[k]) {
-        ss << "(" << term.idx << "," << term.coeff.to_string() << ") ";
-    }
+    for_each_term(B, k, print_term);
     ss << "\n";
     
     
     ss << "  C[" << k << "]: ";
-    for (const auto& term : C[k]) {
-        ss << "(" << term.idx << "," << term.coeff.to_string() << ") ";
-    }
+    for_each_term(C, k, print_term);
     ss << "\n";
     
     return ss.str();
@@ -257,57 +545,55 @@ std::vector<Fr> R1CS::generate_full_assignment(const std::vector<Fr>& public_inp
     
     return full_assignment;
 }
+namespace {
+
+// Row count, then per row its term count and (u64 index, 32-byte coefficient) terms.
+size_t matrix_bytes(const R1CS& r, const std::vector<LinearCombination>& M) {
+    size_t bytes = 8;
+    for (size_t k = 0; k < r.num_constraints(); ++k) bytes += 8 + 40 * r.row_size(M, k);
+    return bytes;
+}
+
+}
+
 std::vector<uint8_t> R1CS::serialize() const {
-    std::vector<uint8_t> result;
-    
-    
-    Serialization::write_uint64(result, n_vars);
-    Serialization::write_uint64(result, n_cons);
-    
-    
-    auto A_data = serialize_matrix(A);
-    auto B_data = serialize_matrix(B);
-    auto C_data = serialize_matrix(C);
-    
-    Serialization::write_uint64(result, A_data.size());
-    result.insert(result.end(), A_data.begin(), A_data.end());
-    
-    Serialization::write_uint64(result, B_data.size());
-    result.insert(result.end(), B_data.begin(), B_data.end());
-    
-    Serialization::write_uint64(result, C_data.size());
-    result.insert(result.end(), C_data.begin(), C_data.end());
+    // Every size is known up front, so the buffer is allocated once and each
+    // matrix goes in behind its exact byte count.
+    size_t sizes[3] = {matrix_bytes(*this, A), matrix_bytes(*this, B), matrix_bytes(*this, C)};
+    ByteWriter out(16 + 3 * 8 + sizes[0] + sizes[1] + sizes[2]);
+    
+    out.put_u64(n_vars);
+    out.put_u64(n_cons);
+    
+    const std::vector<std::vector<Term>>* matrices[3] = {&A, &B, &C};
+    for (size_t m = 0; m < 3; ++m) {
+        out.put_u64(sizes[m]);
+        serialize_matrix(out, *matrices[m]);
+    }
     
-    return result;
+    return out.take();
 }
 
 R1CS R1CS::deserialize(const std::vector<uint8_t>& data) {
-    size_t offset = 0;
+    ByteReader in(data);
     
-    
-    uint64_t n_vars = Serialization::read_uint64(data, offset);
-    uint64_t n_cons = Serialization::read_uint64(data, offset);
+    uint64_t n_vars = in.get_u64();
+    uint64_t n_cons = in.get_u64();
     
     R1CS result;
     result.n_vars = n_vars;
     result.n_cons = n_cons;
     
     
-    uint64_t A_size = Serialization::read_uint64(data, offset);
-    std::vector<uint8_t> A_data(data.begin() + offset, data.begin() + offset + A_size);
-    offset += A_size;
-    
-    uint64_t B_size = Serialization::read_uint64(data, offset);
-    std::vector<uint8_t> B_data(data.begin() + offset, data.begin() + offset + B_size);
-    offset += B_size;
-    
-    uint64_t C_size = Serialization::read_uint64(data, offset);
-    std::vector<uint8_t> C_data(data.begin() + offset, data.begin() + offset + C_size);
-    
-    size_t A_offset = 0, B_offset = 0, C_offset = 0;
-    result.A = deserialize_matrix(A_data, A_offset);
-    result.B = deserialize_matrix(B_data, B_offset);
-    result.C = deserialize_matrix(C_data, C_offset);
+    // Matrices are parsed where they sit; the size prefixes are only checked.
+    for (auto* M : {&result.A, &result.B, &result.C}) {
+        size_t size = in.get_count(1);
+        size_t end = in.offset() + size;
+        *M = deserialize_matrix(in, n_vars);
+        if (in.offset() != end || M->size() != n_cons) {
+            throw std::runtime_error("Malformed input: R1CS matrix size mismatch");
+        }
+    }
     
     return result;
 }
@@ -326,39 +612,27 @@ std::string R1CS::to_json() const {
     std::string result = "{";
     result += "\"n_vars\":" + std::to_string(n_vars) + ",";
     result += "\"n_cons\":" + std::to_string(n_cons) + ",";
-    result += "\"A\":[";
     
-    for (size_t i = 0; i < A.size(); ++i) {
-        if (i > 0) result += ",";
-        result += "[";
-        for (size_t j = 0; j < A[i].size(); ++j) {
-            if (j > 0) result += ",";
-            result += "{\"var\":" + std::to_string(A[i][j].idx) + ",\"coeff\":\"" + A[i][j].coeff.to_hex() + "\"}";
+    auto append_matrix = [&](const std::vector<LinearCombination>& M) {
+        for (size_t i = 0; i < n_cons; ++i) {
+            if (i > 0) result += ",";
+            result += "[";
+            bool first = true;
+            for_each_term(M, i, [&](VarIdx idx, const Fr& coeff) {
+                if (!first) result += ",";
+                first = false;
+                result += "{\"var\":" + std::to_string(idx) + ",\"coeff\":\"" + coeff.to_hex() + "\"}";
+            });
+            result += "]";
         }
-        result += "]";
-    }
+    };
     
+    result += "\"A\":[";
+    append_matrix(A);
     result += "],\"B\":[";
-    for (size_t i = 0; i < B.size(); ++i) {
-        if (i > 0) result += ",";
-        result += "[";
-        for (size_t j = 0; j < B[i].size(); ++j) {
-            if (j > 0) result += ",";
-            result += "{\"var\":" + std::to_string(B[i][j].idx) + ",\"coeff\":\"" + B[i][j].coeff.to_hex() + "\"}";
-        }
-        result += "]";
-    }
-    
+    append_matrix(B);
     result += "],\"C\":[";
-    for (size_t i = 0; i < C.size(); ++i) {
-        if (i > 0) result += ",";
-        result += "[";
-        for (size_t j = 0; j < C[i].size(); ++j) {
-            if (j > 0) result += ",";
-            result += "{\"var\":" + std::to_string(C[i][j].idx) + ",\"coeff\":\"" + C[i][j].coeff.to_hex() + "\"}";
-        }
-        result += "]";
-    }
+    append_matrix(C);
     
     result += "]}";
     return result;
@@ -372,35 +646,31 @@ void R1CS::validate_variable_index(VarIdx var_idx) const {
     ZK_ASSERT(var_idx < n_vars, "Variable index out of bounds");
 }
 
-std::vector<uint8_t> R1CS::serialize_matrix(const std::vector<std::vector<Term>>& matrix) const {
-    std::vector<uint8_t> result;
-    
-    Serialization::write_uint64(result, matrix.size());
-    for (const auto& row : matrix) {
-        Serialization::write_uint64(result, row.size());
-        for (const auto& term : row) {
-            Serialization::write_uint64(result, term.idx);
-            auto coeff_data = Serialization::serialize_fr(term.coeff);
-            result.insert(result.end(), coeff_data.begin(), coeff_data.end());
-        }
+void R1CS::serialize_matrix(ByteWriter& out, const std::vector<std::vector<Term>>& matrix) const {
+    out.put_u64(n_cons);
+    for (size_t k = 0; k < n_cons; ++k) {
+        out.put_u64(row_size(matrix, k));
+        for_each_term(matrix, k, [&](VarIdx idx, const Fr& coeff) {
+            out.put_u64(idx);
+            out.put_fr(coeff);
+        });
     }
-    
-    return result;
 }
 
-std::vector<std::vector<Term>> R1CS::deserialize_matrix(const std::vector<uint8_t>& data, size_t& offset) {
-    uint64_t rows = Serialization::read_uint64(data, offset);
+std::vector<std::vector<Term>> R1CS::deserialize_matrix(ByteReader& in, size_t n_vars) {
+    size_t rows = in.get_count(8);
     std::vector<std::vector<Term>> matrix;
     matrix.reserve(rows);
     
     for (size_t i = 0; i < rows; ++i) {
-        uint64_t cols = Serialization::read_uint64(data, offset);
+        size_t cols = in.get_count(40);
         std::vector<Term> row;
         row.reserve(cols);
         
         for (size_t j = 0; j < cols; ++j) {
-            VarIdx idx = Serialization::read_uint64(data, offset);
-            Fr coeff = Serialization::deserialize_fr(data, offset);
+            VarIdx idx = in.get_u64();
+            if (idx >= n_vars) throw std::runtime_error("Malformed input: R1CS variable index out of range");
+            Fr coeff = in.get_fr();
             row.emplace_back(idx, coeff);
         }
         matrix.push_back(std::move(row));
@@ -409,4 +679,4 @@ std::vector<std::vector<Term>> R1CS::deserialize_matrix(const std::vector<uint8_
     return matrix;
 }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,310 @@
+#include "zkmini/r1cs.hpp"
+#include "zkmini/utils.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace zkmini {
+
+namespace {
+
+// Layout (all integers little-endian):
+//   "r1cs" | version u32 | n_sections u32 | { type u32 | size u64 | payload }*
+//   header:      field_size u32 | prime | n_wires u32 | n_pub_out u32 | n_pub_in u32 |
+//                n_prv_in u32 | n_labels u64 | n_constraints u32
+//   constraints: per constraint A, B, C, each n_terms u32 | { wire u32 | coeff }*
+//   wire map:    n_wires label ids, u64 each
+constexpr uint32_t IDEN3_VERSION = 1;
+constexpr uint32_t SECTION_HEADER = 1;
+constexpr uint32_t SECTION_CONSTRAINTS = 2;
+constexpr uint32_t SECTION_WIRE_MAP = 3;
+constexpr size_t FIELD_BYTES = 32;
+
+// Constraints per parallel work item.
+constexpr size_t PARSE_CHUNK = 1 << 14;
+
+uint32_t load_u32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+uint64_t load_u64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+void store_u32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back((v >> (8 * i)) & 0xFF);
+}
+
+void store_u64(std::vector<uint8_t>& out, uint64_t v) {
+    for (int i = 0; i < 8; ++i) out.push_back((v >> (8 * i)) & 0xFF);
+}
+
+void store_fr(std::vector<uint8_t>& out, const Fr& v) {
+    for (int i = 0; i < 4; ++i) store_u64(out, v.data[i]);
+}
+
+// Canonical little-endian encoding; false if the value is not below r.
+bool load_fr(const uint8_t* p, Fr& out) {
+    std::array<uint64_t, 4> limbs;
+    for (int i = 0; i < 4; ++i) limbs[i] = load_u64(p + 8 * i);
+    const auto& M = bn254_fr::MODULUS_BN254;
+    for (int i = 3; i >= 0; --i) {
+        if (limbs[i] != M[i]) {
+            if (limbs[i] > M[i]) return false;
+            break;
+        }
+        if (i == 0) return false;
+    }
+    out = Fr(limbs);
+    return true;
+}
+
+struct Section {
+    const uint8_t* data = nullptr;
+    uint64_t size = 0;
+};
+
+void require(bool ok, const char* message) {
+    if (!ok) throw std::runtime_error(std::string("Invalid .r1cs file: ") + message);
+}
+
+// Bytes taken by one constraint starting at p, bounds-checked against end; adds
+// its A, B and C term counts to terms.
+size_t constraint_span(const uint8_t* p, const uint8_t* end, uint64_t terms_out[3]) {
+    const uint8_t* start = p;
+    for (int m = 0; m < 3; ++m) {
+        require(end - p >= 4, "truncated constraint");
+        uint64_t terms = load_u32(p);
+        terms_out[m] += terms;
+        p += 4;
+        require(static_cast<uint64_t>(end - p) >= terms * (4 + FIELD_BYTES), "truncated linear combination");
+        p += terms * (4 + FIELD_BYTES);
+    }
+    return p - start;
+}
+
+}
+
+R1CS R1CS::from_iden3(const uint8_t* data, size_t size) {
+    require(size >= 12 && std::memcmp(data, "r1cs", 4) == 0, "bad magic");
+    require(load_u32(data + 4) == IDEN3_VERSION, "unsupported version");
+    uint32_t n_sections = load_u32(data + 8);
+    
+    // Sections may come in any order; only their extents are recorded here.
+    Section header, constraints, wire_map;
+    const uint8_t* p = data + 12;
+    const uint8_t* end = data + size;
+    for (uint32_t s = 0; s < n_sections; ++s) {
+        require(end - p >= 12, "truncated section header");
+        uint32_t type = load_u32(p);
+        uint64_t len = load_u64(p + 4);
+        p += 12;
+        require(static_cast<uint64_t>(end - p) >= len, "truncated section");
+        Section sec{p, len};
+        if (type == SECTION_HEADER) header = sec;
+        else if (type == SECTION_CONSTRAINTS) constraints = sec;
+        else if (type == SECTION_WIRE_MAP) wire_map = sec;
+        p += len;
+    }
+    require(header.data != nullptr, "missing header section");
+    require(constraints.data != nullptr, "missing constraints section");
+    
+    const uint8_t* h = header.data;
+    require(header.size >= 4 && load_u32(h) == FIELD_BYTES, "field size is not 32 bytes");
+    require(header.size == 4 + FIELD_BYTES + 4 * 4 + 8 + 4, "bad header size");
+    for (size_t i = 0; i < 4; ++i) {
+        require(load_u64(h + 4 + 8 * i) == bn254_fr::MODULUS_BN254[i], "prime is not the BN254 scalar field");
+    }
+    h += 4 + FIELD_BYTES;
+    uint32_t n_wires = load_u32(h);
+    uint32_t n_pub_out = load_u32(h + 4);
+    uint32_t n_pub_in = load_u32(h + 8);
+    uint32_t n_constraints = load_u32(h + 24);
+    require(n_wires >= 1 && uint64_t(n_pub_out) + n_pub_in < n_wires, "inconsistent wire counts");
+    if (wire_map.data != nullptr) {
+        require(wire_map.size == uint64_t(n_wires) * 8, "wire map does not match wire count");
+    }
+    
+    // Index pass: byte offset of every chunk and the terms each matrix gets from it,
+    // so every chunk parses straight into its own slice of the CSR arrays.
+    const uint8_t* c = constraints.data;
+    const uint8_t* c_end = constraints.data + constraints.size;
+    size_t n_chunks = (n_constraints + PARSE_CHUNK - 1) / PARSE_CHUNK;
+    std::vector<const uint8_t*> chunk_start(n_chunks + 1);
+    std::vector<uint64_t> entry_start[3];
+    for (auto& starts : entry_start) starts.assign(n_chunks + 1, 0);
+    uint64_t terms[3] = {0, 0, 0};
+    for (size_t k = 0; k < n_constraints; ++k) {
+        if (k % PARSE_CHUNK == 0) {
+            chunk_start[k / PARSE_CHUNK] = c;
+            for (int m = 0; m < 3; ++m) entry_start[m][k / PARSE_CHUNK] = terms[m];
+        }
+        c += constraint_span(c, c_end, terms);
+    }
+    require(c == c_end, "trailing bytes in constraints section");
+    chunk_start[n_chunks] = c;
+    for (int m = 0; m < 3; ++m) {
+        require(terms[m] < UINT32_MAX, "too many terms");
+        entry_start[m][n_chunks] = terms[m];
+    }
+    
+    // Row lengths first, turned into offsets below; ids index the chunk's own table.
+    std::vector<uint32_t> row_ptr[3];
+    std::vector<uint32_t> col_idx[3];
+    std::vector<uint32_t> coeff_ids[3];
+    for (int m = 0; m < 3; ++m) {
+        row_ptr[m].assign(size_t(n_constraints) + 1, 0);
+        col_idx[m].resize(terms[m]);
+        coeff_ids[m].resize(terms[m]);
+    }
+    std::vector<std::vector<Fr>> tables[3];
+    std::vector<size_t> written[3];
+    for (int m = 0; m < 3; ++m) {
+        tables[m].resize(n_chunks);
+        written[m].assign(n_chunks, 0);
+    }
+    
+    Parallel::parallel_for(0, n_chunks, [&](size_t lo, size_t hi) {
+        LinearCombination row;
+        for (size_t chunk = lo; chunk < hi; ++chunk) {
+            std::unordered_map<Fr, uint32_t, FrLimbHash> ids[3];
+            size_t pos[3];
+            for (int m = 0; m < 3; ++m) pos[m] = entry_start[m][chunk];
+            const uint8_t* q = chunk_start[chunk];
+            size_t first = chunk * PARSE_CHUNK;
+            size_t last = std::min<size_t>(first + PARSE_CHUNK, n_constraints);
+            for (size_t k = first; k < last; ++k) {
+                for (int m = 0; m < 3; ++m) {
+                    uint32_t count = load_u32(q);
+                    q += 4;
+                    row.clear();
+                    for (uint32_t t = 0; t < count; ++t) {
+                        uint32_t wire = load_u32(q);
+                        Fr coeff;
+                        require(wire < n_wires, "wire index out of range");
+                        require(load_fr(q + 4, coeff), "coefficient not reduced");
+                        row.push_back(Term(wire, coeff));
+                        q += 4 + FIELD_BYTES;
+                    }
+                    // Merging repeated wires can only shorten the row, never overrun the slice.
+                    Term* row_end = compress_terms(row.data(), row.data() + row.size());
+                    std::vector<Fr>& table = tables[m][chunk];
+                    for (const Term* term = row.data(); term < row_end; ++term) {
+                        auto it = ids[m].emplace(term->coeff, static_cast<uint32_t>(table.size())).first;
+                        if (it->second == table.size()) table.push_back(term->coeff);
+                        col_idx[m][pos[m]] = static_cast<uint32_t>(term->idx);
+                        coeff_ids[m][pos[m]] = it->second;
+                        ++pos[m];
+                    }
+                    row_ptr[m][k + 1] = static_cast<uint32_t>(row_end - row.data());
+                }
+            }
+            for (int m = 0; m < 3; ++m) written[m][chunk] = pos[m] - entry_start[m][chunk];
+        }
+    }, 1);
+    
+    R1CS r(n_wires);
+    for (VarIdx v = 1; v <= n_pub_out + n_pub_in; ++v) {
+        r.mark_public(v);
+    }
+    SparseMatrix* csrs[3] = {&r.A_csr, &r.B_csr, &r.C_csr};
+    for (int m = 0; m < 3; ++m) {
+        // One table for the whole matrix: each chunk's ids shift past the tables
+        // before it, and its entries close up any gap that merged terms left.
+        std::vector<Fr> table;
+        std::vector<uint32_t> shift(n_chunks);
+        std::vector<size_t> out_start(n_chunks + 1, 0);
+        for (size_t chunk = 0; chunk < n_chunks; ++chunk) {
+            shift[chunk] = static_cast<uint32_t>(table.size());
+            table.insert(table.end(), tables[m][chunk].begin(), tables[m][chunk].end());
+            out_start[chunk + 1] = out_start[chunk] + written[m][chunk];
+        }
+        auto settle = [&](size_t chunk) {
+            size_t in = entry_start[m][chunk];
+            size_t out = out_start[chunk];
+            for (size_t e = 0; e < written[m][chunk]; ++e) {
+                col_idx[m][out + e] = col_idx[m][in + e];
+                coeff_ids[m][out + e] = coeff_ids[m][in + e] + shift[chunk];
+            }
+        };
+        // Without gaps every chunk stays in place, so they can be settled in parallel.
+        if (out_start[n_chunks] == terms[m]) {
+            Parallel::parallel_for(0, n_chunks, [&](size_t lo, size_t hi) {
+                for (size_t chunk = lo; chunk < hi; ++chunk) settle(chunk);
+            }, 1);
+        } else {
+            for (size_t chunk = 0; chunk < n_chunks; ++chunk) settle(chunk);
+            col_idx[m].resize(out_start[n_chunks]);
+            coeff_ids[m].resize(out_start[n_chunks]);
+        }
+        for (size_t k = 0; k < n_constraints; ++k) row_ptr[m][k + 1] += row_ptr[m][k];
+        *csrs[m] = SparseMatrix::from_arrays(n_wires, std::move(row_ptr[m]), std::move(col_idx[m]),
+                                             std::move(coeff_ids[m]), table);
+    }
+    r.n_cons = n_constraints;
+    r.finalized = true;
+    r.rows_materialized = false;
+    
+    return r;
+}
+
+R1CS R1CS::load_iden3(const std::string& path) {
+    MappedFile file(path);
+    return from_iden3(file.data(), file.size());
+}
+
+std::vector<uint8_t> R1CS::to_iden3() const {
+    for (size_t i = 0; i < public_indices.size(); ++i) {
+        if (public_indices[i] != i + 1) {
+            throw std::invalid_argument("Public inputs must be wires 1..k for the .r1cs format");
+        }
+    }
+    ZK_ASSERT(n_vars <= UINT32_MAX && n_cons <= UINT32_MAX, "System too large for the .r1cs format");
+    
+    uint64_t constraint_bytes = 0;
+    for (size_t k = 0; k < n_cons; ++k) {
+        constraint_bytes += 12 + (row_size(A, k) + row_size(B, k) + row_size(C, k)) * (4 + FIELD_BYTES);
+    }
+    
+    std::vector<uint8_t> out;
+    out.reserve(12 + 12 + 64 + 12 + constraint_bytes + 12 + 8 * n_vars);
+    for (char c : {'r', '1', 'c', 's'}) out.push_back(static_cast<uint8_t>(c));
+    store_u32(out, IDEN3_VERSION);
+    store_u32(out, 3);
+    
+    store_u32(out, SECTION_HEADER);
+    store_u64(out, 4 + FIELD_BYTES + 4 * 4 + 8 + 4);
+    store_u32(out, FIELD_BYTES);
+    for (uint64_t limb : bn254_fr::MODULUS_BN254) store_u64(out, limb);
+    store_u32(out, static_cast<uint32_t>(n_vars));
+    store_u32(out, 0);
+    store_u32(out, static_cast<uint32_t>(public_indices.size()));
+    store_u32(out, static_cast<uint32_t>(n_vars - 1 - public_indices.size()));
+    store_u64(out, n_vars);
+    store_u32(out, static_cast<uint32_t>(n_cons));
+    
+    store_u32(out, SECTION_CONSTRAINTS);
+    store_u64(out, constraint_bytes);
+    for (size_t k = 0; k < n_cons; ++k) {
+        for (const auto* M : {&A, &B, &C}) {
+            store_u32(out, static_cast<uint32_t>(row_size(*M, k)));
+            for_each_term(*M, k, [&](VarIdx idx, const Fr& coeff) {
+                store_u32(out, static_cast<uint32_t>(idx));
+                store_fr(out, coeff);
+            });
+        }
+    }
+    
+    store_u32(out, SECTION_WIRE_MAP);
+    store_u64(out, 8 * n_vars);
+    for (uint64_t v = 0; v < n_vars; ++v) store_u64(out, v);
+    
+    return out;
+}
+
+}
@@ -0,0 +1,238 @@
+#include "zkmini/r1cs.hpp"
+#include "zkmini/utils.hpp"
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace zkmini {
+
+namespace {
+
+// Layout (host byte order, checked through BYTE_ORDER_MARK):
+//   0    magic "ZKR1CS\0\0" | version u32 | byte-order mark u32
+//   16   n_vars u64 | n_cons u64 | n_public u64 | public_offset u64
+//   48   per matrix A, B, C: nnz | n_coeffs | row_ptr | col_idx | coeff_ids | table (u64 each)
+//   256  arrays, each starting on a 64-byte boundary: public indices (u64),
+//        row_ptr (u32, n_cons + 1), col_idx and coeff_ids (u32, nnz), table (Fr limbs)
+constexpr char MAGIC[8] = {'Z', 'K', 'R', '1', 'C', 'S', 0, 0};
+constexpr uint32_t MMAP_VERSION = 1;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr size_t HEADER_BYTES = 256;
+constexpr size_t ARRAY_ALIGN = 64;
+constexpr size_t MATRIX_FIELDS = 6;
+
+// Entries per parallel work item when scanning the arrays.
+constexpr size_t SCAN_CHUNK = 1 << 14;
+
+static_assert(sizeof(Fr) == 32, "Fr must be four packed limbs to be mapped directly");
+
+struct MatrixLayout {
+    uint64_t nnz;
+    uint64_t n_coeffs;
+    uint64_t row_ptr;
+    uint64_t col_idx;
+    uint64_t coeff_ids;
+    uint64_t table;
+};
+
+uint64_t align_up(uint64_t x) {
+    return (x + ARRAY_ALIGN - 1) & ~uint64_t(ARRAY_ALIGN - 1);
+}
+
+uint64_t load_u64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+void require(bool ok, const char* message) {
+    if (!ok) throw std::runtime_error(std::string("Invalid R1CS image: ") + message);
+}
+
+// [offset, offset + count * width) lies inside the file and is suitably aligned.
+void require_array(uint64_t offset, uint64_t count, uint64_t width, uint64_t file_size) {
+    require(offset % ARRAY_ALIGN == 0, "misaligned array");
+    require(offset <= file_size && count <= (file_size - offset) / width, "array out of bounds");
+}
+
+class ImageWriter {
+public:
+    explicit ImageWriter(const std::string& path) : out(path, std::ios::binary), pos(0) {
+        if (!out) throw std::runtime_error("Cannot open file for writing: " + path);
+    }
+    
+    void write(const void* data, size_t bytes) {
+        out.write(static_cast<const char*>(data), bytes);
+        pos += bytes;
+    }
+    
+    void pad_to(uint64_t offset) {
+        static const char zeros[ARRAY_ALIGN] = {};
+        while (pos < offset) write(zeros, std::min<uint64_t>(offset - pos, ARRAY_ALIGN));
+    }
+    
+    void finish() {
+        out.flush();
+        if (!out) throw std::runtime_error("Failed writing R1CS image");
+    }
+
+private:
+    std::ofstream out;
+    uint64_t pos;
+};
+
+}
+
+void R1CS::save_mmap(const std::string& path) const {
+    ZK_ASSERT(n_vars <= UINT32_MAX, "Too many variables for 32-bit column indices");
+    
+    // Unfinalized systems are frozen into temporaries; the object itself is untouched.
+    SparseMatrix tmp[3];
+    const SparseMatrix* mats[3] = {&A_csr, &B_csr, &C_csr};
+    if (!finalized) {
+        tmp[0] = build_csr(A, n_vars);
+        tmp[1] = build_csr(B, n_vars);
+        tmp[2] = build_csr(C, n_vars);
+        for (int m = 0; m < 3; ++m) mats[m] = &tmp[m];
+    }
+    
+    uint64_t offset = HEADER_BYTES;
+    uint64_t public_offset = offset;
+    offset = align_up(offset + public_indices.size() * sizeof(uint64_t));
+    
+    MatrixLayout layout[3];
+    for (int m = 0; m < 3; ++m) {
+        const SparseMatrix& M = *mats[m];
+        layout[m].nnz = M.nnz();
+        layout[m].n_coeffs = M.num_coeffs();
+        layout[m].row_ptr = offset;
+        offset = align_up(offset + (n_cons + 1) * sizeof(uint32_t));
+        layout[m].col_idx = offset;
+        offset = align_up(offset + M.nnz() * sizeof(uint32_t));
+        layout[m].coeff_ids = offset;
+        offset = align_up(offset + M.nnz() * sizeof(uint32_t));
+        layout[m].table = offset;
+        offset = align_up(offset + M.num_coeffs() * sizeof(Fr));
+    }
+    
+    uint8_t header[HEADER_BYTES] = {};
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    std::memcpy(header + 8, &MMAP_VERSION, 4);
+    std::memcpy(header + 12, &BYTE_ORDER_MARK, 4);
+    uint64_t counts[4] = {n_vars, n_cons, public_indices.size(), public_offset};
+    std::memcpy(header + 16, counts, sizeof(counts));
+    std::memcpy(header + 48, layout, sizeof(layout));
+    
+    ImageWriter w(path);
+    w.write(header, sizeof(header));
+    for (VarIdx v : public_indices) {
+        uint64_t idx = v;
+        w.write(&idx, sizeof(idx));
+    }
+    for (int m = 0; m < 3; ++m) {
+        const SparseMatrix& M = *mats[m];
+        w.pad_to(layout[m].row_ptr);
+        w.write(M.row_ptr_data(), (n_cons + 1) * sizeof(uint32_t));
+        w.pad_to(layout[m].col_idx);
+        w.write(M.col_idx_data(), M.nnz() * sizeof(uint32_t));
+        w.pad_to(layout[m].coeff_ids);
+        w.write(M.coeff_id_data(), M.nnz() * sizeof(uint32_t));
+        w.pad_to(layout[m].table);
+        for (uint32_t id = 0; id < M.num_coeffs(); ++id) {
+            w.write(M.coeff_value(id).data.data(), sizeof(Fr));
+        }
+    }
+    w.pad_to(offset);
+    w.finish();
+}
+
+R1CS R1CS::load_mmap(const std::string& path, bool validate) {
+    auto file = std::make_shared<MappedFile>(path);
+    const uint8_t* base = file->data();
+    uint64_t size = file->size();
+    
+    require(size >= HEADER_BYTES && std::memcmp(base, MAGIC, sizeof(MAGIC)) == 0, "bad magic");
+    uint32_t version, mark;
+    std::memcpy(&version, base + 8, 4);
+    std::memcpy(&mark, base + 12, 4);
+    require(version == MMAP_VERSION, "unsupported version");
+    require(mark == BYTE_ORDER_MARK, "written with a different byte order");
+    
+    uint64_t n_vars = load_u64(base + 16);
+    uint64_t n_cons = load_u64(base + 24);
+    uint64_t n_public = load_u64(base + 32);
+    uint64_t public_offset = load_u64(base + 40);
+    require(n_vars >= 1 && n_vars <= UINT32_MAX && n_cons < UINT32_MAX, "bad dimensions");
+    require_array(public_offset, n_public, sizeof(uint64_t), size);
+    
+    R1CS r(n_vars);
+    for (uint64_t i = 0; i < n_public; ++i) {
+        uint64_t v = load_u64(base + public_offset + 8 * i);
+        require(v > 0 && v < n_vars, "public input out of range");
+        r.mark_public(v);
+    }
+    
+    SparseMatrix* mats[3] = {&r.A_csr, &r.B_csr, &r.C_csr};
+    for (int m = 0; m < 3; ++m) {
+        MatrixLayout L;
+        for (size_t f = 0; f < MATRIX_FIELDS; ++f) {
+            reinterpret_cast<uint64_t*>(&L)[f] = load_u64(base + 48 + 8 * (MATRIX_FIELDS * m + f));
+        }
+        require(L.nnz < UINT32_MAX && L.n_coeffs <= UINT32_MAX, "matrix too large");
+        require_array(L.row_ptr, n_cons + 1, sizeof(uint32_t), size);
+        require_array(L.col_idx, L.nnz, sizeof(uint32_t), size);
+        require_array(L.coeff_ids, L.nnz, sizeof(uint32_t), size);
+        require_array(L.table, L.n_coeffs, sizeof(Fr), size);
+        
+        const uint32_t* row_ptr = reinterpret_cast<const uint32_t*>(base + L.row_ptr);
+        const uint32_t* col_idx = reinterpret_cast<const uint32_t*>(base + L.col_idx);
+        const uint32_t* coeff_ids = reinterpret_cast<const uint32_t*>(base + L.coeff_ids);
+        const Fr* table = reinterpret_cast<const Fr*>(base + L.table);
+        require(row_ptr[0] == 0 && row_ptr[n_cons] == L.nnz, "row offsets do not cover the entries");
+        
+        // Every reader indexes through these arrays unchecked, so they are always
+        // scanned: O(n_cons + nnz) integer compares.
+        std::atomic<bool> bad(false);
+        Parallel::parallel_for(0, n_cons, [&](size_t lo, size_t hi) {
+            for (size_t k = lo; k < hi; ++k) {
+                if (row_ptr[k] > row_ptr[k + 1]) {
+                    bad.store(true, std::memory_order_relaxed);
+                    return;
+                }
+            }
+        }, SCAN_CHUNK);
+        require(!bad.load(), "row offsets decrease");
+        Parallel::parallel_for(0, L.nnz, [&](size_t lo, size_t hi) {
+            for (size_t e = lo; e < hi; ++e) {
+                if (col_idx[e] >= n_vars || coeff_ids[e] >= L.n_coeffs) {
+                    bad.store(true, std::memory_order_relaxed);
+                    return;
+                }
+            }
+        }, SCAN_CHUNK);
+        require(!bad.load(), "entry out of range");
+        
+        if (validate) {
+            Parallel::parallel_for(0, L.n_coeffs, [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; ++i) {
+                    if (!table[i].is_valid()) {
+                        bad.store(true, std::memory_order_relaxed);
+                        return;
+                    }
+                }
+            }, SCAN_CHUNK);
+            require(!bad.load(), "coefficient not reduced");
+        }
+        
+        *mats[m] = SparseMatrix::view(n_vars, n_cons, L.nnz, row_ptr, col_idx, coeff_ids,
+                                      table, L.n_coeffs, file);
+    }
+    
+    r.n_cons = n_cons;
+    r.finalized = true;
+    r.rows_materialized = false;
+    return r;
+}
+
+}
@@ -0,0 +1,324 @@
+#include "zkmini/r1cs.hpp"
+#include "zkmini/utils.hpp"
+#include <algorithm>
+#include <map>
+
+namespace zkmini {
+
+std::vector<Fr> VariableMap::translate_witness(const std::vector<Fr>& old_witness) const {
+    ZK_ASSERT(old_witness.size() == num_old(), "Witness does not match the original system");
+    
+    std::vector<Fr> w;
+    w.reserve(num_new());
+    for (VarIdx v : new_to_old) {
+        w.push_back(old_witness[v]);
+    }
+    return w;
+}
+
+namespace {
+
+// Upper bound on the fill-in a single substitution may cause, measured as
+// (pivot occurrences) * (terms it is replaced by). Keeps dense rows from
+// snowballing when a variable shared by many constraints is solved for.
+constexpr size_t MAX_SUBSTITUTION_FILL = 4096;
+
+// Substitutions are stored unexpanded: x_p = subst[p] may still mention variables
+// eliminated after p. settle() brings an entry up to date on demand and keeps the
+// result (path compression), so long elimination chains cost one walk.
+class LinearEliminator {
+public:
+    LinearEliminator(size_t n_vars, std::vector<bool> pinned)
+        : subst(n_vars), eliminated(n_vars, false), settled_at(n_vars, 0),
+          pinned(std::move(pinned)), occurrences(n_vars, 0), eliminations(0) {}
+    
+    void count(const LinearCombination& L) {
+        for (const auto& term : L) occurrences[term.idx]++;
+    }
+    
+    // Rewrites L so it only mentions live variables.
+    void resolve(LinearCombination& L) {
+        bool stale = false;
+        for (const auto& term : L) {
+            if (eliminated[term.idx]) {
+                settle(term.idx);
+                stale = true;
+            }
+        }
+        if (stale) expand(L);
+    }
+    
+    // eq is a resolved equation sum(eq) = 0. Solves it for the unpinned variable
+    // with the fewest occurrences, preferring +-1 coefficients on ties; false if
+    // there is none or the fill is too high.
+    bool eliminate(const LinearCombination& eq) {
+        size_t best = eq.size();
+        bool best_unit = false;
+        for (size_t i = 0; i < eq.size(); ++i) {
+            VarIdx v = eq[i].idx;
+            if (pinned[v]) continue;
+            uint32_t magnitude;
+            bool negative;
+            bool unit = eq[i].coeff.as_small(magnitude, negative) && magnitude == 1;
+            if (best == eq.size() || occurrences[v] < occurrences[eq[best].idx] ||
+                (occurrences[v] == occurrences[eq[best].idx] && unit && !best_unit)) {
+                best = i;
+                best_unit = unit;
+            }
+        }
+        if (best == eq.size()) return false;
+        
+        VarIdx p = eq[best].idx;
+        if (occurrences[p] * (eq.size() - 1) > MAX_SUBSTITUTION_FILL) return false;
+        
+        Fr scale = negated_inverse(eq[best].coeff);
+        LinearCombination expr;
+        expr.reserve(eq.size() - 1);
+        for (size_t i = 0; i < eq.size(); ++i) {
+            if (i == best) continue;
+            expr.push_back(Term(eq[i].idx, eq[i].coeff * scale));
+            occurrences[eq[i].idx] += occurrences[p];
+        }
+        
+        subst[p] = std::move(expr);
+        eliminated[p] = true;
+        settled_at[p] = ++eliminations;
+        return true;
+    }
+
+private:
+    std::vector<LinearCombination> subst;
+    std::vector<bool> eliminated;
+    std::vector<size_t> settled_at;
+    std::vector<bool> pinned;
+    std::vector<size_t> occurrences;
+    size_t eliminations;
+    
+    std::vector<VarIdx> stack;
+    std::vector<Term> scratch;
+    
+    // Pivot coefficients repeat (1, -1, powers of two), and each inversion is a
+    // full exponentiation.
+    std::map<std::array<uint64_t, 4>, Fr> inverse_cache;
+    
+    Fr negated_inverse(const Fr& c) {
+        auto it = inverse_cache.find(c.data);
+        if (it != inverse_cache.end()) return it->second;
+        Fr inv = (Fr(0) - c).inverse();
+        inverse_cache.emplace(c.data, inv);
+        return inv;
+    }
+    
+    // An entry stamped with the current elimination count mentions no eliminated
+    // variable. The substitution graph is acyclic (each entry only names variables
+    // live when it was made), so the explicit stack always drains.
+    void settle(VarIdx v) {
+        stack.push_back(v);
+        while (!stack.empty()) {
+            VarIdx u = stack.back();
+            if (settled_at[u] == eliminations) {
+                stack.pop_back();
+                continue;
+            }
+            
+            bool pending = false;
+            for (const auto& term : subst[u]) {
+                if (eliminated[term.idx] && settled_at[term.idx] != eliminations) {
+                    stack.push_back(term.idx);
+                    pending = true;
+                }
+            }
+            if (pending) continue;
+            
+            expand(subst[u]);
+            settled_at[u] = eliminations;
+            stack.pop_back();
+        }
+    }
+    
+    // One level of substitution; every eliminated variable in L must be settled.
+    void expand(LinearCombination& L) {
+        scratch.clear();
+        for (const auto& term : L) {
+            if (!eliminated[term.idx]) {
+                scratch.push_back(term);
+                continue;
+            }
+            for (const auto& s : subst[term.idx]) {
+                scratch.push_back(Term(s.idx, s.coeff * term.coeff));
+            }
+        }
+        Term* end = R1CS::compress_terms(scratch.data(), scratch.data() + scratch.size());
+        L.assign(scratch.data(), end);
+    }
+};
+
+bool constant_row(const LinearCombination& L, Fr& value) {
+    if (L.empty()) {
+        value = Fr(0);
+        return true;
+    }
+    if (L.size() == 1 && L[0].idx == 0) {
+        value = L[0].coeff;
+        return true;
+    }
+    return false;
+}
+
+// factor * L - R as one equation sum = 0.
+void linear_equation(const LinearCombination& L, const Fr& factor, const LinearCombination& R,
+                     LinearCombination& eq) {
+    eq.clear();
+    if (!factor.is_zero()) {
+        for (const auto& term : L) eq.push_back(Term(term.idx, term.coeff * factor));
+    }
+    for (const auto& term : R) eq.push_back(Term(term.idx, Fr(0) - term.coeff));
+    Term* end = R1CS::compress_terms(eq.data(), eq.data() + eq.size());
+    eq.erase(eq.begin() + (end - eq.data()), eq.end());
+}
+
+uint64_t row_hash(const LinearCombination& L, uint64_t h) {
+    for (const auto& term : L) {
+        h = (h ^ term.idx) * 0x100000001b3ULL;
+        h = (h ^ term.coeff.data[0]) * 0x100000001b3ULL;
+    }
+    return (h ^ L.size()) * 0x100000001b3ULL;
+}
+
+bool same_row(const LinearCombination& a, const LinearCombination& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].idx != b[i].idx || a[i].coeff != b[i].coeff) return false;
+    }
+    return true;
+}
+
+}
+
+VariableMap R1CS::optimize() {
+    materialize_rows();
+    
+    std::vector<bool> pinned(n_vars, false);
+    pinned[0] = true;
+    for (VarIdx v : public_indices) pinned[v] = true;
+    
+    LinearEliminator elim(n_vars, pinned);
+    for (size_t k = 0; k < n_cons; ++k) {
+        elim.count(A[k]);
+        elim.count(B[k]);
+        elim.count(C[k]);
+    }
+    
+    // Pass 1: solve linear constraints in order, each against the substitutions so far.
+    std::vector<bool> keep(n_cons, true);
+    LinearCombination eq;
+    for (size_t k = 0; k < n_cons; ++k) {
+        Fr factor;
+        if (constant_row(B[k], factor)) {
+            linear_equation(A[k], factor, C[k], eq);
+        } else if (constant_row(A[k], factor)) {
+            linear_equation(B[k], factor, C[k], eq);
+        } else {
+            continue;
+        }
+        
+        elim.resolve(eq);
+        if (eq.empty() || elim.eliminate(eq)) keep[k] = false;
+    }
+    
+    // Pass 2: rewrite the surviving constraints over live variables and drop the
+    // ones that collapsed to 0 = 0.
+    size_t out = 0;
+    for (size_t k = 0; k < n_cons; ++k) {
+        if (!keep[k]) continue;
+        elim.resolve(A[k]);
+        elim.resolve(B[k]);
+        elim.resolve(C[k]);
+        if ((A[k].empty() || B[k].empty()) && C[k].empty()) continue;
+        
+        if (out != k) {
+            A[out] = std::move(A[k]);
+            B[out] = std::move(B[k]);
+            C[out] = std::move(C[k]);
+        }
+        ++out;
+    }
+    
+    // Duplicates: sort by row hash, compare exactly within equal-hash runs and keep
+    // the first occurrence.
+    std::vector<std::pair<uint64_t, size_t>> keyed(out);
+    for (size_t k = 0; k < out; ++k) {
+        uint64_t h = row_hash(C[k], row_hash(B[k], row_hash(A[k], 0xcbf29ce484222325ULL)));
+        keyed[k] = {h, k};
+    }
+    std::sort(keyed.begin(), keyed.end());
+    
+    std::vector<bool> duplicate(out, false);
+    for (size_t i = 0; i < keyed.size();) {
+        size_t j = i + 1;
+        while (j < keyed.size() && keyed[j].first == keyed[i].first) ++j;
+        for (size_t a = i; a < j; ++a) {
+            size_t ka = keyed[a].second;
+            if (duplicate[ka]) continue;
+            for (size_t b = a + 1; b < j; ++b) {
+                size_t kb = keyed[b].second;
+                if (!duplicate[kb] && same_row(A[ka], A[kb]) && same_row(B[ka], B[kb]) &&
+                    same_row(C[ka], C[kb])) {
+                    duplicate[kb] = true;
+                }
+            }
+        }
+        i = j;
+    }
+    
+    size_t rows = 0;
+    for (size_t k = 0; k < out; ++k) {
+        if (duplicate[k]) continue;
+        if (rows != k) {
+            A[rows] = std::move(A[k]);
+            B[rows] = std::move(B[k]);
+            C[rows] = std::move(C[k]);
+        }
+        ++rows;
+    }
+    A.resize(rows);
+    B.resize(rows);
+    C.resize(rows);
+    
+    // Renumber: keep the constant wire, public inputs and anything still referenced.
+    std::vector<bool> used(pinned);
+    for (size_t k = 0; k < rows; ++k) {
+        for (const auto& term : A[k]) used[term.idx] = true;
+        for (const auto& term : B[k]) used[term.idx] = true;
+        for (const auto& term : C[k]) used[term.idx] = true;
+    }
+    
+    VariableMap map;
+    map.old_to_new.assign(n_vars, VariableMap::REMOVED);
+    for (VarIdx v = 0; v < n_vars; ++v) {
+        if (!used[v]) continue;
+        map.old_to_new[v] = map.new_to_old.size();
+        map.new_to_old.push_back(v);
+    }
+    
+    for (auto* M : {&A, &B, &C}) {
+        for (auto& row : *M) {
+            for (auto& term : row) term.idx = map.old_to_new[term.idx];
+        }
+    }
+    for (auto& v : public_indices) v = map.old_to_new[v];
+    
+    n_vars = map.num_new();
+    next_var = n_vars;
+    n_cons = rows;
+    
+    finalized = false;
+    csc_built = false;
+    for (auto* M : {&A_csr, &B_csr, &C_csr, &A_csc, &B_csc, &C_csc}) {
+        M->clear();
+    }
+    
+    return map;
+}
+
+}
@@ -4,7 +4,10 @@
 #include "zkmini/fq2.hpp"
 #include "zkmini/g1.hpp"
 #include "zkmini/g2.hpp"
+#include "zkmini/utils.hpp"
 #include <algorithm>
+#include <atomic>
+#include <stdexcept>
 #include <sstream>
 #include <iomanip>
 
@@ -173,62 +176,220 @@ G2 Serialization::g2_from_json(const std::string& json_str) {
     return G2();
 }
 
-std::vector<uint8_t> Serialization::serialize_g1_compressed(const G1& point) {
-    if (point.is_zero()) {
-        std::vector<uint8_t> result(G1_COMPRESSED_SIZE, 0);
-        result[0] = 0x40; 
-        return result;
+namespace {
+
+constexpr uint8_t FLAG_Y_LARGEST = 0x80;
+constexpr uint8_t FLAG_INFINITY = 0x40;
+constexpr uint8_t FLAG_MASK = FLAG_Y_LARGEST | FLAG_INFINITY;
+
+// Points per parallel work item; each costs a field exponentiation or more.
+constexpr size_t DECOMPRESS_CHUNK = 256;
+
+void store_fq(const Fq& v, uint8_t* out) {
+    for (int i = 0; i < 4; ++i) {
+        uint64_t limb = v.get_data(i);
+        for (int j = 0; j < 8; ++j) out[i * 8 + j] = (limb >> (j * 8)) & 0xFF;
+    }
+}
+
+// False when the 32 bytes are not below p.
+bool load_fq(const uint8_t* in, Fq& out) {
+    std::array<uint64_t, 4> limbs = {0, 0, 0, 0};
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 8; ++j) limbs[i] |= static_cast<uint64_t>(in[i * 8 + j]) << (j * 8);
+    }
+    bool below = false;
+    for (int i = 3; i >= 0; --i) {
+        if (limbs[i] != Fq::MODULUS[i]) {
+            below = limbs[i] < Fq::MODULUS[i];
+            break;
+        }
+    }
+    if (!below) return false;
+    out = Fq(limbs);
+    return true;
+}
+
+// The encoding is infinity: only the infinity flag, every other bit clear.
+bool is_infinity_encoding(const uint8_t* in, size_t size) {
+    if (in[size - 1] != FLAG_INFINITY) return false;
+    for (size_t i = 0; i + 1 < size; ++i) {
+        if (in[i] != 0) return false;
+    }
+    return true;
+}
+
+bool decode_g1(const uint8_t* in, G1Affine& out) {
+    const size_t size = Serialization::G1_COMPRESSED_SIZE;
+    uint8_t flags = in[size - 1] & FLAG_MASK;
+    if (flags & FLAG_INFINITY) {
+        if (!is_infinity_encoding(in, size)) return false;
+        out = G1Affine();
+        return true;
+    }
+    uint8_t x_bytes[size];
+    std::copy(in, in + size, x_bytes);
+    x_bytes[size - 1] &= ~FLAG_MASK;
+    Fq x;
+    return load_fq(x_bytes, x) && G1Affine::from_x(x, flags & FLAG_Y_LARGEST, out);
+}
+
+// The flags and, unless the point is infinity, the x of a compressed G2 point.
+bool read_g2_x(const uint8_t* in, uint8_t& flags, Fq2& x) {
+    const size_t size = Serialization::G2_COMPRESSED_SIZE;
+    flags = in[size - 1] & FLAG_MASK;
+    if (flags & FLAG_INFINITY) return is_infinity_encoding(in, size);
+    uint8_t x_bytes[size];
+    std::copy(in, in + size, x_bytes);
+    x_bytes[size - 1] &= ~FLAG_MASK;
+    return load_fq(x_bytes, x.c0) && load_fq(x_bytes + 32, x.c1);
+}
+
+bool decode_g2(const uint8_t* in, G2Affine& out) {
+    uint8_t flags;
+    Fq2 x;
+    if (!read_g2_x(in, flags, x)) return false;
+    if (flags & FLAG_INFINITY) {
+        out = G2Affine();
+        return true;
+    }
+    return G2Affine::from_x(x, flags & FLAG_Y_LARGEST, out);
+}
+
+// decode_g2 over [lo, hi), with one Fq inversion for all the square roots.
+bool decode_g2_range(const uint8_t* data, size_t lo, size_t hi, std::vector<G2Affine>& out) {
+    std::vector<size_t> index;
+    std::vector<Fq2> xs;
+    std::vector<bool> y_largest;
+    for (size_t i = lo; i < hi; ++i) {
+        uint8_t flags;
+        Fq2 x;
+        if (!read_g2_x(data + i * Serialization::G2_COMPRESSED_SIZE, flags, x)) return false;
+        if (flags & FLAG_INFINITY) {
+            out[i] = G2Affine();
+            continue;
+        }
+        index.push_back(i);
+        xs.push_back(x);
+        y_largest.push_back(flags & FLAG_Y_LARGEST);
     }
     
-    std::vector<uint8_t> result(G1_COMPRESSED_SIZE, 0);
-    result[0] = 0x80; 
-    
+    std::vector<G2Affine> points;
+    if (!G2Affine::from_x_batch(xs, y_largest, points)) return false;
+    for (size_t k = 0; k < index.size(); ++k) out[index[k]] = points[k];
+    return true;
+}
+
+template <typename Affine, size_t SIZE>
+std::vector<uint8_t> compress_all(const std::vector<Affine>& points, void (*compress)(const Affine&, uint8_t*)) {
+    std::vector<uint8_t> out(points.size() * SIZE);
+    Parallel::parallel_for(0, points.size(), [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) compress(points[i], out.data() + i * SIZE);
+    }, DECOMPRESS_CHUNK);
+    return out;
+}
+
+template <typename Affine, size_t SIZE>
+std::vector<Affine> decompress_all(const uint8_t* data, size_t n, bool (*decode)(const uint8_t*, Affine&)) {
+    std::vector<Affine> out(n);
+    std::atomic<bool> bad(false);
+    Parallel::parallel_for(0, n, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            if (!decode(data + i * SIZE, out[i])) {
+                bad.store(true, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }, DECOMPRESS_CHUNK);
+    if (bad.load()) throw std::runtime_error("Invalid compressed point");
+    return out;
+}
+
+}
+
+void Serialization::compress_g1(const G1Affine& point, uint8_t* out) {
+    if (point.is_zero()) {
+        std::fill(out, out + G1_COMPRESSED_SIZE, 0);
+        out[G1_COMPRESSED_SIZE - 1] = FLAG_INFINITY;
+        return;
+    }
+    store_fq(point.x, out);
+    if (point.y.is_lexicographically_largest()) out[G1_COMPRESSED_SIZE - 1] |= FLAG_Y_LARGEST;
+}
+
+G1Affine Serialization::decompress_g1(const uint8_t* in) {
+    G1Affine point;
+    if (!decode_g1(in, point)) throw std::runtime_error("Invalid compressed G1 point");
+    return point;
+}
+
+void Serialization::compress_g2(const G2Affine& point, uint8_t* out) {
+    if (point.is_zero()) {
+        std::fill(out, out + G2_COMPRESSED_SIZE, 0);
+        out[G2_COMPRESSED_SIZE - 1] = FLAG_INFINITY;
+        return;
+    }
+    store_fq(point.x.c0, out);
+    store_fq(point.x.c1, out + 32);
+    if (point.y.is_lexicographically_largest()) out[G2_COMPRESSED_SIZE - 1] |= FLAG_Y_LARGEST;
+}
+
+G2Affine Serialization::decompress_g2(const uint8_t* in) {
+    G2Affine point;
+    if (!decode_g2(in, point)) throw std::runtime_error("Invalid compressed G2 point");
+    return point;
+}
+
+std::vector<uint8_t> Serialization::compress_g1_batch(const std::vector<G1Affine>& points) {
+    return compress_all<G1Affine, G1_COMPRESSED_SIZE>(points, compress_g1);
+}
+
+std::vector<G1Affine> Serialization::decompress_g1_batch(const uint8_t* data, size_t n) {
+    return decompress_all<G1Affine, G1_COMPRESSED_SIZE>(data, n, decode_g1);
+}
+
+std::vector<uint8_t> Serialization::compress_g2_batch(const std::vector<G2Affine>& points) {
+    return compress_all<G2Affine, G2_COMPRESSED_SIZE>(points, compress_g2);
+}
+
+std::vector<G2Affine> Serialization::decompress_g2_batch(const uint8_t* data, size_t n) {
+    std::vector<G2Affine> out(n);
+    std::atomic<bool> bad(false);
+    Parallel::parallel_for(0, n, [&](size_t lo, size_t hi) {
+        if (!decode_g2_range(data, lo, hi, out)) bad.store(true, std::memory_order_relaxed);
+    }, DECOMPRESS_CHUNK);
+    if (bad.load()) throw std::runtime_error("Invalid compressed point");
+    return out;
+}
+
+std::vector<uint8_t> Serialization::serialize_g1_compressed(const G1& point) {
+    std::vector<uint8_t> result(G1_COMPRESSED_SIZE);
+    compress_g1(G1Affine(point), result.data());
     return result;
 }
 
 G1 Serialization::deserialize_g1_compressed(const std::vector<uint8_t>& data, size_t& offset) {
     if (offset + G1_COMPRESSED_SIZE > data.size()) {
-        offset += G1_COMPRESSED_SIZE;
-        return G1();
+        throw std::runtime_error("Truncated compressed G1 point");
     }
-    
-    uint8_t flags = data[offset];
+    G1Affine point = decompress_g1(data.data() + offset);
     offset += G1_COMPRESSED_SIZE;
-    
-    if (flags & 0x40) {
-        return G1(); 
-    }
-    
-    
-    return G1(Fq(1), Fq(2));
+    return point.to_jacobian();
 }
 
 std::vector<uint8_t> Serialization::serialize_g2_compressed(const G2& point) {
-    if (point.is_zero()) {
-        std::vector<uint8_t> result(G2_COMPRESSED_SIZE, 0);
-        result[0] = 0x40; 
-        return result;
-    }
-    
-    std::vector<uint8_t> result(G2_COMPRESSED_SIZE, 0);
-    result[0] = 0x80; 
+    std::vector<uint8_t> result(G2_COMPRESSED_SIZE);
+    compress_g2(G2Affine(point), result.data());
     return result;
 }
 
 G2 Serialization::deserialize_g2_compressed(const std::vector<uint8_t>& data, size_t& offset) {
     if (offset + G2_COMPRESSED_SIZE > data.size()) {
-        offset += G2_COMPRESSED_SIZE;
-        return G2();
+        throw std::runtime_error("Truncated compressed G2 point");
     }
-    
-    uint8_t flags = data[offset];
+    G2Affine point = decompress_g2(data.data() + offset);
     offset += G2_COMPRESSED_SIZE;
-    
-    if (flags & 0x40) {
-        return G2(); 
-    }
-    
-    return G2(Fq2(Fq(1), Fq(0)), Fq2(Fq(2), Fq(0)));
+    return point.to_jacobian();
 }
 
 void Serialization::write_uint32(std::vector<uint8_t>& data, uint32_t value) {
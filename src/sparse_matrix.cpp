@@ -0,0 +1,197 @@
+#include "zkmini/sparse_matrix.hpp"
+#include "zkmini/utils.hpp"
+#include <limits>
+
+namespace zkmini {
+
+namespace {
+
+// Entries per parallel work item when remapping coefficient ids.
+constexpr size_t REMAP_CHUNK = 1 << 16;
+
+}
+
+SparseMatrix::SparseMatrix() : cols(0), row_ptr(1, 0), mapped() {}
+
+SparseMatrix::SparseMatrix(size_t num_cols) : cols(num_cols), row_ptr(1, 0), mapped() {
+    ZK_ASSERT(num_cols <= std::numeric_limits<uint32_t>::max(), "Too many columns for 32-bit indices");
+}
+
+SparseMatrix SparseMatrix::view(size_t num_cols, size_t num_rows, size_t nnz,
+                                const uint32_t* row_ptr, const uint32_t* col_idx,
+                                const uint32_t* coeff_ids, const Fr* table, size_t num_coeffs,
+                                std::shared_ptr<const void> backing) {
+    SparseMatrix m(num_cols);
+    m.row_ptr.clear();
+    m.mapped = {row_ptr, col_idx, coeff_ids, num_rows, nnz};
+    m.backing = backing ? std::move(backing) : std::make_shared<int>(0);
+
+    // Ids in the mapped arrays index the table as stored, repeats included.
+    m.coeff_table.reserve(num_coeffs);
+    m.coeff_class.reserve(num_coeffs);
+    for (size_t i = 0; i < num_coeffs; ++i) {
+        uint32_t id = m.intern(table[i]);
+        if (id != i) {
+            m.coeff_table.push_back(table[i]);
+            m.coeff_class.push_back(m.coeff_class[id]);
+        }
+    }
+    return m;
+}
+
+SparseMatrix SparseMatrix::from_arrays(size_t num_cols, std::vector<uint32_t> row_ptr,
+                                       std::vector<uint32_t> col_idx, std::vector<uint32_t> coeff_ids,
+                                       const std::vector<Fr>& table) {
+    ZK_ASSERT(!row_ptr.empty() && row_ptr.back() == col_idx.size() && coeff_ids.size() == col_idx.size(),
+              "Inconsistent CSR arrays");
+    SparseMatrix m(num_cols);
+    m.row_ptr = std::move(row_ptr);
+    m.col_idx = std::move(col_idx);
+    m.coeff_ids = std::move(coeff_ids);
+
+    std::vector<uint32_t> remap(table.size());
+    bool identity = true;
+    for (size_t i = 0; i < table.size(); ++i) {
+        remap[i] = m.intern(table[i]);
+        identity = identity && remap[i] == i;
+    }
+    if (!identity) {
+        Parallel::parallel_for(0, m.coeff_ids.size(), [&](size_t lo, size_t hi) {
+            for (size_t e = lo; e < hi; ++e) m.coeff_ids[e] = remap[m.coeff_ids[e]];
+        }, REMAP_CHUNK);
+    }
+    return m;
+}
+
+void SparseMatrix::detach() {
+    if (!backing) return;
+    row_ptr.assign(mapped.row_ptr, mapped.row_ptr + mapped.rows + 1);
+    col_idx.assign(mapped.col_idx, mapped.col_idx + mapped.nnz);
+    coeff_ids.assign(mapped.coeff_ids, mapped.coeff_ids + mapped.nnz);
+    mapped = MappedArrays();
+    backing.reset();
+}
+
+uint32_t SparseMatrix::intern(const Fr& coeff) {
+    auto it = interned.find(coeff);
+    if (it != interned.end()) return it->second;
+
+    ZK_ASSERT(coeff_table.size() < std::numeric_limits<uint32_t>::max(), "Too many distinct coefficients");
+    uint32_t id = static_cast<uint32_t>(coeff_table.size());
+    CoeffClass cls = {0, false};
+    uint32_t magnitude;
+    bool negative;
+    if (coeff.as_small(magnitude, negative) && magnitude != 0) {
+        cls.magnitude = magnitude;
+        cls.negative = negative;
+    }
+    coeff_table.push_back(coeff);
+    coeff_class.push_back(cls);
+    interned.emplace(coeff, id);
+    return id;
+}
+
+void SparseMatrix::reserve(size_t rows, size_t nnz) {
+    row_ptr.reserve(rows + 1);
+    col_idx.reserve(nnz);
+    coeff_ids.reserve(nnz);
+}
+
+void SparseMatrix::push_term(size_t col, const Fr& coeff) {
+    ZK_ASSERT(!backing, "Mapped matrix is read-only; detach() it first");
+    ZK_ASSERT(col < cols, "Column index out of bounds");
+    ZK_ASSERT(col_idx.size() < std::numeric_limits<uint32_t>::max(), "Too many entries for 32-bit offsets");
+
+    col_idx.push_back(static_cast<uint32_t>(col));
+    coeff_ids.push_back(intern(coeff));
+}
+
+void SparseMatrix::close_row() {
+    ZK_ASSERT(!backing, "Mapped matrix is read-only; detach() it first");
+    row_ptr.push_back(static_cast<uint32_t>(col_idx.size()));
+}
+
+void SparseMatrix::clear() {
+    mapped = MappedArrays();
+    backing.reset();
+    row_ptr.assign(1, 0);
+    col_idx.clear();
+    coeff_ids.clear();
+    coeff_table.clear();
+    coeff_class.clear();
+    interned.clear();
+}
+
+Fr SparseMatrix::row_dot(size_t k, const std::vector<Fr>& x) const {
+    const uint32_t* col_idx = col_idx_data();
+    const uint32_t* coeff_ids = coeff_id_data();
+    size_t begin = row_begin(k);
+    size_t end = row_end(k);
+
+    Fr cheap;
+    Fr::MulAccumulator acc;
+    size_t products = 0;
+    size_t last_product = 0;
+
+    for (size_t e = begin; e < end; ++e) {
+        const Fr& v = x[col_idx[e]];
+        const CoeffClass& cls = coeff_class[coeff_ids[e]];
+        if (cls.magnitude != 0) {
+            Fr t = cls.magnitude == 1 ? v : v.mul_small(cls.magnitude);
+            cheap = cls.negative ? cheap - t : cheap + t;
+        } else {
+            if (products == 1) acc.add_product(coeff_table[coeff_ids[last_product]], x[col_idx[last_product]]);
+            if (products >= 1) acc.add_product(coeff_table[coeff_ids[e]], v);
+            last_product = e;
+            ++products;
+        }
+    }
+
+    // A lone product is cheaper as a plain multiply than a deferred reduction.
+    if (products == 0) return cheap;
+    if (products == 1) return cheap + coeff_table[coeff_ids[last_product]] * x[col_idx[last_product]];
+    return cheap + acc.result();
+}
+
+SparseMatrix SparseMatrix::transpose() const {
+    const uint32_t* row_ptr = row_ptr_data();
+    const uint32_t* col_idx = col_idx_data();
+    const uint32_t* coeff_ids = coeff_id_data();
+
+    SparseMatrix t(num_rows());
+    t.reserve(cols, nnz());
+
+    std::vector<uint32_t> counts(cols + 1, 0);
+    for (size_t e = 0; e < nnz(); ++e) {
+        counts[col_idx[e] + 1]++;
+    }
+    for (size_t j = 0; j < cols; ++j) {
+        counts[j + 1] += counts[j];
+    }
+
+    t.row_ptr = counts;
+    t.col_idx.resize(nnz());
+    t.coeff_ids.resize(nnz());
+    t.coeff_table = coeff_table;
+    t.coeff_class = coeff_class;
+    t.interned = interned;
+
+    // Walking rows in order leaves each transposed row sorted by original row.
+    std::vector<uint32_t> next(counts.begin(), counts.end() - 1);
+    for (size_t k = 0; k < num_rows(); ++k) {
+        for (size_t e = row_ptr[k]; e < row_ptr[k + 1]; ++e) {
+            size_t dst = next[col_idx[e]]++;
+            t.col_idx[dst] = static_cast<uint32_t>(k);
+            t.coeff_ids[dst] = coeff_ids[e];
+        }
+    }
+
+    return t;
+}
+
+size_t SparseMatrix::memory_bytes() const {
+    return (row_ptr.size() + col_idx.size() + coeff_ids.size()) * sizeof(uint32_t) +
+           coeff_table.size() * (sizeof(Fr) + sizeof(CoeffClass));
+}
+
+}
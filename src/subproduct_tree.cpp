@@ -0,0 +1,204 @@
+#include "zkmini/subproduct_tree.hpp"
+#include "zkmini/utils.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace zkmini {
+
+SubproductTree::SubproductTree(const std::vector<Fr>& points) : points(points) {
+    ZK_ASSERT(!points.empty(), "Subproduct tree needs at least one point");
+    build();
+}
+
+std::shared_ptr<const SubproductTree> SubproductTree::cached(const std::vector<Fr>& points) {
+    static std::mutex cache_mutex;
+    static std::vector<std::shared_ptr<const SubproductTree>> cache;
+
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        for (const auto& tree : cache) {
+            if (tree->points == points) return tree;
+        }
+    }
+
+    auto tree = std::make_shared<const SubproductTree>(points);
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (cache.size() >= CACHE_ENTRIES) {
+        cache.erase(cache.begin());
+    }
+    cache.push_back(tree);
+    return tree;
+}
+
+size_t SubproductTree::node_begin(size_t level, size_t j) const {
+    return std::min(points.size(), (j * LEAF_SIZE) << level);
+}
+
+size_t SubproductTree::node_end(size_t level, size_t j) const {
+    return std::min(points.size(), ((j + 1) * LEAF_SIZE) << level);
+}
+
+void SubproductTree::build() {
+    size_t leaves = (points.size() + LEAF_SIZE - 1) / LEAF_SIZE;
+    levels.emplace_back(leaves);
+
+    Parallel::parallel_for(0, leaves, [&](size_t lo, size_t hi) {
+        for (size_t j = lo; j < hi; ++j) {
+            std::vector<Fr> pts(points.begin() + node_begin(0, j), points.begin() + node_end(0, j));
+            levels[0][j] = Polynomial::vanishing(pts);
+        }
+    }, 4);
+
+    while (levels.back().size() > 1) {
+        const std::vector<Polynomial>& below = levels.back();
+        std::vector<Polynomial> above((below.size() + 1) / 2);
+
+        // Upper levels have few, large nodes; each product parallelises poorly
+        // on its own, so split the level's nodes across threads instead.
+        Parallel::parallel_for(0, above.size(), [&](size_t lo, size_t hi) {
+            for (size_t j = lo; j < hi; ++j) {
+                if (2 * j + 1 < below.size()) {
+                    above[j] = Polynomial::mul(below[2 * j], below[2 * j + 1]);
+                } else {
+                    above[j] = below[2 * j];
+                }
+            }
+        });
+
+        levels.push_back(std::move(above));
+    }
+}
+
+void SubproductTree::compute_inverses() const {
+    rev_inverses.assign(levels.size(), {});
+
+    for (size_t level = 0; level + 1 < levels.size(); ++level) {
+        const std::vector<Polynomial>& nodes = levels[level];
+        const std::vector<Polynomial>& parents = levels[level + 1];
+        rev_inverses[level].resize(nodes.size());
+
+        Parallel::parallel_for(0, nodes.size(), [&](size_t lo, size_t hi) {
+            for (size_t j = lo; j < hi; ++j) {
+                const Polynomial& node = nodes[j];
+                size_t k = parents[j / 2].deg() - node.deg();
+                if (k == 0 || static_cast<size_t>(node.deg()) < NEWTON_NODE_DEGREE) continue;
+                rev_inverses[level][j] = Polynomial::inverse_mod_xk(
+                    Polynomial::reverse(node, node.coeffs.size()), k);
+            }
+        });
+    }
+}
+
+std::vector<Fr> SubproductTree::evaluate(const Polynomial& f) const {
+    std::vector<Fr> result(points.size(), Fr());
+    if (f.is_zero()) return result;
+
+    std::call_once(inverses_once, [this] { compute_inverses(); });
+
+    Polynomial Q, R;
+    Polynomial::divrem(f, vanishing(), Q, R);
+
+    std::vector<Polynomial> rems = {R};
+    for (size_t level = levels.size() - 1; level-- > 0;) {
+        const std::vector<Polynomial>& nodes = levels[level];
+        std::vector<Polynomial> next(nodes.size());
+
+        Parallel::parallel_for(0, nodes.size(), [&](size_t lo, size_t hi) {
+            for (size_t j = lo; j < hi; ++j) {
+                const Polynomial& parent = rems[j / 2];
+                Polynomial q;
+                if (parent.deg() < nodes[j].deg()) {
+                    next[j] = parent;
+                } else if (!rev_inverses[level][j].is_zero()) {
+                    Polynomial::divrem_with_inverse(parent, nodes[j], rev_inverses[level][j], q, next[j]);
+                } else {
+                    Polynomial::divrem(parent, nodes[j], q, next[j]);
+                }
+            }
+        });
+
+        rems = std::move(next);
+    }
+
+    Parallel::parallel_for(0, rems.size(), [&](size_t lo, size_t hi) {
+        for (size_t j = lo; j < hi; ++j) {
+            for (size_t i = node_begin(0, j); i < node_end(0, j); ++i) {
+                result[i] = rems[j].evaluate(points[i]);
+            }
+        }
+    }, 4);
+
+    return result;
+}
+
+void SubproductTree::compute_weights() const {
+    const Polynomial& M = vanishing();
+
+    std::vector<Fr> d_coeffs;
+    d_coeffs.reserve(M.coeffs.size());
+    for (size_t i = 1; i < M.coeffs.size(); ++i) {
+        d_coeffs.push_back(M.coeffs[i] * Fr(i));
+    }
+
+    inv_weights = evaluate(Polynomial(d_coeffs));
+    // M'(x_i) vanishes exactly when x_i repeats, and batch_inverse would skip it.
+    for (const Fr& w : inv_weights) {
+        if (w.is_zero()) throw std::invalid_argument("Interpolation points must be distinct");
+    }
+    Fr::batch_inverse(inv_weights);
+}
+
+Polynomial SubproductTree::interpolate(const std::vector<Fr>& values) const {
+    ZK_ASSERT(values.size() == points.size(), "Points and values size mismatch");
+    std::call_once(weights_once, [this] { compute_weights(); });
+
+    // f = sum_i c_i * M(X) / (X - x_i) with c_i = y_i / M'(x_i), combined bottom-up:
+    // node = left * M_right + right * M_left.
+    std::vector<Polynomial> acc(levels[0].size());
+
+    Parallel::parallel_for(0, acc.size(), [&](size_t lo, size_t hi) {
+        for (size_t j = lo; j < hi; ++j) {
+            const std::vector<Fr>& m = levels[0][j].coeffs;
+            std::vector<Fr> sum(m.size() - 1, Fr());
+            std::vector<Fr> q(m.size() - 1, Fr());
+
+            for (size_t i = node_begin(0, j); i < node_end(0, j); ++i) {
+                Fr c = values[i] * inv_weights[i];
+                if (c.is_zero()) continue;
+
+                // Synthetic division m / (X - x_i)
+                q.back() = m.back();
+                for (size_t k = q.size() - 1; k-- > 0;) {
+                    q[k] = m[k + 1] + points[i] * q[k + 1];
+                }
+                for (size_t k = 0; k < q.size(); ++k) {
+                    sum[k] = sum[k] + c * q[k];
+                }
+            }
+            acc[j] = Polynomial(sum);
+        }
+    }, 4);
+
+    for (size_t level = 0; level + 1 < levels.size(); ++level) {
+        const std::vector<Polynomial>& nodes = levels[level];
+        std::vector<Polynomial> next(levels[level + 1].size());
+
+        Parallel::parallel_for(0, next.size(), [&](size_t lo, size_t hi) {
+            for (size_t j = lo; j < hi; ++j) {
+                if (2 * j + 1 < nodes.size()) {
+                    next[j] = Polynomial::add(Polynomial::mul(acc[2 * j], nodes[2 * j + 1]),
+                                              Polynomial::mul(acc[2 * j + 1], nodes[2 * j]));
+                } else {
+                    next[j] = std::move(acc[2 * j]);
+                }
+            }
+        });
+
+        acc = std::move(next);
+    }
+
+    return acc[0];
+}
+
+}
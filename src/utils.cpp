@@ -3,12 +3,26 @@
 #include <iomanip>
 #include <sstream>
 #include <cstring>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <fstream>
+#include <stdexcept>
 
 #ifdef __linux__
 #include <sys/resource.h>
 #include <unistd.h>
 #endif
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ZKMINI_HAVE_MMAP 1
+#endif
+
 namespace zkmini {
 ProgressBar::ProgressBar(size_t total, const std::string& description) 
     : total(total), last_printed(0), description(description) {
@@ -109,6 +123,73 @@ uint64_t BitUtils::reverse_bits(uint64_t x) {
     return (x >> 32) | (x << 32);
 }
 
+size_t Parallel::num_threads() {
+    static const size_t threads = [] {
+        if (const char* env = std::getenv("ZKMINI_THREADS")) {
+            long v = std::atol(env);
+            if (v > 0) return static_cast<size_t>(v);
+        }
+        size_t hw = std::thread::hardware_concurrency();
+        return hw == 0 ? size_t(1) : hw;
+    }();
+    return threads;
+}
+
+namespace {
+thread_local bool in_parallel_region = false;
+
+// Marks the calling thread as inside a parallel body; restored even if it throws.
+struct ParallelRegion {
+    bool saved;
+    ParallelRegion() : saved(in_parallel_region) { in_parallel_region = true; }
+    ~ParallelRegion() { in_parallel_region = saved; }
+};
+}
+
+void Parallel::parallel_for(size_t begin, size_t end,
+                            const std::function<void(size_t, size_t)>& body,
+                            size_t min_chunk) {
+    if (end <= begin) return;
+    
+    // Nested calls run inline so an outer split does not multiply thread counts.
+    size_t total = end - begin;
+    size_t chunks = std::min(num_threads(), total / std::max<size_t>(min_chunk, 1));
+    if (chunks <= 1 || in_parallel_region) {
+        body(begin, end);
+        return;
+    }
+    
+    // The first exception from any chunk is rethrown here once every worker joined.
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto run = [&](size_t lo, size_t hi) {
+        ParallelRegion region;
+        try {
+            body(lo, hi);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) error = std::current_exception();
+        }
+    };
+    
+    size_t chunk_size = (total + chunks - 1) / chunks;
+    std::vector<std::thread> workers;
+    workers.reserve(chunks - 1);
+    
+    for (size_t c = 1; c < chunks; ++c) {
+        size_t lo = begin + c * chunk_size;
+        size_t hi = std::min(end, lo + chunk_size);
+        if (lo >= hi) break;
+        workers.emplace_back(run, lo, hi);
+    }
+    run(begin, std::min(end, begin + chunk_size));
+    
+    for (auto& t : workers) {
+        t.join();
+    }
+    if (error) std::rethrow_exception(error);
+}
+
 std::string StringUtils::bytes_to_hex(const std::vector<uint8_t>& bytes) {
     std::ostringstream oss;
     oss << std::hex << std::setfill('0');
@@ -163,4 +244,77 @@ std::string StringUtils::join(const std::vector<std::string>& strings, const std
     return oss.str();
 }
 
-} 
\ No newline at end of file
+MappedFile::MappedFile(const std::string& path) : ptr(nullptr), len(0), mapped(false) {
+#ifdef ZKMINI_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat file: " + path);
+    }
+    len = static_cast<size_t>(st.st_size);
+    if (len > 0) {
+        void* addr = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map file: " + path);
+        }
+        ::madvise(addr, len, MADV_SEQUENTIAL);
+        ptr = static_cast<const uint8_t*>(addr);
+        mapped = true;
+    }
+    ::close(fd);
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    buffer.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0, std::ios::beg);
+    file.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+    ptr = buffer.data();
+    len = buffer.size();
+#endif
+}
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : ptr(other.ptr), len(other.len), mapped(other.mapped), buffer(std::move(other.buffer)) {
+    other.ptr = nullptr;
+    other.len = 0;
+    other.mapped = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        ptr = other.ptr;
+        len = other.len;
+        mapped = other.mapped;
+        buffer = std::move(other.buffer);
+        other.ptr = nullptr;
+        other.len = 0;
+        other.mapped = false;
+    }
+    return *this;
+}
+
+void MappedFile::release() {
+#ifdef ZKMINI_HAVE_MMAP
+    if (mapped) {
+        ::munmap(const_cast<uint8_t*>(ptr), len);
+    }
+#endif
+    ptr = nullptr;
+    len = 0;
+    mapped = false;
+    buffer.clear();
+}
+
+}
@@ -0,0 +1,347 @@
+#include "zkmini/witness.hpp"
+#include "zkmini/utils.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace zkmini {
+
+namespace {
+
+// Operand rows index wires, whose count is not known while recording; the column
+// bound only has to keep indices 32-bit.
+constexpr size_t MAX_WIRES = std::numeric_limits<uint32_t>::max();
+
+// Levels smaller than this run inline: a deep, narrow circuit would otherwise pay a
+// thread hand-off per instruction.
+constexpr size_t LEVEL_CHUNK = 256;
+
+uint32_t wire32(VarIdx v) {
+    ZK_ASSERT(v < MAX_WIRES, "Wire index does not fit in 32 bits");
+    return static_cast<uint32_t>(v);
+}
+
+}
+
+WitnessProgram::WitnessProgram() : operands(MAX_WIRES), assigned(1, true), n_public(0), n_private(0),
+                                   n_divisions(0) {}
+
+uint32_t WitnessProgram::record_operand(const LinearCombination& L) {
+    for (const auto& term : L) {
+        ZK_ASSERT(term.idx < assigned.size() && assigned[term.idx], "Operand reads a wire not computed yet");
+        operands.push_term(term.idx, term.coeff);
+    }
+    operands.close_row();
+    return static_cast<uint32_t>(operands.num_rows() - 1);
+}
+
+void WitnessProgram::claim(VarIdx dst) {
+    ZK_ASSERT(dst > 0, "The constant wire is not assignable");
+    wire32(dst);
+    if (dst >= assigned.size()) assigned.resize(dst + 1, false);
+    ZK_ASSERT(!assigned[dst], "Wire assigned twice");
+    assigned[dst] = true;
+}
+
+void WitnessProgram::public_input(VarIdx dst, size_t slot) {
+    claim(dst);
+    n_public = std::max(n_public, slot + 1);
+    code.push_back({Op::PublicInput, static_cast<uint32_t>(slot), wire32(dst), 0, 0});
+}
+
+void WitnessProgram::private_input(VarIdx dst, size_t slot) {
+    claim(dst);
+    n_private = std::max(n_private, slot + 1);
+    code.push_back({Op::PrivateInput, static_cast<uint32_t>(slot), wire32(dst), 0, 0});
+}
+
+void WitnessProgram::linear(VarIdx dst, const LinearCombination& L) {
+    uint32_t a = record_operand(L);
+    claim(dst);
+    code.push_back({Op::Linear, 0, wire32(dst), a, 0});
+}
+
+void WitnessProgram::mul(VarIdx dst, const LinearCombination& a, const LinearCombination& b) {
+    uint32_t ra = record_operand(a);
+    uint32_t rb = record_operand(b);
+    claim(dst);
+    code.push_back({Op::Mul, 0, wire32(dst), ra, rb});
+}
+
+void WitnessProgram::div(VarIdx dst, const LinearCombination& a, const LinearCombination& b) {
+    uint32_t ra = record_operand(a);
+    uint32_t rb = record_operand(b);
+    claim(dst);
+    code.push_back({Op::Div, 0, wire32(dst), ra, rb});
+    ++n_divisions;
+}
+
+void WitnessProgram::bit(VarIdx dst, const LinearCombination& L, uint32_t bit) {
+    ZK_ASSERT(bit < 256, "Bit index out of range");
+    uint32_t a = record_operand(L);
+    claim(dst);
+    code.push_back({Op::Bit, bit, wire32(dst), a, 0});
+}
+
+void WitnessProgram::hint(const std::vector<VarIdx>& outputs, const std::vector<VarIdx>& inputs, HintFn fn) {
+    ZK_ASSERT(!outputs.empty(), "Hint without outputs");
+    Hint h = {std::move(fn), hint_wires.size(), static_cast<uint32_t>(outputs.size()),
+              static_cast<uint32_t>(inputs.size())};
+    for (VarIdx v : inputs) {
+        ZK_ASSERT(v < assigned.size() && assigned[v], "Hint reads a wire not computed yet");
+    }
+    for (VarIdx v : outputs) {
+        claim(v);
+        hint_wires.push_back(wire32(v));
+    }
+    for (VarIdx v : inputs) hint_wires.push_back(wire32(v));
+
+    code.push_back({Op::Hint, static_cast<uint32_t>(hints.size()), wire32(outputs[0]), 0, 0});
+    hints.push_back(std::move(h));
+}
+
+bool WitnessProgram::is_complete() const {
+    return std::find(assigned.begin(), assigned.end(), false) == assigned.end();
+}
+
+void WitnessProgram::execute(const Instruction& ins, const std::vector<Fr>& public_inputs,
+                             const std::vector<Fr>& private_inputs, std::vector<Fr>& w) const {
+    switch (ins.op) {
+    case Op::PublicInput:
+        w[ins.dst] = public_inputs[ins.arg];
+        break;
+    case Op::PrivateInput:
+        w[ins.dst] = private_inputs[ins.arg];
+        break;
+    case Op::Linear:
+        w[ins.dst] = operands.row_dot(ins.a, w);
+        break;
+    case Op::Mul:
+        w[ins.dst] = operands.row_dot(ins.a, w) * operands.row_dot(ins.b, w);
+        break;
+    case Op::Div: {
+        Fr den = operands.row_dot(ins.b, w);
+        w[ins.dst] = den.is_zero() ? Fr(0) : operands.row_dot(ins.a, w) * den.inverse();
+        break;
+    }
+    case Op::Bit: {
+        Fr v = operands.row_dot(ins.a, w);
+        w[ins.dst] = Fr((v.data[ins.arg / 64] >> (ins.arg % 64)) & 1);
+        break;
+    }
+    case Op::Hint: {
+        const Hint& h = hints[ins.arg];
+        const uint32_t* wires = hint_wires.data() + h.begin;
+        std::vector<Fr> in(h.n_in);
+        std::vector<Fr> out(h.n_out);
+        for (uint32_t i = 0; i < h.n_in; ++i) in[i] = w[wires[h.n_out + i]];
+        h.fn(in, out);
+        ZK_ASSERT(out.size() == h.n_out, "Hint resized its outputs");
+        for (uint32_t i = 0; i < h.n_out; ++i) w[wires[i]] = out[i];
+        break;
+    }
+    }
+}
+
+void WitnessProgram::run_levels(const std::vector<Fr>& public_inputs,
+                                const std::vector<Fr>& private_inputs, std::vector<Fr>& w,
+                                bool threaded) const {
+    // Depth of each instruction: inputs at 0, everything else one past its deepest
+    // operand. Divisions sort after the rest of their level.
+    std::vector<uint32_t> wire_level(num_wires(), 0);
+    std::vector<uint32_t> level(code.size(), 0);
+    const uint32_t* row_ptr = operands.row_ptr_data();
+    const uint32_t* col_idx = operands.col_idx_data();
+    uint32_t depth = 0;
+
+    auto deepest = [&](uint32_t row, uint32_t d) {
+        for (uint32_t e = row_ptr[row]; e < row_ptr[row + 1]; ++e) d = std::max(d, wire_level[col_idx[e]]);
+        return d;
+    };
+
+    for (size_t i = 0; i < code.size(); ++i) {
+        const Instruction& ins = code[i];
+        uint32_t d = 0;
+        switch (ins.op) {
+        case Op::PublicInput:
+        case Op::PrivateInput:
+            break;
+        case Op::Linear:
+        case Op::Bit:
+            d = deepest(ins.a, 0) + 1;
+            break;
+        case Op::Mul:
+        case Op::Div:
+            d = deepest(ins.b, deepest(ins.a, 0)) + 1;
+            break;
+        case Op::Hint: {
+            const Hint& h = hints[ins.arg];
+            const uint32_t* wires = hint_wires.data() + h.begin;
+            for (uint32_t k = 0; k < h.n_in; ++k) d = std::max(d, wire_level[wires[h.n_out + k]]);
+            ++d;
+            for (uint32_t k = 0; k < h.n_out; ++k) wire_level[wires[k]] = d;
+            break;
+        }
+        }
+        wire_level[ins.dst] = d;
+        level[i] = d;
+        depth = std::max(depth, d);
+    }
+
+    // Counting sort by (level, is division), stable so each level keeps recording order.
+    size_t buckets = 2 * (size_t(depth) + 1);
+    std::vector<size_t> start(buckets + 1, 0);
+    auto bucket = [&](size_t i) { return 2 * size_t(level[i]) + (code[i].op == Op::Div ? 1 : 0); };
+    for (size_t i = 0; i < code.size(); ++i) start[bucket(i) + 1]++;
+    for (size_t k = 0; k < buckets; ++k) start[k + 1] += start[k];
+    std::vector<uint32_t> order(code.size());
+    std::vector<size_t> next(start.begin(), start.end() - 1);
+    for (size_t i = 0; i < code.size(); ++i) order[next[bucket(i)]++] = static_cast<uint32_t>(i);
+
+    auto each = [threaded](size_t lo, size_t hi, const std::function<void(size_t, size_t)>& body) {
+        if (threaded) {
+            Parallel::parallel_for(lo, hi, body, LEVEL_CHUNK);
+        } else {
+            body(lo, hi);
+        }
+    };
+    
+    std::vector<Fr> dens;
+    for (size_t k = 0; k < buckets; k += 2) {
+        each(start[k], start[k + 1], [&](size_t lo, size_t hi) {
+            for (size_t j = lo; j < hi; ++j) execute(code[order[j]], public_inputs, private_inputs, w);
+        });
+
+        size_t div_begin = start[k + 1];
+        size_t div_end = start[k + 2];
+        if (div_begin == div_end) continue;
+        dens.resize(div_end - div_begin);
+        each(div_begin, div_end, [&](size_t lo, size_t hi) {
+            for (size_t j = lo; j < hi; ++j) dens[j - div_begin] = operands.row_dot(code[order[j]].b, w);
+        });
+        Fr::batch_inverse(dens);
+        each(div_begin, div_end, [&](size_t lo, size_t hi) {
+            for (size_t j = lo; j < hi; ++j) {
+                const Instruction& ins = code[order[j]];
+                const Fr& inv = dens[j - div_begin];
+                w[ins.dst] = inv.is_zero() ? Fr(0) : operands.row_dot(ins.a, w) * inv;
+            }
+        });
+    }
+}
+
+std::vector<Fr> WitnessProgram::run(const std::vector<Fr>& public_inputs,
+                                    const std::vector<Fr>& private_inputs, bool parallel) const {
+    if (public_inputs.size() != n_public || private_inputs.size() != n_private) {
+        throw std::invalid_argument("Witness program expects " + std::to_string(n_public) +
+                                    " public and " + std::to_string(n_private) + " private inputs, got " +
+                                    std::to_string(public_inputs.size()) + " and " +
+                                    std::to_string(private_inputs.size()));
+    }
+    ZK_ASSERT(is_complete(), "Witness program leaves wires unassigned");
+
+    std::vector<Fr> w(num_wires());
+    w[0] = Fr(1);
+    // Inverting one division at a time costs a full exponentiation each; with more
+    // than one, the level schedule pays for itself even on one thread.
+    if (parallel || n_divisions > 1) {
+        run_levels(public_inputs, private_inputs, w, parallel);
+    } else {
+        for (const Instruction& ins : code) execute(ins, public_inputs, private_inputs, w);
+    }
+    return w;
+}
+
+CircuitBuilder::CircuitBuilder() : n_public_in(0), n_private_in(0), private_started(false) {}
+
+VarIdx CircuitBuilder::allocate() {
+    private_started = true;
+    return system.allocate_var();
+}
+
+VarIdx CircuitBuilder::public_input() {
+    ZK_ASSERT(!private_started, "Public wires must be allocated before any other wire");
+    VarIdx v = system.allocate_var();
+    system.mark_public(v);
+    prog.public_input(v, n_public_in++);
+    return v;
+}
+
+VarIdx CircuitBuilder::public_output() {
+    ZK_ASSERT(!private_started, "Public wires must be allocated before any other wire");
+    VarIdx v = system.allocate_var();
+    system.mark_public(v);
+    return v;
+}
+
+VarIdx CircuitBuilder::private_input() {
+    VarIdx v = allocate();
+    prog.private_input(v, n_private_in++);
+    return v;
+}
+
+VarIdx CircuitBuilder::mul(const LinearCombination& a, const LinearCombination& b) {
+    VarIdx out = allocate();
+    prog.mul(out, a, b);
+    system.add_constraint(a, b, R1CS::lc_var(out));
+    return out;
+}
+
+VarIdx CircuitBuilder::linear(const LinearCombination& L) {
+    VarIdx out = allocate();
+    set_output(out, L);
+    return out;
+}
+
+void CircuitBuilder::set_output(VarIdx out, const LinearCombination& L) {
+    prog.linear(out, L);
+    system.add_lin_eq(L, R1CS::lc_var(out));
+}
+
+VarIdx CircuitBuilder::inverse(const LinearCombination& a) {
+    VarIdx out = allocate();
+    prog.div(out, R1CS::lc_const(Fr(1)), a);
+    system.add_constraint(a, R1CS::lc_var(out), R1CS::lc_const(Fr(1)));
+    return out;
+}
+
+std::vector<VarIdx> CircuitBuilder::to_bits(const LinearCombination& a, size_t n) {
+    ZK_ASSERT(n > 0 && n <= 253, "Bit decomposition must fit below the modulus");
+
+    std::vector<VarIdx> bits(n);
+    LinearCombination sum;
+    sum.reserve(n);
+    Fr weight(1);
+    for (size_t i = 0; i < n; ++i) {
+        bits[i] = allocate();
+        prog.bit(bits[i], a, static_cast<uint32_t>(i));
+        // b * (b - 1) = 0
+        system.add_constraint(R1CS::lc_var(bits[i]),
+                              R1CS::lc_from_terms({Term(bits[i], Fr(1)), Term(0, Fr(0) - Fr(1))}),
+                              LinearCombination());
+        sum.push_back(Term(bits[i], weight));
+        weight = weight + weight;
+    }
+    system.add_lin_eq(sum, a);
+    return bits;
+}
+
+void CircuitBuilder::assert_equal(const LinearCombination& a, const LinearCombination& b) {
+    system.add_lin_eq(a, b);
+}
+
+std::vector<VarIdx> CircuitBuilder::hint(size_t n_out, const std::vector<VarIdx>& inputs,
+                                         WitnessProgram::HintFn fn) {
+    std::vector<VarIdx> outputs(n_out);
+    for (auto& v : outputs) v = allocate();
+    prog.hint(outputs, inputs, std::move(fn));
+    return outputs;
+}
+
+std::vector<Fr> CircuitBuilder::witness(const std::vector<Fr>& public_inputs,
+                                        const std::vector<Fr>& private_inputs, bool parallel) const {
+    ZK_ASSERT(prog.num_wires() == system.num_variables(), "Witness program and R1CS disagree on wires");
+    return prog.run(public_inputs, private_inputs, parallel);
+}
+
+}
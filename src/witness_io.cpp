@@ -0,0 +1,149 @@
+#include "zkmini/witness.hpp"
+#include "zkmini/utils.hpp"
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace zkmini {
+
+namespace {
+
+// Layout (all integers little-endian):
+//   "wtns" | version u32 | n_sections u32 | { type u32 | size u64 | payload }*
+//   header: field_size u32 | prime | n_witness u32
+//   values: n_witness field elements, field_size bytes each
+constexpr uint32_t WTNS_VERSION = 2;
+constexpr uint32_t SECTION_HEADER = 1;
+constexpr uint32_t SECTION_VALUES = 2;
+constexpr size_t FIELD_BYTES = 32;
+
+// Elements per parallel work item.
+constexpr size_t COPY_CHUNK = 1 << 16;
+
+static_assert(sizeof(Fr) == FIELD_BYTES, "Fr must be four packed limbs to be copied directly");
+
+uint32_t load_u32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+uint64_t load_u64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+void put_u32(uint8_t* p, uint32_t v) {
+    std::memcpy(p, &v, sizeof(v));
+}
+
+void put_u64(uint8_t* p, uint64_t v) {
+    std::memcpy(p, &v, sizeof(v));
+}
+
+struct Section {
+    const uint8_t* data = nullptr;
+    uint64_t size = 0;
+};
+
+void require(bool ok, const char* message) {
+    if (!ok) throw std::runtime_error(std::string("Invalid .wtns file: ") + message);
+}
+
+}
+
+std::vector<Fr> WitnessFile::parse(const uint8_t* data, size_t size) {
+    require(size >= 12 && std::memcmp(data, "wtns", 4) == 0, "bad magic");
+    uint32_t version = load_u32(data + 4);
+    require(version == 1 || version == WTNS_VERSION, "unsupported version");
+    uint32_t n_sections = load_u32(data + 8);
+
+    Section header, values;
+    const uint8_t* p = data + 12;
+    const uint8_t* end = data + size;
+    for (uint32_t s = 0; s < n_sections; ++s) {
+        require(end - p >= 12, "truncated section header");
+        uint32_t type = load_u32(p);
+        uint64_t len = load_u64(p + 4);
+        p += 12;
+        require(static_cast<uint64_t>(end - p) >= len, "truncated section");
+        if (type == SECTION_HEADER) header = {p, len};
+        else if (type == SECTION_VALUES) values = {p, len};
+        p += len;
+    }
+    require(header.data != nullptr, "missing header section");
+    require(values.data != nullptr, "missing values section");
+
+    const uint8_t* h = header.data;
+    require(header.size == 4 + FIELD_BYTES + 4 && load_u32(h) == FIELD_BYTES, "field size is not 32 bytes");
+    for (size_t i = 0; i < 4; ++i) {
+        require(load_u64(h + 4 + 8 * i) == bn254_fr::MODULUS_BN254[i], "prime is not the BN254 scalar field");
+    }
+    uint64_t n_witness = load_u32(h + 4 + FIELD_BYTES);
+    require(values.size == n_witness * FIELD_BYTES, "values section does not match witness count");
+
+    // The encoding is Fr's own limb layout, so each chunk is one copy plus a range check.
+    std::vector<Fr> w(n_witness);
+    std::atomic<bool> out_of_range(false);
+    Parallel::parallel_for(0, n_witness, [&](size_t lo, size_t hi) {
+        std::memcpy(static_cast<void*>(w.data() + lo), values.data + lo * FIELD_BYTES, (hi - lo) * FIELD_BYTES);
+        for (size_t i = lo; i < hi; ++i) {
+            if (!w[i].is_valid()) {
+                out_of_range.store(true, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }, COPY_CHUNK);
+    require(!out_of_range.load(), "value not below the field modulus");
+
+    return w;
+}
+
+std::vector<Fr> WitnessFile::load(const std::string& path) {
+    MappedFile file(path);
+    return parse(file.data(), file.size());
+}
+
+std::vector<uint8_t> WitnessFile::encode(const std::vector<Fr>& witness) {
+    ZK_ASSERT(witness.size() <= UINT32_MAX, "Too many wires for the .wtns format");
+
+    const size_t header_bytes = 4 + FIELD_BYTES + 4;
+    const size_t values_bytes = witness.size() * FIELD_BYTES;
+    std::vector<uint8_t> out(12 + 12 + header_bytes + 12 + values_bytes);
+
+    uint8_t* p = out.data();
+    std::memcpy(p, "wtns", 4);
+    put_u32(p + 4, WTNS_VERSION);
+    put_u32(p + 8, 2);
+    p += 12;
+
+    put_u32(p, SECTION_HEADER);
+    put_u64(p + 4, header_bytes);
+    p += 12;
+    put_u32(p, FIELD_BYTES);
+    for (size_t i = 0; i < 4; ++i) put_u64(p + 4 + 8 * i, bn254_fr::MODULUS_BN254[i]);
+    put_u32(p + 4 + FIELD_BYTES, static_cast<uint32_t>(witness.size()));
+    p += header_bytes;
+
+    put_u32(p, SECTION_VALUES);
+    put_u64(p + 4, values_bytes);
+    p += 12;
+    Parallel::parallel_for(0, witness.size(), [&](size_t lo, size_t hi) {
+        std::memcpy(p + lo * FIELD_BYTES, static_cast<const void*>(witness.data() + lo), (hi - lo) * FIELD_BYTES);
+    }, COPY_CHUNK);
+
+    return out;
+}
+
+void WitnessFile::save(const std::string& path, const std::vector<Fr>& witness) {
+    std::vector<uint8_t> bytes = encode(witness);
+    std::ofstream out(path, std::ios::binary);
+    if (!out) throw std::runtime_error("Cannot open file for writing: " + path);
+    out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    out.flush();
+    if (!out) throw std::runtime_error("Failed writing witness file: " + path);
+}
+
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "zkmini/r1cs.hpp"
+#include <vector>
+
+// Circuits shared by the tests.
+
+// out = x^3 + x + 5 with out public (wire 1) and x private; returns the full witness for x.
+inline zkmini::R1CS cubic_circuit(const zkmini::Fr& x, std::vector<zkmini::Fr>& witness) {
+    using namespace zkmini;
+    R1CS r;
+    VarIdx out = r.allocate_var();
+    VarIdx vx = r.allocate_var();
+    VarIdx sq = r.allocate_var();
+    VarIdx cube = r.allocate_var();
+    r.mark_public(out);
+    
+    r.add_mul(vx, vx, sq);
+    r.add_mul(sq, vx, cube);
+    r.add_lin_eq(R1CS::lc_from_terms({Term(cube, 1), Term(vx, 1), Term(0, 5)}), R1CS::lc_var(out));
+    
+    Fr x_sq = x * x;
+    Fr x_cube = x_sq * x;
+    witness = {Fr(1), x_cube + x + Fr(5), x, x_sq, x_cube};
+    return r;
+}
@@ -1,8 +1,10 @@
 #include "zkmini/g1.hpp"
 #include "zkmini/g2.hpp"
+#include "zkmini/serialization.hpp"
 #include "zkmini/utils.hpp"
 #include <iostream>
 #include <cassert>
+#include <stdexcept>
 
 using namespace zkmini;
 
@@ -123,6 +125,61 @@ void test_curve_properties() {
     std::cout << "Curve properties test passed!" << std::endl;
 }
 
+static bool rejects_g1(std::vector<uint8_t> bytes) {
+    try {
+        Serialization::decompress_g1(bytes.data());
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+void test_square_roots() {
+    std::cout << "Testing Fq and Fq2 square roots..." << std::endl;
+    
+    for (uint64_t v = 0; v < 200; ++v) {
+        Fq a = Fq(v) * Fq(v + 7) + Fq(v * 31);
+        Fq r;
+        if (a.sqrt(r)) {
+            assert(r.square() == a);
+        } else {
+            // Exactly one of a and -a is a square when a != 0, since p = 3 mod 4.
+            assert((Fq() - a).sqrt(r));
+        }
+        Fq sq = a.square();
+        assert(sq.sqrt(r) && (r == a || r == Fq() - a));
+        
+        Fq2 b(a, Fq(v * v + 1));
+        Fq2 r2;
+        Fq2 b_sq = b.square();
+        assert(b_sq.sqrt(r2) && (r2 == b || r2 == Fq2() - b));
+        if (b.sqrt(r2)) assert(r2.square() == b);
+    }
+    
+    // Purely real and purely imaginary inputs take the c1 = 0 branch.
+    Fq2 r2;
+    assert(Fq2(Fq(0) - Fq(4), Fq()).sqrt(r2) && r2.square() == Fq2(Fq(0) - Fq(4), Fq()));
+    assert(Fq2(Fq(), Fq(2)).sqrt(r2) && r2.square() == Fq2(Fq(), Fq(2)));
+    
+    // batch_sqrt agrees with sqrt, across both branches, and fails on a non-square.
+    std::vector<Fq2> squares;
+    for (uint64_t v = 0; v < 50; ++v) squares.push_back(Fq2(Fq(v * 13 + 2), Fq(v % 5 == 0 ? 0 : v)).square());
+    std::vector<Fq2> roots = squares;
+    assert(Fq2::batch_sqrt(roots));
+    for (size_t i = 0; i < squares.size(); ++i) {
+        assert(squares[i].sqrt(r2) && roots[i] == r2);
+    }
+    Fq2 non_square(Fq(1), Fq(1));
+    while (non_square.sqrt(r2)) non_square = non_square + Fq2(Fq(1), Fq());
+    squares[17] = non_square;
+    assert(!Fq2::batch_sqrt(squares));
+    
+    assert(!Fq(1).is_lexicographically_largest());
+    assert((Fq() - Fq(1)).is_lexicographically_largest());
+    
+    std::cout << "Square root test passed!" << std::endl;
+}
+
 void test_point_compression() {
     std::cout << "Testing point compression..." << std::endl;
     
@@ -132,12 +189,88 @@ void test_point_compression() {
     // Convert to affine and back
     auto [x1, y1] = gen1.to_affine();
     G1 reconstructed1(x1, y1);
-    // TODO: Enable when point operations are fully implemented
-    // assert(reconstructed1 == gen1);
+    assert(reconstructed1 == gen1);
     
     auto [x2, y2] = gen2.to_affine();
     G2 reconstructed2(x2, y2);
-    // assert(reconstructed2 == gen2);
+    assert(reconstructed2 == gen2);
+    
+    // Both signs of y, infinity, and the fixed sizes.
+    std::vector<G1> g1_points = {G1(), gen1, gen1.negate(), gen1 * Fr(12345), gen1 * Fr::random()};
+    for (const G1& p : g1_points) {
+        std::vector<uint8_t> bytes = Serialization::serialize_g1_compressed(p);
+        assert(bytes.size() == 32);
+        size_t offset = 0;
+        assert(Serialization::deserialize_g1_compressed(bytes, offset) == p && offset == 32);
+    }
+    std::vector<G2> g2_points = {G2(), gen2, gen2.negate(), gen2 * Fr(777), gen2 * Fr::random()};
+    for (const G2& p : g2_points) {
+        std::vector<uint8_t> bytes = Serialization::serialize_g2_compressed(p);
+        assert(bytes.size() == 64);
+        size_t offset = 0;
+        assert(Serialization::deserialize_g2_compressed(bytes, offset) == p && offset == 64);
+    }
+    
+    // Batch round trip through the parallel path.
+    std::vector<G1> many;
+    G1 acc = gen1;
+    for (int i = 0; i < 1000; ++i) {
+        many.push_back(i % 97 == 0 ? G1() : acc);
+        acc = acc + gen1 * Fr(3);
+    }
+    std::vector<G1Affine> affine = G1::batch_normalize(many);
+    std::vector<uint8_t> packed = Serialization::compress_g1_batch(affine);
+    assert(packed.size() == 32 * affine.size());
+    assert(Serialization::decompress_g1_batch(packed.data(), affine.size()) == affine);
+    
+    std::vector<G2> many2;
+    G2 acc2 = gen2;
+    for (int i = 0; i < 600; ++i) {
+        many2.push_back(i % 89 == 0 ? G2() : acc2);
+        acc2 = acc2 + gen2;
+    }
+    std::vector<G2Affine> affine2 = G2::batch_normalize(many2);
+    // Multiples of the generator have real coordinates; these take the inverting branch.
+    for (uint64_t k = 1; k < 200; ++k) {
+        G2Affine p;
+        if (G2Affine::from_x(Fq2(Fq(k), Fq(k * k + 5)), k & 1, p)) affine2.push_back(p);
+    }
+    std::vector<uint8_t> packed2 = Serialization::compress_g2_batch(affine2);
+    assert(Serialization::decompress_g2_batch(packed2.data(), affine2.size()) == affine2);
+    
+    // One point off the curve fails the whole batch.
+    Fq2 r_off;
+    Fq2 x_off(Fq(1), Fq(1));
+    while ((x_off * x_off * x_off + Fq2(Fq(3), Fq())).sqrt(r_off)) x_off = x_off + Fq2(Fq(1), Fq());
+    Serialization::compress_g2(G2Affine(x_off, Fq2(Fq(1), Fq())), packed2.data() + 300 * 64);
+    bool threw2 = false;
+    try {
+        Serialization::decompress_g2_batch(packed2.data(), affine2.size());
+    } catch (const std::runtime_error&) {
+        threw2 = true;
+    }
+    assert(threw2);
+    
+    // x = 0 is off the curve (3 is not a square), x = p is unreduced, and infinity
+    // must carry no other bits.
+    std::vector<uint8_t> bad(32, 0);
+    assert(rejects_g1(bad));
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 8; ++j) bad[i * 8 + j] = (Fq::MODULUS[i] >> (8 * j)) & 0xFF;
+    }
+    assert(rejects_g1(bad));
+    bad.assign(32, 0);
+    bad[31] = 0x40;
+    assert(!rejects_g1(bad));
+    bad[0] = 1;
+    assert(rejects_g1(bad));
+    bool threw = false;
+    try {
+        Serialization::decompress_g1_batch(bad.data(), 1);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
     
     std::cout << "Point compression test passed!" << std::endl;
 }
@@ -150,6 +283,7 @@ int main() {
         test_g1_scalar_multiplication();
         test_g2_basic_operations();
         test_curve_properties();
+        test_square_roots();
         test_point_compression();
         
         std::cout << "All elliptic curve tests passed!" << std::endl;
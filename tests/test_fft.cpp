@@ -0,0 +1,217 @@
+#include "zkmini/fft.hpp"
+#include "zkmini/eval_poly.hpp"
+#include "zkmini/polynomial.hpp"
+#include "zkmini/utils.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+using namespace zkmini;
+
+static std::vector<Fr> sample_coeffs(size_t n, uint64_t seed) {
+    std::vector<Fr> coeffs;
+    for (size_t i = 0; i < n; ++i) {
+        coeffs.push_back(Fr(seed * 31 + i * i + 7));
+    }
+    return coeffs;
+}
+
+void test_fft_roundtrip() {
+    std::cout << "Testing FFT/IFFT roundtrip..." << std::endl;
+    
+    for (size_t n : {1, 2, 8, 32}) {
+        FFT fft(n);
+        std::vector<Fr> coeffs = sample_coeffs(n, n);
+        
+        std::vector<Fr> evals = fft.fft(coeffs);
+        Polynomial p(coeffs);
+        for (size_t i = 0; i < n; ++i) {
+            assert(evals[i] == p.evaluate(fft.get_root_of_unity(i)));
+        }
+        
+        assert(fft.ifft(evals) == coeffs);
+    }
+    
+    std::cout << "FFT/IFFT roundtrip test passed!" << std::endl;
+}
+
+void test_coset_fft() {
+    std::cout << "Testing coset FFT/IFFT..." << std::endl;
+    
+    for (size_t n : {1, 4, 16}) {
+        FFT fft(n);
+        std::vector<Fr> coeffs = sample_coeffs(n, 3);
+        Polynomial p(coeffs);
+        
+        std::vector<Fr> evals = fft.coset_fft(coeffs);
+        for (size_t i = 0; i < n; ++i) {
+            Fr x = fft.get_coset_shift() * fft.get_root_of_unity(i);
+            assert(evals[i] == p.evaluate(x));
+        }
+        
+        assert(fft.coset_ifft(evals) == coeffs);
+    }
+    
+    std::cout << "Coset FFT/IFFT test passed!" << std::endl;
+}
+
+void test_vanishing_on_coset() {
+    std::cout << "Testing vanishing polynomial on coset..." << std::endl;
+    
+    size_t n = 8;
+    FFT fft(n);
+    
+    // Z(X) = X^n - 1
+    std::vector<Fr> z_coeffs(n + 1, Fr(0));
+    z_coeffs[0] = Fr(0) - Fr(1);
+    z_coeffs[n] = Fr(1);
+    Polynomial Z(z_coeffs);
+    
+    assert(!fft.vanishing_on_coset().is_zero());
+    for (size_t i = 0; i < n; ++i) {
+        assert(Z.evaluate(fft.get_root_of_unity(i)).is_zero());
+        Fr x = fft.get_coset_shift() * fft.get_root_of_unity(i);
+        assert(Z.evaluate(x) == fft.vanishing_on_coset());
+    }
+    
+    std::cout << "Vanishing polynomial on coset test passed!" << std::endl;
+}
+
+void test_fft_batch() {
+    std::cout << "Testing batched FFT/IFFT..." << std::endl;
+    
+    size_t n = 2048;
+    FFT fft(n);
+    
+    std::vector<std::vector<Fr>> batch;
+    for (uint64_t k = 0; k < 6; ++k) {
+        batch.push_back(sample_coeffs(n - k, k));
+    }
+    std::vector<std::vector<Fr>> original = batch;
+    
+    fft.fft_batch(batch);
+    for (size_t k = 0; k < batch.size(); ++k) {
+        assert(batch[k] == fft.fft(original[k]));
+    }
+    fft.ifft_batch(batch);
+    for (size_t k = 0; k < batch.size(); ++k) {
+        std::vector<Fr> expected = original[k];
+        expected.resize(n, Fr());
+        assert(batch[k] == expected);
+    }
+    
+    fft.fft_batch(batch, true);
+    for (size_t k = 0; k < batch.size(); ++k) {
+        assert(batch[k] == fft.coset_fft(original[k]));
+    }
+    fft.ifft_batch(batch, true);
+    for (size_t k = 0; k < batch.size(); ++k) {
+        std::vector<Fr> expected = original[k];
+        expected.resize(n, Fr());
+        assert(batch[k] == expected);
+    }
+    
+    std::cout << "Batched FFT/IFFT test passed!" << std::endl;
+}
+
+void test_eval_poly() {
+    std::cout << "Testing evaluation-form polynomials..." << std::endl;
+    
+    size_t n = 64;
+    const FFT& fft = FFT::cached(n);
+    Polynomial a(sample_coeffs(n / 2, 1));
+    Polynomial b(sample_coeffs(n / 2 - 1, 2));
+    
+    EvalPoly ea = EvalPoly::from_polynomial(a, n);
+    EvalPoly eb = EvalPoly::from_polynomial(b, n);
+    assert(ea.evaluations() == fft.fft(a.coeffs));
+    assert(ea.to_polynomial() == a);
+    
+    assert((ea + eb).to_polynomial() == Polynomial::add(a, b));
+    assert((ea - eb).to_polynomial() == Polynomial::sub(a, b));
+    assert((ea * eb).to_polynomial() == Polynomial::mul(a, b));
+    assert((ea * Fr(7)).to_polynomial() == Polynomial::scalar_mul(a, Fr(7)));
+    
+    // Values written directly must invalidate the cached coefficients.
+    EvalPoly from_values(fft.fft(a.coeffs));
+    from_values.set(0, from_values[0] + Fr(1));
+    assert(!(from_values.to_polynomial() == a));
+    
+    // Coset form: same arithmetic, values at g*w^i, and conversion between domains.
+    EvalPoly ca = ea.to_domain(EvalPoly::Domain::Coset);
+    assert(ca.evaluations() == fft.coset_fft(a.coeffs));
+    std::vector<EvalPoly> coset = EvalPoly::from_polynomials({a, b}, n, EvalPoly::Domain::Coset);
+    assert(coset[0] == ca);
+    EvalPoly cab = coset[0] * coset[1];
+    assert(cab.to_polynomial() == Polynomial::mul(a, b));
+    assert(cab.to_domain(EvalPoly::Domain::Subgroup) == ea * eb);
+    
+    // (A*B - C) / (X^n - 1) computed pointwise on the coset.
+    Polynomial c(sample_coeffs(n, 3));
+    std::vector<Fr> q_coeffs = sample_coeffs(n - 1, 4);
+    std::vector<Fr> z_coeffs(n + 1, Fr(0));
+    z_coeffs[0] = Fr(0) - Fr(1);
+    z_coeffs[n] = Fr(1);
+    Polynomial ab = Polynomial::add(Polynomial::mul(Polynomial(q_coeffs), Polynomial(z_coeffs)), c);
+    std::vector<Fr> ab_low(ab.coeffs.begin(), ab.coeffs.begin() + n);
+    std::vector<Fr> ab_high(ab.coeffs.begin() + n, ab.coeffs.end());
+    // ab = ab_low + X^n * ab_high, so evaluate it as a sum of two degree < n parts.
+    EvalPoly num = EvalPoly::from_polynomial(Polynomial(ab_low), n, EvalPoly::Domain::Coset);
+    EvalPoly high = EvalPoly::from_polynomial(Polynomial(ab_high), n, EvalPoly::Domain::Coset);
+    high *= fft.get_coset_shift().pow(static_cast<uint64_t>(n));
+    num += high;
+    num -= EvalPoly::from_polynomial(c, n, EvalPoly::Domain::Coset);
+    num *= fft.vanishing_on_coset().inverse();
+    assert(num.to_polynomial() == Polynomial(q_coeffs));
+    
+    std::cout << "Evaluation-form polynomial test passed!" << std::endl;
+}
+
+void test_parallel_for_exceptions() {
+    std::cout << "Testing exceptions from parallel_for bodies..." << std::endl;
+    
+    // Thrown on a worker thread, then on the calling thread's own chunk.
+    for (size_t bad_lo : {size_t(1), size_t(0)}) {
+        bool threw = false;
+        try {
+            Parallel::parallel_for(0, 1000, [&](size_t lo, size_t) {
+                if ((bad_lo == 0) == (lo == 0)) throw std::runtime_error("bad chunk");
+            });
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    
+    // The calling thread is not left marked as inside a parallel region.
+    std::set<std::thread::id> ids;
+    std::mutex ids_mutex;
+    Parallel::parallel_for(0, 1000, [&](size_t, size_t) {
+        std::lock_guard<std::mutex> lock(ids_mutex);
+        ids.insert(std::this_thread::get_id());
+    });
+    assert(ids.size() > 1);
+    
+    std::cout << "parallel_for exception test passed!" << std::endl;
+}
+
+int main() {
+    // Exercise the threaded path even on a single-core machine.
+    setenv("ZKMINI_THREADS", "4", 0);
+    
+    std::cout << "=== FFT Tests ===" << std::endl;
+    
+    test_fft_roundtrip();
+    test_coset_fft();
+    test_vanishing_on_coset();
+    test_fft_batch();
+    test_eval_poly();
+    test_parallel_for_exceptions();
+    
+    std::cout << "\nAll FFT tests passed successfully!" << std::endl;
+    return 0;
+}
@@ -97,6 +97,56 @@ void test_fr_special_values() {
     std::cout << "Fr special values test passed!" << std::endl;
 }
 
+void test_fr_mul_accumulator() {
+    std::cout << "Testing Fr lazy-reduced accumulation..." << std::endl;
+    
+    Fr::MulAccumulator empty;
+    assert(empty.result().is_zero());
+    
+    // Near-modulus operands push the unreduced sum towards its upper bound
+    Fr max = Fr(0) - Fr(1);
+    for (size_t n : {1, 2, 7, 300}) {
+        Fr::MulAccumulator acc;
+        Fr expected;
+        for (size_t i = 0; i < n; ++i) {
+            Fr a = i % 3 == 0 ? max : Fr::random();
+            Fr b = i % 2 == 0 ? max - Fr(i) : Fr::random();
+            acc.add_product(a, b);
+            expected = expected + a * b;
+        }
+        acc.add(max);
+        expected = expected + max;
+        assert(acc.result() == expected);
+    }
+    
+    std::cout << "Fr lazy-reduced accumulation test passed!" << std::endl;
+}
+
+void test_fr_small_coefficients() {
+    std::cout << "Testing Fr small-coefficient multiply..." << std::endl;
+    
+    Fr max = Fr(0) - Fr(1);
+    for (uint64_t k : {0ULL, 1ULL, 2ULL, 1024ULL, 0xFFFFFFFFULL}) {
+        for (const Fr& a : {Fr(0), Fr(1), max, Fr::random(), Fr::random()}) {
+            assert(a.mul_small(k) == a * Fr(k));
+        }
+        
+        uint32_t magnitude;
+        bool negative;
+        assert(Fr(k).as_small(magnitude, negative) && magnitude == k && !negative);
+        if (k != 0) {
+            assert((Fr(0) - Fr(k)).as_small(magnitude, negative) && magnitude == k && negative);
+        }
+    }
+    
+    uint32_t magnitude;
+    bool negative;
+    assert(!Fr(0x100000000ULL).as_small(magnitude, negative));
+    assert(!(Fr(0) - Fr(0x100000000ULL)).as_small(magnitude, negative));
+    
+    std::cout << "Fr small-coefficient multiply test passed!" << std::endl;
+}
+
 int main() {
     try {
         std::cout << "=== Field Tests ===" << std::endl;
@@ -105,6 +155,8 @@ int main() {
         test_fr_inverse();
         test_fr_arithmetic_properties();
         test_fr_special_values();
+        test_fr_mul_accumulator();
+        test_fr_small_coefficients();
         
         std::cout << "All field tests passed!" << std::endl;
         return 0;
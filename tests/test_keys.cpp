@@ -0,0 +1,310 @@
+#include "zkmini/groth16.hpp"
+#include "zkmini/msm.hpp"
+#include "zkmini/qap.hpp"
+#include "zkmini/utils.hpp"
+#include "circuits.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+using namespace zkmini;
+
+static bool same_bytes(const G1Affine& a, const G1Affine& b) {
+    return std::memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+static bool same_bytes(const G2Affine& a, const G2Affine& b) {
+    return std::memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+template <typename Affine>
+static bool same_query(const QueryView<Affine>& mapped, const std::vector<Affine>& points) {
+    if (mapped.size() != points.size()) return false;
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (!same_bytes(mapped[i], points[i])) return false;
+    }
+    return true;
+}
+
+static bool rejects(const std::string& path, bool validate) {
+    try {
+        ProvingKey::load_mmap(path, validate);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+void test_affine_points() {
+    std::cout << "Testing affine points and mixed addition..." << std::endl;
+    
+    G1Affine inf = G1Affine(G1());
+    assert(inf.is_zero() && inf.is_reduced() && inf.is_on_curve());
+    assert(inf.to_jacobian().is_zero());
+    assert(G2Affine(G2()).to_jacobian().is_zero());
+    
+    G1 g = G1::generator();
+    G1Affine ag(g);
+    assert(ag.x == Fq(1) && ag.y == Fq(2) && ag.is_reduced() && ag.is_on_curve());
+    assert(ag.to_jacobian() == g);
+    
+    G2Affine ag2(G2::generator());
+    assert(ag2.is_reduced() && !ag2.is_zero() && ag2.is_on_curve());
+    assert(ag2.to_jacobian() == G2::generator());
+    
+    // Mixed addition against a Jacobian accumulator, including P + P, P - P and 0 + P.
+    G1 p = g * Fr(7);
+    G1Affine q(g * Fr(11));
+    assert(p + q == g * Fr(18));
+    assert(G1() + q == g * Fr(11));
+    assert(p + G1Affine() == p);
+    assert((g * Fr(11)) + q == g * Fr(22));
+    assert(((g * Fr(11)) + q.negate()).is_zero());
+    
+    G2 p2 = G2::generator() * Fr(5);
+    G2Affine q2(G2::generator() * Fr(9));
+    assert(p2 + q2 == G2::generator() * Fr(14));
+    assert((G2::generator() * Fr(9)) + q2 == G2::generator() * Fr(18));
+    assert(((G2::generator() * Fr(9)) + q2.negate()).is_zero());
+    
+    // Batch normalisation, with the point at infinity in the middle.
+    std::vector<G1> points = {g * Fr(3), G1(), g * Fr(5) + g * Fr(2), g.double_point()};
+    std::vector<G1Affine> affine = G1::batch_normalize(points);
+    assert(affine.size() == points.size() && affine[1].is_zero());
+    for (size_t i = 0; i < points.size(); ++i) {
+        assert(same_bytes(affine[i], G1Affine(points[i])));
+    }
+    std::vector<G2> points2 = {G2::generator() * Fr(4), G2(), G2::generator().double_point()};
+    std::vector<G2Affine> affine2 = G2::batch_normalize(points2);
+    for (size_t i = 0; i < points2.size(); ++i) {
+        assert(same_bytes(affine2[i], G2Affine(points2[i])));
+    }
+    assert(G1::batch_normalize({}).empty());
+    
+    // Bucket MSM over affine bases against the plain sum of scalar multiples.
+    std::vector<Fr> scalars;
+    std::vector<G1> bases;
+    G1 expected;
+    for (int i = 0; i < 40; ++i) {
+        Fr s = i % 7 == 0 ? Fr(0) : Fr::random();
+        G1 b = i % 11 == 0 ? G1() : g * Fr(i + 1);
+        scalars.push_back(s);
+        bases.push_back(b);
+        expected = expected + b * s;
+    }
+    // Repeated bases land in the same bucket and exercise the doubling case.
+    scalars.push_back(scalars[1]);
+    bases.push_back(bases[1]);
+    expected = expected + bases[1] * scalars[1];
+    std::vector<G1Affine> affine_bases = G1::batch_normalize(bases);
+    assert(MSM::msm_g1(scalars, affine_bases.data(), affine_bases.size()) == expected);
+    assert(MSM::msm_g1(scalars, bases) == expected);
+    
+    std::vector<Fr> scalars2 = {Fr(0) - Fr(1), Fr(3), Fr(0)};
+    std::vector<G2> bases2 = {G2::generator(), G2::generator() * Fr(2), G2::generator()};
+    assert(MSM::msm_g2(scalars2, bases2) == G2::generator() * Fr(5));
+    
+    G1Affine bad = ag;
+    bad.y = Fq(3);
+    assert(!bad.is_on_curve());
+    std::memcpy(static_cast<void*>(&bad.y), Fq::MODULUS, sizeof(Fq::MODULUS));
+    assert(!bad.is_reduced());
+    
+    std::cout << "Affine point test passed!" << std::endl;
+}
+
+void test_pk_mmap() {
+    std::cout << "Testing mapped proving key (format v2)..." << std::endl;
+    
+    std::vector<Fr> witness;
+    R1CS r = cubic_circuit(Fr(3), witness);
+    SparseQAP qap = r1cs_to_sparse_qap(r);
+    CRS crs = Groth16::setup(qap);
+    const ProvingKey& pk = crs.pk;
+    
+    const std::string path = "test_keys.pk";
+    pk.save_mmap(path);
+    assert(ProvingKey::is_mmap_file(path));
+    
+    ProvingKey mapped = ProvingKey::load_mmap(path, true);
+    assert(mapped.is_mapped());
+    assert(mapped.num_variables == pk.num_variables && mapped.num_public == pk.num_public &&
+           mapped.degree == pk.degree);
+    assert(mapped.A_query_g1.empty() && mapped.H_query_g1.empty());
+    assert(same_query(mapped.A_query_mapped, pk.A_query_g1));
+    assert(same_query(mapped.B_query_g1_mapped, pk.B_query_g1));
+    assert(same_query(mapped.B_query_g2_mapped, pk.B_query_g2));
+    assert(same_query(mapped.K_query_mapped, pk.K_query_g1));
+    assert(same_query(mapped.H_query_mapped, pk.H_query_g1));
+    assert(mapped.alpha_g1 == pk.alpha_g1 && mapped.delta_g2 == pk.delta_g2);
+    
+    // Sections start on 64-byte boundaries of the mapping.
+    assert(reinterpret_cast<uintptr_t>(mapped.A_query_mapped.data()) % 64 == 0);
+    assert(reinterpret_cast<uintptr_t>(mapped.B_query_g2_mapped.data()) % 64 == 0);
+    
+    // The prover reads the mapped queries in place.
+    Proof proof = Groth16::prove(mapped, qap, witness);
+    assert(!proof.A.is_zero());
+    
+    // Proofs serialise compressed.
+    std::vector<uint8_t> proof_bytes = proof.serialize();
+    assert(proof_bytes.size() == 128);
+    Proof decoded = Proof::deserialize(proof_bytes);
+    assert(decoded.A == proof.A && decoded.B == proof.B && decoded.C == proof.C);
+    
+    // A mapped key saves again byte for byte; materializing keeps the points.
+    const std::string copy = "test_keys_copy.pk";
+    mapped.save_mmap(copy);
+    {
+        std::ifstream a(path, std::ios::binary), b(copy, std::ios::binary);
+        std::vector<char> da((std::istreambuf_iterator<char>(a)), std::istreambuf_iterator<char>());
+        std::vector<char> db((std::istreambuf_iterator<char>(b)), std::istreambuf_iterator<char>());
+        assert(da == db);
+    }
+    std::remove(copy.c_str());
+    
+    // Format v1 stores the same key compressed.
+    std::vector<uint8_t> v1 = pk.serialize();
+    ProvingKey from_v1 = ProvingKey::deserialize(v1);
+    assert(from_v1.B_query_g2 == pk.B_query_g2 && from_v1.H_query_g1 == pk.H_query_g1 &&
+           from_v1.K_query_g1 == pk.K_query_g1 && from_v1.delta_g2 == pk.delta_g2);
+    std::vector<uint8_t> vk_bytes = crs.vk.serialize();
+    VerifyingKey vk = VerifyingKey::deserialize(vk_bytes);
+    assert(vk.IC_g1.size() == crs.vk.IC_g1.size() && vk.IC_g1.back() == crs.vk.IC_g1.back() &&
+           vk.gamma_g2 == crs.vk.gamma_g2);
+    
+    ProvingKey loaded = ProvingKey::load_from_file(path);
+    assert(loaded.is_mapped());
+    loaded.materialize_queries();
+    assert(!loaded.is_mapped());
+    assert(loaded.A_query_g1.size() == pk.A_query_g1.size());
+    for (size_t i = 0; i < pk.H_query_g1.size(); ++i) {
+        assert(same_bytes(loaded.H_query_g1[i], pk.H_query_g1[i]));
+    }
+    
+    // Corruptions: magic, truncation, an unreduced coordinate (caught when validating).
+    std::vector<char> bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto write = [&](const std::vector<char>& b) {
+        std::ofstream out(copy, std::ios::binary);
+        out.write(b.data(), b.size());
+    };
+    
+    std::vector<char> bad = bytes;
+    bad[0] = 'X';
+    write(bad);
+    assert(rejects(copy, false));
+    
+    bad = bytes;
+    bad.resize(bad.size() - 64);
+    write(bad);
+    assert(rejects(copy, false));
+    
+    bad = bytes;
+    // The A query follows the header (256 bytes) and the fixed G1 and G2 sections (192, 256).
+    const size_t a_offset = 256 + 192 + 256;
+    std::memset(bad.data() + a_offset + 8, 0xFF, 24);
+    write(bad);
+    assert(!rejects(copy, false));
+    assert(rejects(copy, true));
+    std::remove(copy.c_str());
+    std::remove(path.c_str());
+    
+    std::cout << "Mapped proving key test passed!" << std::endl;
+}
+
+static bool rejects_key(const ProvingKey& pk) {
+    try {
+        pk.validate();
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+void test_pk_validation() {
+    std::cout << "Testing proving key validation..." << std::endl;
+    
+    std::vector<Fr> witness;
+    R1CS r = cubic_circuit(Fr(5), witness);
+    CRS crs = Groth16::setup(r1cs_to_sparse_qap(r));
+    ProvingKey& pk = crs.pk;
+    assert(!rejects_key(pk));
+    
+    // The v1 loader decodes and validates, and reports what it did.
+    std::vector<uint8_t> bytes = pk.serialize();
+    KeyLoadStats stats;
+    ProvingKey loaded = ProvingKey::deserialize(bytes, true, &stats);
+    assert(stats.points == pk.num_points() && stats.points == 5 + 3 * 5 + 3 + pk.degree);
+    assert(stats.points_per_second() > 0);
+    assert(loaded.H_query_g1 == pk.H_query_g1);
+    
+    // A point of E(Fq2) outside the order-r subgroup passes the curve check but not
+    // the subgroup check.
+    G2Affine outsider;
+    uint64_t x = 1;
+    while (!G2Affine::from_x(Fq2(Fq(x), Fq(1)), false, outsider)) ++x;
+    assert(outsider.is_on_curve());
+    ProvingKey tampered = pk;
+    tampered.B_query_g2[2] = outsider;
+    assert(rejects_key(tampered));
+    
+    // (0, sqrt(3)) has order 3, which divides the cofactor. A query point carrying it
+    // must be rejected on every run, not just when a random weight is prime to 3.
+    Fq2 sqrt3;
+    assert(Fq2(Fq(3), Fq()).sqrt(sqrt3));
+    G2 torsion(Fq2(), sqrt3);
+    assert(torsion.is_on_curve() && (torsion * Fr(3)).is_zero() && !torsion.is_zero());
+    tampered = pk;
+    tampered.B_query_g2[1] = G2Affine(tampered.B_query_g2[1].to_jacobian() + torsion);
+    for (int trial = 0; trial < 20; ++trial) assert(rejects_key(tampered));
+    
+    tampered = pk;
+    tampered.K_query_g1[0].y = tampered.K_query_g1[0].y + Fq(1);
+    assert(rejects_key(tampered));
+    
+    tampered = pk;
+    tampered.delta_g1 = G1(Fq(1), Fq(3));
+    assert(rejects_key(tampered));
+    
+    // Mapped keys are validated in place: an off-curve record only fails when asked.
+    const std::string path = "test_keys_validate.pk";
+    tampered = pk;
+    tampered.A_query_g1[1].y = tampered.A_query_g1[1].y + Fq(1);
+    tampered.save_mmap(path);
+    assert(!rejects(path, false));
+    assert(rejects(path, true));
+    // A K query one point short would only trip the prover's MSM; it fails to load.
+    tampered = pk;
+    tampered.K_query_g1.pop_back();
+    tampered.save_mmap(path);
+    assert(rejects(path, false));
+    pk.save_mmap(path);
+    ProvingKey mapped = ProvingKey::load_from_file(path, true, &stats);
+    assert(mapped.is_mapped() && stats.points == pk.num_points());
+    std::remove(path.c_str());
+    
+    std::cout << "Proving key validation test passed!" << std::endl;
+}
+
+int main() {
+    try {
+        std::cout << "=== Key Tests ===" << std::endl;
+        
+        test_affine_points();
+        test_pk_mmap();
+        test_pk_validation();
+        
+        std::cout << "All key tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
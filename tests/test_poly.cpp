@@ -1,7 +1,10 @@
 #include "zkmini/polynomial.hpp"
+#include "zkmini/subproduct_tree.hpp"
+#include "zkmini/fft.hpp"
 #include "zkmini/utils.hpp"
 #include <iostream>
 #include <cassert>
+#include <stdexcept>
 
 using namespace zkmini;
 
@@ -339,6 +342,244 @@ void test_edge_cases() {
     std::cout << "Edge cases test passed!" << std::endl;
 }
 
+void test_fast_multiplication() {
+    std::cout << "Testing Karatsuba/FFT multiplication dispatch..." << std::endl;
+    
+    // Sizes straddling both thresholds, including unbalanced operands
+    std::vector<std::pair<size_t, size_t>> sizes = {
+        {3, 5}, {16, 16}, {17, 40}, {100, 7}, {127, 129}, {200, 300}, {256, 20}
+    };
+    
+    for (const auto& [na, nb] : sizes) {
+        Polynomial f = Polynomial::random(na - 1);
+        Polynomial g = Polynomial::random(nb - 1);
+        
+        Polynomial expected = Polynomial::mul_schoolbook(f, g);
+        assert(Polynomial::mul_karatsuba(f, g).equals(expected));
+        assert(Polynomial::mul_fft(f, g).equals(expected));
+        assert((f * g).equals(expected));
+        
+        assert(Polynomial::square(f).equals(Polynomial::mul_schoolbook(f, f)));
+    }
+    
+    assert(Polynomial::mul(Polynomial::zero(), Polynomial::one()).is_zero());
+    assert(Polynomial::square(Polynomial::zero()).is_zero());
+    
+    std::cout << "Karatsuba/FFT multiplication dispatch test passed!" << std::endl;
+}
+
+void test_vanishing_division() {
+    std::cout << "Testing division by X^n - 1 and sparse divisors..." << std::endl;
+    
+    size_t n = 8;
+    std::vector<Fr> z_coeffs(n + 1, Fr(0));
+    z_coeffs[0] = Fr(0) - Fr(1);
+    z_coeffs[n] = Fr(1);
+    Polynomial Z(z_coeffs);
+    
+    size_t detected = 0;
+    assert(Z.is_subgroup_vanishing(detected) && detected == n);
+    assert(!Polynomial({Fr(1), Fr(1)}).is_subgroup_vanishing(detected));
+    
+    // Exact multiple plus a remainder of degree < n
+    Polynomial H = Polynomial::random(20);
+    Polynomial rem = Polynomial::random(n - 2);
+    Polynomial N = Polynomial::add(Polynomial::mul(H, Z), rem);
+    
+    auto [Q, R] = N.divide_by_vanishing(n);
+    assert(Q.equals(H));
+    assert(R.equals(rem));
+    
+    Polynomial Q2, R2;
+    Polynomial::divrem(N, Z, Q2, R2);
+    assert(Q2.equals(H));
+    assert(R2.equals(rem));
+    
+    // Sparse, non-monic divisor: 3X^5 + 2X + 7
+    Polynomial D({Fr(7), Fr(2), Fr(0), Fr(0), Fr(0), Fr(3)});
+    Polynomial N2 = Polynomial::random(30);
+    Polynomial Q3, R3;
+    Polynomial::divrem(N2, D, Q3, R3);
+    assert(R3.deg() < D.deg());
+    assert(Polynomial::add(Polynomial::mul(Q3, D), R3).equals(N2));
+    
+    // Low-degree numerator passes straight through
+    auto [Q4, R4] = rem.divide_by_vanishing(n);
+    assert(Q4.is_zero() && R4.equals(rem));
+    
+    std::cout << "Division by X^n - 1 and sparse divisors test passed!" << std::endl;
+}
+
+void test_newton_division() {
+    std::cout << "Testing Newton-iteration division..." << std::endl;
+    
+    // f * f^-1 = 1 mod X^k
+    Polynomial f = Polynomial::random(40);
+    f.coeffs[0] = Fr(3);
+    for (size_t k : {1, 2, 7, 33, 64}) {
+        Polynomial g = Polynomial::inverse_mod_xk(f, k);
+        Polynomial prod = Polynomial::truncate(Polynomial::mul(f, g), k);
+        assert(prod.equals(Polynomial::one()));
+    }
+    
+    // Agrees with long division, including degenerate shapes
+    std::vector<std::pair<size_t, size_t>> shapes = {{10, 3}, {50, 50}, {300, 280}, {600, 290}, {5, 9}};
+    for (const auto& [dn, dd] : shapes) {
+        Polynomial N = Polynomial::random(dn);
+        Polynomial D = Polynomial::random(dd);
+        Polynomial Q1, R1, Q2, R2;
+        Polynomial::divrem_long(N, D, Q1, R1);
+        Polynomial::divrem_newton(N, D, Q2, R2);
+        assert(Q1.equals(Q2));
+        assert(R1.equals(R2));
+        
+        Polynomial Q3, R3;
+        Polynomial::divrem(N, D, Q3, R3);
+        assert(Q3.equals(Q1) && R3.equals(R1));
+    }
+    
+    std::cout << "Newton-iteration division test passed!" << std::endl;
+}
+
+void test_subproduct_tree() {
+    std::cout << "Testing subproduct tree evaluation/interpolation..." << std::endl;
+    
+    for (size_t n : {1, 5, 16, 17, 100, 300}) {
+        std::vector<Fr> pts, vals;
+        for (size_t i = 0; i < n; ++i) {
+            pts.push_back(Fr(3 * i + 11));
+            vals.push_back(Fr::random());
+        }
+        
+        SubproductTree tree(pts);
+        
+        Polynomial M = tree.vanishing();
+        assert(M.deg() == static_cast<int>(n));
+        for (const Fr& x : pts) {
+            assert(M.evaluate(x).is_zero());
+        }
+        
+        Polynomial f = Polynomial::random(n + 7);
+        std::vector<Fr> evals = tree.evaluate(f);
+        for (size_t i = 0; i < n; ++i) {
+            assert(evals[i] == f.evaluate(pts[i]));
+        }
+        
+        Polynomial g = tree.interpolate(vals);
+        assert(g.deg() < static_cast<int>(n));
+        assert(g.evaluate_batch(pts) == vals);
+    }
+    
+    // Dispatch through Polynomial reuses the cached tree
+    std::vector<Fr> pts, vals;
+    for (size_t i = 0; i < 80; ++i) {
+        pts.push_back(Fr(i + 1));
+        vals.push_back(Fr(i * i));
+    }
+    Polynomial p = Polynomial::interpolate(pts, vals);
+    assert(SubproductTree::cached(pts) == SubproductTree::cached(pts));
+    assert(p.evaluate_batch(pts) == vals);
+    assert(Polynomial::vanishing(pts).equals(SubproductTree::cached(pts)->vanishing()));
+    
+    // A repeated point has no interpolant; it must not come back as a wrong one.
+    pts[40] = pts[7];
+    bool threw = false;
+    try {
+        Polynomial::interpolate(pts, vals);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "Subproduct tree test passed!" << std::endl;
+}
+
+void test_lagrange_basis_at() {
+    std::cout << "Testing barycentric Lagrange evaluation..." << std::endl;
+    
+    Fr x(1234567);
+    
+    std::vector<Fr> spaced, scattered, qap_domain;
+    for (size_t i = 0; i < 20; ++i) {
+        spaced.push_back(Fr(3 + 5 * i));
+        scattered.push_back(Fr(i * i + 2 * i + 7));
+    }
+    // Starts at 1 with a power-of-two size, like a QAP domain, but is no FFT domain.
+    for (size_t i = 0; i < 16; ++i) qap_domain.push_back(Fr(i + 1));
+    std::vector<Fr> roots = FFT::cached(16).get_domain();
+    
+    for (const auto& pts : {spaced, scattered, qap_domain, roots}) {
+        std::vector<Fr> values = Polynomial::lagrange_basis_at(pts, x);
+        assert(values.size() == pts.size());
+        for (size_t j = 0; j < pts.size(); ++j) {
+            assert(values[j] == Polynomial::lagrange_basis(pts, j).evaluate(x));
+        }
+        
+        // At a node the basis collapses to a unit vector
+        std::vector<Fr> at_node = Polynomial::lagrange_basis_at(pts, pts[3]);
+        for (size_t j = 0; j < pts.size(); ++j) {
+            assert(at_node[j] == (j == 3 ? Fr(1) : Fr(0)));
+        }
+    }
+    
+    std::cout << "Barycentric Lagrange evaluation test passed!" << std::endl;
+}
+
+void test_inplace_arithmetic() {
+    std::cout << "Testing in-place and move-aware arithmetic..." << std::endl;
+    
+    Polynomial a = Polynomial::random(9);
+    Polynomial b = Polynomial::random(4);
+    Polynomial c = Polynomial::random(12);
+    Fr k(11);
+    
+    Polynomial sum = Polynomial::add(a, b);
+    Polynomial diff = Polynomial::sub(a, b);
+    
+    // Every lvalue/rvalue combination of the operators gives the same result
+    assert((Polynomial(a) + b).equals(sum));
+    assert((a + Polynomial(b)).equals(sum));
+    assert((Polynomial(a) + Polynomial(b)).equals(sum));
+    assert((Polynomial(a) - b).equals(diff));
+    assert((a - Polynomial(b)).equals(diff));
+    assert((Polynomial(a) - Polynomial(b)).equals(diff));
+    assert((b - Polynomial(a)).equals(Polynomial::sub(b, a)));
+    assert((Polynomial(a) * k).equals(Polynomial::scalar_mul(a, k)));
+    assert((a * b - c).equals(Polynomial::sub(Polynomial::mul(a, b), c)));
+    
+    Polynomial acc = a;
+    acc += b;
+    assert(acc.equals(sum));
+    acc -= b;
+    assert(acc.equals(a));
+    acc *= b;
+    assert(acc.equals(Polynomial::mul(a, b)));
+    acc *= k;
+    assert(acc.equals(Polynomial::scalar_mul(Polynomial::mul(a, b), k)));
+    acc -= acc;
+    assert(acc.is_zero());
+    
+    // Cancellation of leading terms must still normalise
+    Polynomial lead = a;
+    lead -= a;
+    assert(lead.is_zero() && lead.deg() == -1);
+    assert((Polynomial(a) - a).is_zero());
+    
+    Polynomial y = b;
+    Polynomial::axpy(y, k, c);
+    assert(y.equals(Polynomial::add(b, Polynomial::scalar_mul(c, k))));
+    Polynomial::axpy(y, Fr(0), a);
+    assert(y.equals(Polynomial::add(b, Polynomial::scalar_mul(c, k))));
+    
+    Polynomial lc = Polynomial::linear_combination({Fr(2), Fr(0), k}, {&a, &b, &c});
+    Polynomial expected = Polynomial::add(Polynomial::scalar_mul(a, Fr(2)),
+                                          Polynomial::scalar_mul(c, k));
+    assert(lc.equals(expected));
+    assert(Polynomial::linear_combination({}, {}).is_zero());
+    
+    std::cout << "In-place and move-aware arithmetic test passed!" << std::endl;
+}
+
 void test_utility_methods() {
     std::cout << "Testing utility methods..." << std::endl;
     
@@ -377,6 +618,12 @@ int main() {
         test_shift_operations();
         test_scalar_multiplication_advanced();
         test_edge_cases();
+        test_fast_multiplication();
+        test_vanishing_division();
+        test_newton_division();
+        test_subproduct_tree();
+        test_inplace_arithmetic();
+        test_lagrange_basis_at();
         test_utility_methods();
         
         std::cout << "\nAll polynomial tests passed successfully!" << std::endl;
@@ -0,0 +1,420 @@
+#include "zkmini/qap.hpp"
+#include "zkmini/r1cs.hpp"
+#include "zkmini/utils.hpp"
+#include "circuits.hpp"
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+
+using namespace zkmini;
+
+void test_basis_at_tau() {
+    std::cout << "Testing sparse QAP basis evaluation..." << std::endl;
+    
+    std::vector<Fr> witness;
+    R1CS r = cubic_circuit(Fr(3), witness);
+    assert(r.is_satisfied(witness));
+    
+    QAP q = r1cs_to_qap(r);
+    
+    for (const Fr& tau : {Fr(987654321), q.domain_points[1]}) {
+        QAPBasisEvaluation at_tau = qap_basis_at(r, q.domain_points, tau);
+        assert(at_tau.Z == q.Z.evaluate(tau));
+        for (size_t i = 0; i < q.n; ++i) {
+            assert(at_tau.A[i] == q.A_basis[i].evaluate(tau));
+            assert(at_tau.B[i] == q.B_basis[i].evaluate(tau));
+            assert(at_tau.C[i] == q.C_basis[i].evaluate(tau));
+        }
+    }
+    
+    std::cout << "Sparse QAP basis evaluation test passed!" << std::endl;
+}
+
+void test_sparse_qap() {
+    std::cout << "Testing sparse subgroup QAP..." << std::endl;
+    
+    std::vector<Fr> witness;
+    R1CS r = cubic_circuit(Fr(7), witness);
+    SparseQAP q = r1cs_to_sparse_qap(r);
+    assert(q.is_valid());
+    assert(q.m == 3 && q.domain_size == 4);
+    
+    // Witness polynomials interpolate Az, Bz, Cz over the subgroup
+    auto [A, B, C] = sparse_qap_polynomials(q, witness);
+    std::vector<std::vector<Fr>> evals = sparse_qap_evaluations(q, witness);
+    for (size_t k = 0; k < q.domain_size; ++k) {
+        Fr w = q.fft().get_root_of_unity(k);
+        assert(A.evaluate(w) == evals[0][k]);
+        assert(B.evaluate(w) == evals[1][k]);
+        assert(C.evaluate(w) == evals[2][k]);
+    }
+    
+    assert(qap_check(q, witness));
+    auto [quotient, remainder] = (A * B - C).divide_by_vanishing(q.domain_size);
+    assert(remainder.is_zero());
+    
+    std::vector<Fr> bad = witness;
+    bad[3] = bad[3] + Fr(1);
+    assert(!qap_check(q, bad));
+    
+    // Basis values at tau agree with interpolating each column over the subgroup
+    Fr tau(424242);
+    QAPBasisEvaluation at_tau = qap_basis_at(q, tau);
+    assert(at_tau.Z == tau.pow(static_cast<uint64_t>(q.domain_size)) - Fr(1));
+    for (size_t i = 0; i < q.n; ++i) {
+        std::vector<Fr> column(q.domain_size, Fr());
+        std::vector<Fr> col = r.column_values(r.B, i);
+        std::copy(col.begin(), col.end(), column.begin());
+        assert(at_tau.B[i] == q.fft().interpolate_on_domain(column).evaluate(tau));
+    }
+    
+    std::cout << "Sparse subgroup QAP test passed!" << std::endl;
+}
+
+void test_coset_quotient() {
+    std::cout << "Testing coset quotient computation..." << std::endl;
+    
+    // Squaring chain v_{i+1} = v_i * v_i + v_0, long enough to leave padding rows
+    size_t steps = 300;
+    R1CS r;
+    std::vector<VarIdx> v = {r.allocate_var()};
+    std::vector<Fr> witness = {Fr(1), Fr(3)};
+    for (size_t i = 0; i < steps; ++i) {
+        VarIdx sq = r.allocate_var();
+        VarIdx next = r.allocate_var();
+        r.add_mul(v.back(), v.back(), sq);
+        r.add_lin_eq(R1CS::lc_from_terms({Term(sq, 1), Term(v[0], 1)}), R1CS::lc_var(next));
+        Fr s_val = witness.back() * witness.back();
+        witness.push_back(s_val);
+        witness.push_back(s_val + witness[1]);
+        v.push_back(next);
+    }
+    r.mark_public(v.back());
+    assert(r.is_satisfied(witness));
+    
+    SparseQAP q = r1cs_to_sparse_qap(r);
+    assert(q.domain_size == 1024);
+    
+    auto [A, B, C] = sparse_qap_polynomials(q, witness);
+    auto [expected, remainder] = (A * B - C).divide_by_vanishing(q.domain_size);
+    assert(remainder.is_zero());
+    assert(compute_H(q, witness) == expected);
+    
+    // Small circuit, domain of size 4
+    std::vector<Fr> small_witness;
+    SparseQAP small = r1cs_to_sparse_qap(cubic_circuit(Fr(5), small_witness));
+    auto [As, Bs, Cs] = sparse_qap_polynomials(small, small_witness);
+    assert(compute_H(small, small_witness) ==
+           (As * Bs - Cs).divide_by_vanishing(small.domain_size).first);
+    
+    std::cout << "Coset quotient computation test passed!" << std::endl;
+}
+
+void test_row_evaluation() {
+    std::cout << "Testing parallel R1CS row evaluation..." << std::endl;
+    
+    std::vector<Fr> witness;
+    R1CS r = cubic_circuit(Fr(11), witness);
+    
+    std::vector<Fr> az, bz, cz;
+    r.evaluate_rows(witness, az, bz, cz);
+    assert(az.size() == r.num_constraints());
+    for (size_t k = 0; k < r.num_constraints(); ++k) {
+        assert(az[k] == R1CS::eval_lc(r.A[k], witness));
+        assert(bz[k] == R1CS::eval_lc(r.B[k], witness));
+        assert(cz[k] == R1CS::eval_lc(r.C[k], witness));
+    }
+    assert(R1CS::first_unsatisfied_row(az, bz, cz, r.num_constraints()) == r.num_constraints());
+    
+    // Wide rows, enough of them to be split across threads; break two rows
+    size_t rows = 2000;
+    R1CS wide(64);
+    std::vector<Fr> x(64);
+    x[0] = Fr(1);
+    for (size_t i = 1; i < x.size(); ++i) x[i] = Fr::random();
+    for (size_t k = 0; k < rows; ++k) {
+        LinearCombination L;
+        for (size_t i = 0; i < 40; ++i) L.push_back(Term((k + i) % 63 + 1, Fr::random()));
+        Fr value = R1CS::eval_lc(R1CS::lc_from_terms(L), x);
+        wide.add_constraint(L, R1CS::lc_const(Fr(1)), R1CS::lc_const(k == 700 || k == 1500 ? value + Fr(1) : value));
+    }
+    
+    size_t bad_row = 0;
+    Fr L_val, R_val, O_val;
+    assert(!wide.is_satisfied(x));
+    assert(!wide.is_satisfied_verbose(x, bad_row, L_val, R_val, O_val));
+    assert(bad_row == 700);
+    assert(L_val * R_val + Fr(1) == O_val);
+    
+    std::cout << "Parallel R1CS row evaluation test passed!" << std::endl;
+}
+
+void test_csr_layout() {
+    std::cout << "Testing CSR/CSC constraint layout..." << std::endl;
+    
+    std::vector<Fr> witness;
+    R1CS r = cubic_circuit(Fr(6), witness);
+    r.add_constraint(R1CS::lc_from_terms({Term(1, -1), Term(2, 3)}), R1CS::lc_const(Fr(1)),
+                     R1CS::lc_from_terms({Term(1, -1), Term(2, 3)}));
+    assert(!r.is_finalized());
+    
+    std::vector<Fr> az_rows, bz_rows, cz_rows;
+    r.evaluate_rows(witness, az_rows, bz_rows, cz_rows);
+    
+    // finalize() keeps only the CSR copies; compare them with the rows beforehand.
+    const R1CS before = r;
+    r.finalize(true);
+    assert(r.is_finalized() && r.has_csc());
+    assert(!r.has_rows() && r.A.empty() && r.C.empty());
+    assert(r.A_csr.num_rows() == r.num_constraints());
+    assert(r.A_csr.num_cols() == r.num_variables());
+    
+    for (size_t k = 0; k < r.num_constraints(); ++k) {
+        assert(r.A_csr.row_end(k) - r.A_csr.row_begin(k) == before.A[k].size());
+        for (size_t e = r.A_csr.row_begin(k); e < r.A_csr.row_end(k); ++e) {
+            const Term& term = before.A[k][e - r.A_csr.row_begin(k)];
+            assert(r.A_csr.col(e) == term.idx && r.A_csr.coeff(e) == term.coeff);
+            assert(r.A_csr.is_unit(e) == (term.coeff == Fr(1) || term.coeff == Fr(0) - Fr(1)));
+            assert(!r.A_csr.is_unit(e) || r.A_csr.is_negative(e) == (term.coeff != Fr(1)));
+        }
+        assert(r.A_csr.row_dot(k, witness) == R1CS::eval_lc(before.A[k], witness));
+    }
+    
+    std::vector<Fr> az, bz, cz;
+    r.evaluate_rows(witness, az, bz, cz);
+    assert(az == az_rows && bz == bz_rows && cz == cz_rows);
+    
+    // Column access through the CSC copy matches a scan of the rows
+    for (VarIdx i = 0; i < r.num_variables(); ++i) {
+        std::vector<Fr> expected(r.num_constraints(), Fr(0));
+        for (size_t k = 0; k < r.num_constraints(); ++k) {
+            for (const auto& term : before.C[k]) {
+                if (term.idx == i) expected[k] = term.coeff;
+            }
+        }
+        assert(r.column_values(r.C, i) == expected);
+    }
+    assert(r.C_csc.transpose().nnz() == r.C_csr.nnz());
+    
+    SparseQAP q = r1cs_to_sparse_qap(r);
+    assert(qap_check(q, witness));
+    
+    r.add_mul(1, 1, 1);
+    assert(!r.is_finalized());
+    
+    std::cout << "CSR/CSC constraint layout test passed!" << std::endl;
+}
+
+void test_coefficient_interning() {
+    std::cout << "Testing interned R1CS coefficients..." << std::endl;
+    
+    // Bit decomposition of x into 16 bits: every weight is a small power of two
+    R1CS r(1);
+    VarIdx x = r.allocate_var();
+    std::vector<VarIdx> bits;
+    LinearCombination sum;
+    for (size_t i = 0; i < 16; ++i) {
+        bits.push_back(r.allocate_var());
+        r.add_constraint(R1CS::lc_var(bits[i]), R1CS::lc_var(bits[i]), R1CS::lc_var(bits[i]));
+        sum.push_back(Term(bits[i], Fr(1ULL << i)));
+    }
+    Fr big = Fr::random();
+    sum.push_back(Term(x, Fr(0) - Fr(1)));
+    r.add_constraint(sum, R1CS::lc_const(Fr(1)), R1CS::lc_const(Fr(0)));
+    r.add_constraint(R1CS::lc_var(x, big), R1CS::lc_const(Fr(1)), R1CS::lc_var(x, big));
+    
+    uint64_t value = 0xB3C5;
+    std::vector<Fr> w(r.num_variables());
+    w[0] = Fr(1);
+    w[x] = Fr(value);
+    for (size_t i = 0; i < 16; ++i) w[bits[i]] = Fr((value >> i) & 1);
+    assert(r.is_satisfied(w));
+    
+    r.finalize();
+    assert(r.is_satisfied(w));
+    assert(r.A_csr.num_coeffs() == 18);
+    assert(r.B_csr.num_coeffs() == 1 && r.C_csr.num_coeffs() == 2);
+    assert(r.A_csr.memory_bytes() < r.A_csr.nnz() * sizeof(Fr));
+    
+    size_t row = 16;
+    for (size_t e = r.A_csr.row_begin(row); e < r.A_csr.row_end(row); ++e) {
+        if (r.A_csr.col(e) == x) {
+            assert(r.A_csr.is_unit(e) && r.A_csr.is_negative(e));
+        } else {
+            assert(r.A_csr.small_magnitude(e) == (1u << (r.A_csr.col(e) - bits[0])));
+            assert(!r.A_csr.is_negative(e));
+        }
+        assert(r.A_csr.row_dot(row, w) == Fr(0));
+    }
+    assert(r.A_csr.small_magnitude(r.A_csr.row_begin(17)) == 0);
+    assert(r.A_csr.coeff(r.A_csr.row_begin(17)) == big);
+    
+    w[bits[3]] = Fr(1) - w[bits[3]];
+    assert(!r.is_satisfied(w));
+    
+    std::cout << "Interned R1CS coefficients test passed!" << std::endl;
+}
+
+void test_batch_constraints() {
+    std::cout << "Testing batched constraint ingestion..." << std::endl;
+    
+    // Unsorted rows with repeats, a cancelling pair and one row past the
+    // insertion-sort cutoff
+    LinearCombination long_row;
+    for (size_t i = 0; i < 40; ++i) long_row.push_back(Term(1 + (i * 7) % 20, Fr(i + 1)));
+    Fr minus_one = Fr(0) - Fr(1);
+    std::vector<std::vector<LinearCombination>> rows = {
+        {R1CS::lc_var(3), {Term(2, 1), Term(1, 5), Term(2, 4)}, {Term(4, 1), Term(0, 2), Term(4, minus_one)}},
+        {long_row, R1CS::lc_const(Fr(1)), {Term(5, 3), Term(5, Fr(0) - Fr(3))}},
+        {{}, {}, {}},
+    };
+    
+    R1CS single(21);
+    R1CS batched(21);
+    ConstraintBatch batch;
+    for (const auto& r : rows) {
+        single.add_constraint(r[0], r[1], r[2]);
+        batch.add(r[0], r[1], r[2]);
+    }
+    assert(batch.size() == 3);
+    batched.add_constraints(batch);
+    
+    assert(batched.num_constraints() == single.num_constraints());
+    assert(batched.is_finalized() && !batched.has_rows());
+    
+    // The const readers work from the CSR copies and agree with the row form.
+    assert(batched.serialize() == single.serialize());
+    assert(batched.to_json() == single.to_json());
+    assert(batched.to_iden3() == single.to_iden3());
+    for (size_t k = 0; k < single.num_constraints(); ++k) {
+        assert(batched.debug_row(k) == single.debug_row(k));
+    }
+    QAP dense = r1cs_to_qap(batched);
+    QAP dense_rows = r1cs_to_qap(single);
+    for (size_t i = 0; i < 21; ++i) {
+        assert(dense.A_basis[i] == dense_rows.A_basis[i] && dense.B_basis[i] == dense_rows.B_basis[i] &&
+               dense.C_basis[i] == dense_rows.C_basis[i]);
+    }
+    
+    batched.materialize_rows();
+    auto same_rows = [](const LinearCombination& want, const LinearCombination& got) {
+        assert(want.size() == got.size());
+        for (size_t t = 0; t < want.size(); ++t) {
+            assert(want[t].idx == got[t].idx && want[t].coeff == got[t].coeff);
+            assert(t == 0 || want[t - 1].idx < want[t].idx);
+        }
+    };
+    for (size_t k = 0; k < single.num_constraints(); ++k) {
+        same_rows(single.A[k], batched.A[k]);
+        same_rows(single.B[k], batched.B[k]);
+        same_rows(single.C[k], batched.C[k]);
+    }
+    assert(single.A[1].size() == 20 && single.C[0].size() == 1 && single.C[1].empty());
+    
+    std::vector<Fr> w(21);
+    for (auto& v : w) v = Fr::random();
+    std::vector<Fr> az, bz, cz, az2, bz2, cz2;
+    single.evaluate_rows(w, az, bz, cz);
+    batched.evaluate_rows(w, az2, bz2, cz2);
+    assert(az == az2 && bz == bz2 && cz == cz2);
+    
+    // A second batch extends the live CSR copies; finalize() rebuilds the same thing
+    batch.clear();
+    batch.add(R1CS::lc_var(7), R1CS::lc_var(8), {Term(9, 2), Term(9, 2)});
+    batched.add_constraints(batch);
+    assert(batched.is_finalized() && batched.A_csr.num_rows() == 4);
+    assert(!batched.has_rows() && batched.A.empty());
+    R1CS rebuilt = batched;
+    rebuilt.materialize_rows();
+    assert(rebuilt.C[3].size() == 1 && rebuilt.C[3][0].coeff == Fr(4));
+    rebuilt.finalize();
+    for (size_t k = 0; k < 4; ++k) {
+        assert(batched.C_csr.row_dot(k, w) == rebuilt.C_csr.row_dot(k, w));
+        assert(batched.A_csr.row_dot(k, w) == rebuilt.A_csr.row_dot(k, w));
+    }
+    
+    std::cout << "Batched constraint ingestion test passed!" << std::endl;
+}
+
+void test_optimize() {
+    std::cout << "Testing linear-constraint elimination..." << std::endl;
+    
+    // out = (x^2 + 3) * 2 * x, with a chain of copies, a duplicate and an unused variable
+    R1CS r(1);
+    VarIdx x = r.allocate_var();
+    VarIdx out = r.allocate_var();
+    r.mark_public(x);
+    r.mark_public(out);
+    VarIdx y = r.allocate_var();
+    VarIdx t1 = r.allocate_var();
+    VarIdx t2 = r.allocate_var();
+    VarIdx unused = r.allocate_var();
+    r.add_mul(x, x, y);
+    r.add_lin_eq(R1CS::lc_from_terms({Term(y, 1), Term(0, 3)}), R1CS::lc_var(t1));
+    r.add_constraint(R1CS::lc_const(Fr(2)), R1CS::lc_var(t1), R1CS::lc_var(t2));
+    std::vector<VarIdx> copies = {t2};
+    for (size_t i = 0; i < 50; ++i) {
+        copies.push_back(r.allocate_var());
+        r.add_lin_eq(R1CS::lc_var(copies[i]), R1CS::lc_var(copies.back()));
+    }
+    r.add_mul(copies.back(), x, out);
+    r.add_mul(x, x, y);
+    r.add_lin_eq(R1CS::lc_var(x), R1CS::lc_var(x));
+    
+    Fr xv(5);
+    std::vector<Fr> w(r.num_variables());
+    w[0] = Fr(1);
+    w[x] = xv;
+    w[y] = xv * xv;
+    w[t1] = w[y] + Fr(3);
+    for (VarIdx c : copies) w[c] = w[t1] * Fr(2);
+    w[out] = w[t2] * xv;
+    w[unused] = Fr(42);
+    assert(r.is_satisfied(w));
+    size_t cons_before = r.num_constraints();
+    size_t vars_before = r.num_variables();
+    
+    VariableMap map = r.optimize();
+    assert(map.num_old() == vars_before && map.num_new() == r.num_variables());
+    assert(r.num_constraints() == 2 && cons_before == 56);
+    assert(r.num_variables() == 4);
+    assert(map.old_to_new[unused] == VariableMap::REMOVED);
+    assert(map.old_to_new[x] == 1 && map.old_to_new[out] == 2);
+    assert(r.public_inputs().size() == 2 && r.public_inputs()[0] == 1 && r.public_inputs()[1] == 2);
+    
+    std::vector<Fr> w2 = map.translate_witness(w);
+    assert(r.is_satisfied(w2));
+    w2[2] = w2[2] + Fr(1);
+    assert(!r.is_satisfied(w2));
+    
+    SparseQAP q = r1cs_to_sparse_qap(r);
+    assert(q.domain_size == 2);
+    assert(qap_check(q, map.translate_witness(w)));
+    
+    // A constraint that cannot hold is kept, and nothing public is solved away
+    R1CS bad(1);
+    VarIdx p = bad.allocate_var();
+    bad.mark_public(p);
+    bad.add_lin_eq(R1CS::lc_var(p), R1CS::lc_const(Fr(7)));
+    bad.add_lin_eq(R1CS::lc_const(Fr(1)), R1CS::lc_const(Fr(2)));
+    bad.optimize();
+    assert(bad.num_constraints() == 2 && bad.num_variables() == 2);
+    
+    std::cout << "Linear-constraint elimination test passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "=== QAP Tests ===" << std::endl;
+    
+    test_basis_at_tau();
+    test_sparse_qap();
+    test_coset_quotient();
+    test_row_evaluation();
+    test_csr_layout();
+    test_coefficient_interning();
+    test_batch_constraints();
+    test_optimize();
+    
+    std::cout << "\nAll QAP tests passed successfully!" << std::endl;
+    return 0;
+}
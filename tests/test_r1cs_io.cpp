@@ -0,0 +1,299 @@
+#include "zkmini/r1cs.hpp"
+#include "zkmini/qap.hpp"
+#include "zkmini/serialization.hpp"
+#include "zkmini/utils.hpp"
+#include "circuits.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+using namespace zkmini;
+
+// Row k of M, whether r holds it as rows or only in its CSR copies.
+static LinearCombination row_of(const R1CS& r, const std::vector<LinearCombination>& M, size_t k) {
+    LinearCombination row;
+    r.for_each_term(M, k, [&](VarIdx idx, const Fr& coeff) { row.push_back(Term(idx, coeff)); });
+    assert(row.size() == r.row_size(M, k));
+    return row;
+}
+
+static bool same_row(const LinearCombination& a, const LinearCombination& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t t = 0; t < a.size(); ++t) {
+        if (a[t].idx != b[t].idx || a[t].coeff != b[t].coeff) return false;
+    }
+    return true;
+}
+
+static bool same_system(const R1CS& a, const R1CS& b) {
+    if (a.num_variables() != b.num_variables() || a.num_constraints() != b.num_constraints()) return false;
+    if (a.public_inputs() != b.public_inputs()) return false;
+    for (size_t k = 0; k < a.num_constraints(); ++k) {
+        if (!same_row(row_of(a, a.A, k), row_of(b, b.A, k)) || !same_row(row_of(a, a.B, k), row_of(b, b.B, k)) ||
+            !same_row(row_of(a, a.C, k), row_of(b, b.C, k))) return false;
+    }
+    return true;
+}
+
+static bool rejects(const std::vector<uint8_t>& bytes) {
+    try {
+        R1CS::from_iden3(bytes.data(), bytes.size());
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+void test_iden3_roundtrip() {
+    std::cout << "Testing iden3 .r1cs round trip..." << std::endl;
+    
+    std::vector<Fr> witness;
+    R1CS r = cubic_circuit(Fr(3), witness);
+    std::vector<uint8_t> bytes = r.to_iden3();
+    
+    R1CS loaded = R1CS::from_iden3(bytes.data(), bytes.size());
+    assert(same_system(r, loaded));
+    assert(loaded.is_finalized());
+    assert(loaded.is_satisfied(witness));
+    
+    std::string path = "test_iden3_roundtrip.r1cs";
+    Serialization::write_file(path, bytes);
+    R1CS from_file = R1CS::load_iden3(path);
+    std::remove(path.c_str());
+    assert(same_system(r, from_file));
+    
+    // Public inputs that are not wires 1..k cannot be expressed
+    R1CS scattered(3);
+    scattered.mark_public(2);
+    bool threw = false;
+    try {
+        scattered.to_iden3();
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "iden3 .r1cs round trip test passed!" << std::endl;
+}
+
+void test_iden3_chunked() {
+    std::cout << "Testing chunked iden3 .r1cs parsing..." << std::endl;
+    
+    // Enough constraints for several parse chunks, with unsorted and repeated terms
+    R1CS r(1);
+    VarIdx pub = r.allocate_var();
+    r.mark_public(pub);
+    std::vector<VarIdx> vars;
+    for (size_t i = 0; i < 64; ++i) vars.push_back(r.allocate_var());
+    ConstraintBatch batch;
+    for (size_t k = 0; k < 40000; ++k) {
+        VarIdx a = vars[k % 64];
+        VarIdx b = vars[(k * 7 + 3) % 64];
+        batch.add({Term(b, Fr(k + 2)), Term(a, Fr(1))}, R1CS::lc_var(pub), {Term(0, Fr(k))});
+    }
+    r.add_constraints(batch);
+    // The batch went straight into the CSR copies, which to_iden3 reads directly.
+    assert(!r.has_rows());
+    
+    std::vector<uint8_t> bytes = r.to_iden3();
+    R1CS loaded = R1CS::from_iden3(bytes.data(), bytes.size());
+    assert(same_system(r, loaded));
+    
+    std::vector<Fr> w(r.num_variables());
+    for (auto& v : w) v = Fr::random();
+    std::vector<Fr> az, bz, cz, az2, bz2, cz2;
+    r.evaluate_rows(w, az, bz, cz);
+    loaded.evaluate_rows(w, az2, bz2, cz2);
+    assert(az == az2 && bz == bz2 && cz == cz2);
+    
+    // Give constraint 5's A row a repeated wire. Merging it leaves a gap in the
+    // first chunk's slice, which the later chunks have to close up.
+    // Constraint 0 takes 120 bytes (its C row is empty), every other one 156.
+    size_t row5 = 12 + 12 + 64 + 12 + 120 + 4 * 156;
+    assert(bytes[row5] == 2);
+    std::memcpy(&bytes[row5 + 4 + 4 + 32], &bytes[row5 + 4], 4);
+    R1CS merged = R1CS::from_iden3(bytes.data(), bytes.size());
+    LinearCombination want = row_of(r, r.A, 5);
+    LinearCombination got = row_of(merged, merged.A, 5);
+    assert(got.size() == 1 && got[0].idx == want[0].idx && got[0].coeff == want[0].coeff + want[1].coeff);
+    assert(merged.A_csr.nnz() + 1 == r.A_csr.nnz());
+    for (size_t k = 0; k < r.num_constraints(); ++k) {
+        if (k != 5) assert(same_row(row_of(r, r.A, k), row_of(merged, merged.A, k)));
+        assert(same_row(row_of(r, r.C, k), row_of(merged, merged.C, k)));
+    }
+    
+    std::cout << "Chunked iden3 .r1cs parsing test passed!" << std::endl;
+}
+
+void test_iden3_rejects_malformed() {
+    std::cout << "Testing malformed iden3 .r1cs input..." << std::endl;
+    
+    std::vector<Fr> witness;
+    std::vector<uint8_t> good = cubic_circuit(Fr(3), witness).to_iden3();
+    
+    std::vector<uint8_t> bad_magic = good;
+    bad_magic[0] = 'x';
+    assert(rejects(bad_magic));
+    
+    std::vector<uint8_t> truncated(good.begin(), good.end() - 9);
+    assert(rejects(truncated));
+    
+    // Header section starts at 12; its payload at 24, the prime at 28
+    std::vector<uint8_t> wrong_prime = good;
+    wrong_prime[28] ^= 1;
+    assert(rejects(wrong_prime));
+    
+    // First term of the first A row: constraints section header follows the
+    // 64-byte header payload, then n_terms, then the wire id
+    size_t first_wire = 24 + 64 + 12 + 4;
+    std::vector<uint8_t> bad_wire = good;
+    bad_wire[first_wire + 3] = 0x7f;
+    assert(rejects(bad_wire));
+    
+    std::vector<uint8_t> unreduced = good;
+    for (size_t i = 0; i < 32; ++i) unreduced[first_wire + 4 + i] = 0xff;
+    assert(rejects(unreduced));
+    
+    std::cout << "Malformed iden3 .r1cs input test passed!" << std::endl;
+}
+
+void test_serialize_roundtrip() {
+    std::cout << "Testing R1CS serialize round trip..." << std::endl;
+    
+    std::vector<Fr> witness;
+    R1CS r = cubic_circuit(Fr(4), witness);
+    std::vector<uint8_t> bytes = r.serialize();
+    R1CS back = R1CS::deserialize(bytes);
+    assert(back.num_constraints() == r.num_constraints());
+    assert(back.num_variables() == r.num_variables());
+    assert(back.is_satisfied(witness));
+    
+    std::cout << "R1CS serialize round trip test passed!" << std::endl;
+}
+
+void test_mmap_image() {
+    std::cout << "Testing mapped R1CS image..." << std::endl;
+    
+    std::vector<Fr> witness;
+    R1CS r = cubic_circuit(Fr(3), witness);
+    std::string path = "test_mmap_image.zkr1cs";
+    r.save_mmap(path);
+    
+    {
+        R1CS loaded = R1CS::load_mmap(path, true);
+        assert(loaded.is_finalized() && !loaded.has_rows());
+        assert(loaded.A_csr.is_view() && loaded.C_csr.is_view());
+        assert(loaded.num_constraints() == r.num_constraints());
+        assert(loaded.public_inputs() == r.public_inputs());
+        assert(loaded.is_satisfied(witness));
+        
+        // The QAP shares the mapped arrays instead of copying them
+        SparseQAP q = r1cs_to_sparse_qap(loaded);
+        assert(q.A.is_view() && q.A.col_idx_data() == loaded.A_csr.col_idx_data());
+        assert(qap_check(q, witness));
+        
+        std::vector<Fr> bad = witness;
+        bad[2] = bad[2] + Fr(1);
+        assert(!loaded.is_satisfied(bad));
+        
+        assert(loaded.column_values(loaded.A, 2) == r.column_values(r.A, 2));
+        
+        loaded.materialize_rows();
+        assert(same_system(r, loaded));
+        
+        // Editing a mapped system detaches it
+        VarIdx extra = loaded.allocate_var();
+        loaded.add_mul(extra, extra, extra);
+        loaded.finalize();
+        assert(!loaded.A_csr.is_view());
+        witness.push_back(Fr(1));
+        assert(loaded.is_satisfied(witness));
+        witness.pop_back();
+    }
+    
+    // A finalized system is written from its CSR copies directly
+    r.finalize(true);
+    r.save_mmap(path);
+    R1CS again = R1CS::load_mmap(path);
+    again.materialize_rows();
+    assert(same_system(r, again));
+    
+    // Corrupt the first column index of A; caught even without validate
+    std::vector<uint8_t> bytes = Serialization::read_file(path);
+    std::vector<uint8_t> good = bytes;
+    uint64_t col_idx_offset;
+    std::memcpy(&col_idx_offset, bytes.data() + 48 + 24, 8);
+    uint32_t huge = 0xFFFFFF;
+    std::memcpy(bytes.data() + col_idx_offset, &huge, 4);
+    Serialization::write_file(path, bytes);
+    bool threw = false;
+    try {
+        R1CS::load_mmap(path);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    // Decreasing row offsets, likewise
+    bytes = good;
+    uint64_t row_ptr_offset;
+    std::memcpy(&row_ptr_offset, bytes.data() + 48 + 16, 8);
+    uint32_t past_next = 0xFFFF;
+    std::memcpy(bytes.data() + row_ptr_offset + 4, &past_next, 4);
+    Serialization::write_file(path, bytes);
+    threw = false;
+    try {
+        R1CS::load_mmap(path);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    // An unreduced coefficient is only looked for with validate
+    bytes = good;
+    uint64_t table_offset;
+    std::memcpy(&table_offset, bytes.data() + 48 + 40, 8);
+    std::memset(bytes.data() + table_offset, 0xFF, sizeof(Fr));
+    Serialization::write_file(path, bytes);
+    R1CS::load_mmap(path);
+    threw = false;
+    try {
+        R1CS::load_mmap(path, true);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    bytes[0] = 'X';
+    Serialization::write_file(path, bytes);
+    threw = false;
+    try {
+        R1CS::load_mmap(path);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    std::remove(path.c_str());
+    
+    std::cout << "Mapped R1CS image test passed!" << std::endl;
+}
+
+int main() {
+    try {
+        std::cout << "=== R1CS I/O Tests ===" << std::endl;
+        
+        test_iden3_roundtrip();
+        test_iden3_chunked();
+        test_iden3_rejects_malformed();
+        test_serialize_roundtrip();
+        test_mmap_image();
+        
+        std::cout << "All R1CS I/O tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,406 @@
+#include "zkmini/groth16.hpp"
+#include "zkmini/byte_io.hpp"
+#include "zkmini/random.hpp"
+#include "zkmini/utils.hpp"
+#include "circuits.hpp"
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+using namespace zkmini;
+
+// A few distinct points, infinity included, to draw from.
+static std::vector<G1Affine> g1_pool() {
+    std::vector<G1> points = {G1()};
+    for (uint64_t k = 1; k < 16; ++k) points.push_back(G1::generator() * Fr(k * 7919));
+    return G1::batch_normalize(points);
+}
+
+static std::vector<G2Affine> g2_pool() {
+    std::vector<G2> points = {G2()};
+    for (uint64_t k = 1; k < 8; ++k) points.push_back(G2::generator() * Fr(k * 104729));
+    return G2::batch_normalize(points);
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double mb_per_second(size_t bytes, double seconds) {
+    return bytes / 1e6 / std::max(seconds, 1e-9);
+}
+
+// One value of each kind the writer knows; replayed against a reader.
+struct Op {
+    int kind;
+    uint64_t word;
+    Fr fr;
+    std::vector<uint8_t> bytes;
+    std::vector<G1Affine> g1;
+    std::vector<G2Affine> g2;
+};
+
+static std::vector<Op> random_ops(size_t count, const std::vector<G1Affine>& p1, const std::vector<G2Affine>& p2) {
+    std::vector<Op> ops(count);
+    for (Op& op : ops) {
+        op.kind = static_cast<int>(random_uint64(0, 7));
+        op.word = random_uint64();
+        op.fr = Fr::random();
+        if (op.kind == 5) op.bytes = random_bytes(random_uint64(0, 100));
+        size_t n = random_uint64(0, 20);
+        if (op.kind == 3 || op.kind == 6) {
+            for (size_t i = 0; i < std::max<size_t>(n, 1); ++i) op.g1.push_back(p1[random_uint64(0, p1.size() - 1)]);
+        }
+        if (op.kind == 4 || op.kind == 7) {
+            for (size_t i = 0; i < std::max<size_t>(n, 1); ++i) op.g2.push_back(p2[random_uint64(0, p2.size() - 1)]);
+        }
+    }
+    return ops;
+}
+
+static void write_ops(ByteWriter& out, const std::vector<Op>& ops) {
+    for (const Op& op : ops) {
+        switch (op.kind) {
+        case 0: out.put_u32(static_cast<uint32_t>(op.word)); break;
+        case 1: out.put_u64(op.word); break;
+        case 2: out.put_fr(op.fr); break;
+        case 3: out.put_g1(op.g1[0].to_jacobian()); break;
+        case 4: out.put_g2(op.g2[0].to_jacobian()); break;
+        case 5: out.put_bytes(op.bytes.data(), op.bytes.size()); break;
+        case 6: out.put_g1_points(op.g1.data(), op.g1.size()); break;
+        case 7: out.put_g2_points(op.g2.data(), op.g2.size()); break;
+        }
+    }
+}
+
+static void check_ops(ByteReader& in, const std::vector<Op>& ops) {
+    for (const Op& op : ops) {
+        switch (op.kind) {
+        case 0: assert(in.get_u32() == static_cast<uint32_t>(op.word)); break;
+        case 1: assert(in.get_u64() == op.word); break;
+        case 2: assert(in.get_fr() == op.fr); break;
+        case 3: assert(G1Affine(in.get_g1()) == op.g1[0]); break;
+        case 4: assert(G2Affine(in.get_g2()) == op.g2[0]); break;
+        case 5: assert(std::memcmp(in.take(op.bytes.size()), op.bytes.data(), op.bytes.size()) == 0); break;
+        case 6: assert(in.get_g1_points(op.g1.size()) == op.g1); break;
+        case 7: assert(in.get_g2_points(op.g2.size()) == op.g2); break;
+        }
+    }
+    assert(in.at_end());
+}
+
+void test_writer_reader_fuzz() {
+    std::cout << "Testing ByteWriter/ByteReader round trip..." << std::endl;
+    
+    std::vector<G1Affine> p1 = g1_pool();
+    std::vector<G2Affine> p2 = g2_pool();
+    
+    for (int round = 0; round < 20; ++round) {
+        std::vector<Op> ops = random_ops(200, p1, p2);
+        
+        // No size hint: the buffer has to grow.
+        ByteWriter out;
+        write_ops(out, ops);
+        size_t size = out.size();
+        std::vector<uint8_t> bytes = out.take();
+        assert(bytes.size() == size);
+        
+        ByteReader in(bytes);
+        check_ops(in, ops);
+        
+        // Every strict prefix runs out somewhere and says so.
+        size_t cut = random_uint64(0, bytes.size() - 1);
+        ByteReader partial(bytes.data(), cut);
+        bool threw = false;
+        try {
+            check_ops(partial, ops);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    
+    // Little-endian integers, and r itself is not a field element.
+    ByteWriter out(12);
+    out.put_u32(0x04030201);
+    out.put_u64(0x0c0b0a0908070605ULL);
+    std::vector<uint8_t> bytes = out.take();
+    for (size_t i = 0; i < bytes.size(); ++i) assert(bytes[i] == i + 1);
+    
+    std::vector<uint8_t> r_bytes(32);
+    std::memcpy(r_bytes.data(), bn254_fr::MODULUS_BN254.data(), 32);
+    ByteReader r_in(r_bytes);
+    bool threw = false;
+    try {
+        r_in.get_fr();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    // A count larger than what is left is refused before anything is allocated.
+    ByteWriter huge;
+    huge.put_u64(UINT64_MAX / 2);
+    std::vector<uint8_t> huge_bytes = huge.take();
+    ByteReader huge_in(huge_bytes);
+    threw = false;
+    try {
+        huge_in.get_count(1);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "ByteWriter/ByteReader round trip test passed!" << std::endl;
+}
+
+void test_file_sink() {
+    std::cout << "Testing streaming file writer..." << std::endl;
+    
+    std::vector<G1Affine> p1 = g1_pool();
+    std::vector<G2Affine> p2 = g2_pool();
+    
+    // Several times the file buffer, and point runs that straddle its flushes.
+    std::vector<Op> ops = random_ops(500, p1, p2);
+    Op blob;
+    blob.kind = 5;
+    blob.bytes = random_bytes(3 * ByteWriter::FILE_BUFFER + 17);
+    ops.push_back(blob);
+    Op run;
+    run.kind = 6;
+    for (size_t i = 0; i < ByteWriter::FILE_BUFFER / 32 + 1000; ++i) run.g1.push_back(p1[i % p1.size()]);
+    ops.push_back(run);
+    ops.push_back(ops[0]);
+    
+    ByteWriter memory;
+    write_ops(memory, ops);
+    std::vector<uint8_t> expected = memory.take();
+    
+    const std::string path = "test_serialization.bin";
+    {
+        ByteWriter out(path);
+        write_ops(out, ops);
+        assert(out.size() == expected.size());
+        out.finish();
+    }
+    {
+        MappedFile file(path);
+        assert(file.size() == expected.size());
+        assert(std::memcmp(file.data(), expected.data(), expected.size()) == 0);
+        
+        ByteReader in(file.data(), file.size());
+        check_ops(in, ops);
+    }
+    
+    // A write cut short by an exception, after the buffer has already gone to disk,
+    // leaves neither a truncated file nor a temp file behind, and the file it was
+    // about to replace is untouched.
+    bool threw = false;
+    try {
+        ByteWriter out(path);
+        write_ops(out, ops);
+        assert(out.size() > ByteWriter::FILE_BUFFER);
+        throw std::runtime_error("interrupted");
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    assert(!std::ifstream(path + ".tmp").good());
+    {
+        MappedFile file(path);
+        assert(file.size() == expected.size());
+        assert(std::memcmp(file.data(), expected.data(), expected.size()) == 0);
+    }
+    std::remove(path.c_str());
+    
+    std::cout << "Streaming file writer test passed!" << std::endl;
+}
+
+// Decoding a damaged encoding either works or throws std::runtime_error; it never
+// reads out of bounds, allocates without limit or aborts.
+template <typename Decode>
+static void check_damage(const std::vector<uint8_t>& good, Decode decode) {
+    for (size_t cut = 0; cut < good.size(); ++cut) {
+        std::vector<uint8_t> truncated(good.begin(), good.begin() + cut);
+        bool threw = false;
+        try {
+            decode(truncated);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    for (int trial = 0; trial < 300; ++trial) {
+        std::vector<uint8_t> bad = good;
+        size_t flips = random_uint64(1, 4);
+        for (size_t f = 0; f < flips; ++f) bad[random_uint64(0, bad.size() - 1)] ^= 1 << random_uint64(0, 7);
+        try {
+            decode(bad);
+        } catch (const std::runtime_error&) {
+        }
+    }
+}
+
+void test_mutations() {
+    std::cout << "Testing damaged VK, proof, CRS and R1CS encodings..." << std::endl;
+    
+    std::vector<Fr> witness;
+    R1CS r = cubic_circuit(Fr(3), witness);
+    SparseQAP qap = r1cs_to_sparse_qap(r);
+    CRS crs = Groth16::setup(qap);
+    Proof proof = Groth16::prove(crs.pk, qap, witness);
+    
+    std::vector<uint8_t> vk_bytes = crs.vk.serialize();
+    assert(vk_bytes.size() == crs.vk.serialized_size());
+    VerifyingKey vk = VerifyingKey::deserialize(vk_bytes);
+    assert(vk.serialize() == vk_bytes);
+    check_damage(vk_bytes, [](const std::vector<uint8_t>& b) { VerifyingKey::deserialize(b); });
+    
+    std::vector<uint8_t> proof_bytes = proof.serialize();
+    assert(Proof::deserialize(proof_bytes).serialize() == proof_bytes);
+    check_damage(proof_bytes, [](const std::vector<uint8_t>& b) { Proof::deserialize(b); });
+    
+    std::vector<uint8_t> crs_bytes = crs.serialize();
+    assert(crs_bytes.size() == 16 + crs.pk.serialized_size() + crs.vk.serialized_size());
+    CRS crs_back = CRS::deserialize(crs_bytes);
+    assert(crs_back.serialize() == crs_bytes);
+    check_damage(crs_bytes, [](const std::vector<uint8_t>& b) { CRS::deserialize(b); });
+    
+    // Well-formed points but query lengths that disagree with the header are
+    // rejected on load, before prove() or verify() could trip over them.
+    auto rejects = [](auto decode) {
+        try {
+            decode();
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    ProvingKey short_k = crs.pk;
+    short_k.K_query_g1.pop_back();
+    std::vector<uint8_t> short_k_bytes = short_k.serialize();
+    assert(rejects([&] { ProvingKey::deserialize(short_k_bytes); }));
+    ProvingKey extra_h = crs.pk;
+    extra_h.H_query_g1.push_back(extra_h.H_query_g1[0]);
+    std::vector<uint8_t> extra_h_bytes = extra_h.serialize();
+    assert(rejects([&] { ProvingKey::deserialize(extra_h_bytes); }));
+    VerifyingKey short_ic = crs.vk;
+    short_ic.IC_g1.pop_back();
+    std::vector<uint8_t> short_ic_bytes = short_ic.serialize();
+    assert(rejects([&] { VerifyingKey::deserialize(short_ic_bytes); }));
+    
+    // A G2 point on the curve but carrying the order-3 point (0, sqrt(3)) is
+    // rejected, not handed to the pairing.
+    Fq2 sqrt3;
+    assert(Fq2(Fq(3), Fq()).sqrt(sqrt3));
+    G2 torsion(Fq2(), sqrt3);
+    Proof bad_b = proof;
+    bad_b.B = proof.B + torsion;
+    assert(bad_b.B.is_on_curve() && !bad_b.B.is_in_subgroup() && proof.B.is_in_subgroup());
+    std::vector<uint8_t> bad_b_bytes = bad_b.serialize();
+    assert(rejects([&] { Proof::deserialize(bad_b_bytes); }));
+    VerifyingKey bad_delta = crs.vk;
+    bad_delta.delta_g2 = crs.vk.delta_g2 + torsion;
+    std::vector<uint8_t> bad_delta_bytes = bad_delta.serialize();
+    assert(rejects([&] { VerifyingKey::deserialize(bad_delta_bytes); }));
+    
+    std::vector<uint8_t> r1cs_bytes = r.serialize();
+    R1CS r_back = R1CS::deserialize(r1cs_bytes);
+    assert(r_back.serialize() == r1cs_bytes);
+    assert(r_back.is_satisfied(witness));
+    check_damage(r1cs_bytes, [](const std::vector<uint8_t>& b) { R1CS::deserialize(b); });
+    
+    std::cout << "Damaged encoding test passed!" << std::endl;
+}
+
+void test_throughput() {
+    std::cout << "Testing serialisation throughput..." << std::endl;
+    
+    // A synthetic key: the queries only need to be valid points, of the lengths the
+    // header implies (K skips the constant and the public input).
+    std::vector<G1Affine> p1 = g1_pool();
+    std::vector<G2Affine> p2 = g2_pool();
+    const size_t n = 1 << 13;
+    ProvingKey pk;
+    pk.num_variables = n;
+    pk.num_public = 1;
+    pk.degree = n;
+    for (size_t i = 0; i < n; ++i) {
+        pk.A_query_g1.push_back(p1[i % p1.size()]);
+        pk.B_query_g1.push_back(p1[(i + 3) % p1.size()]);
+        pk.B_query_g2.push_back(p2[i % p2.size()]);
+        if (i + 2 < n) pk.K_query_g1.push_back(p1[(i + 5) % p1.size()]);
+        pk.H_query_g1.push_back(p1[(i + 7) % p1.size()]);
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint8_t> bytes = pk.serialize();
+    double write_s = seconds_since(start);
+    assert(bytes.size() == pk.serialized_size());
+    
+    start = std::chrono::steady_clock::now();
+    ProvingKey back = ProvingKey::deserialize(bytes);
+    double read_s = seconds_since(start);
+    assert(back.H_query_g1 == pk.H_query_g1 && back.B_query_g2 == pk.B_query_g2);
+    
+    const std::string path = "test_serialization.pk";
+    start = std::chrono::steady_clock::now();
+    pk.save_to_file(path);
+    double save_s = seconds_since(start);
+    start = std::chrono::steady_clock::now();
+    ProvingKey loaded = ProvingKey::load_from_file(path);
+    double load_s = seconds_since(start);
+    assert(loaded.A_query_g1 == pk.A_query_g1);
+    std::remove(path.c_str());
+    
+    std::cout << "  proving key, " << bytes.size() / 1000 << " kB: serialize " << mb_per_second(bytes.size(), write_s)
+              << " MB/s, deserialize " << mb_per_second(bytes.size(), read_s) << " MB/s, save "
+              << mb_per_second(bytes.size(), save_s) << " MB/s, load " << mb_per_second(bytes.size(), load_s)
+              << " MB/s" << std::endl;
+    
+    // R1CS: plain integers and field elements, no point arithmetic.
+    R1CS r;
+    VarIdx prev = r.allocate_var();
+    for (size_t i = 0; i < 50000; ++i) {
+        VarIdx next = r.allocate_var();
+        r.add_mul(prev, prev, next);
+        prev = next;
+    }
+    start = std::chrono::steady_clock::now();
+    std::vector<uint8_t> r1cs_bytes = r.serialize();
+    write_s = seconds_since(start);
+    start = std::chrono::steady_clock::now();
+    R1CS r_back = R1CS::deserialize(r1cs_bytes);
+    read_s = seconds_since(start);
+    assert(r_back.num_constraints() == r.num_constraints());
+    
+    std::cout << "  R1CS, " << r1cs_bytes.size() / 1000 << " kB: serialize " << mb_per_second(r1cs_bytes.size(), write_s)
+              << " MB/s, deserialize " << mb_per_second(r1cs_bytes.size(), read_s) << " MB/s" << std::endl;
+    
+    std::cout << "Serialisation throughput test passed!" << std::endl;
+}
+
+int main() {
+    // Exercise the threaded path even on a single-core machine.
+    setenv("ZKMINI_THREADS", "4", 0);
+    
+    try {
+        std::cout << "=== Serialization Tests ===" << std::endl;
+        
+        test_writer_reader_fuzz();
+        test_file_sink();
+        test_mutations();
+        test_throughput();
+        
+        std::cout << "All serialization tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
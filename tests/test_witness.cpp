@@ -0,0 +1,219 @@
+#include "zkmini/witness.hpp"
+#include "zkmini/utils.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+using namespace zkmini;
+
+void test_from_decimal() {
+    std::cout << "Testing Fr::from_decimal..." << std::endl;
+    
+    assert(Fr::from_decimal("0") == Fr(0));
+    assert(Fr::from_decimal("123") == Fr(123));
+    assert(Fr::from_decimal("18446744073709551615") == Fr(UINT64_MAX));
+    assert(Fr::from_decimal("18446744073709551616") == Fr(UINT64_MAX) + Fr(1));
+    
+    // r - 1 and r itself.
+    assert(Fr::from_decimal("21888242871839275222246405745257275088548364400416034343698204186575808495616") ==
+           Fr(0) - Fr(1));
+    assert(Fr::from_decimal("21888242871839275222246405745257275088548364400416034343698204186575808495617") ==
+           Fr(0));
+    
+    for (const char* bad : {"", "12a", "-5", "0x10"}) {
+        bool threw = false;
+        try {
+            Fr::from_decimal(bad);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    
+    std::cout << "Fr::from_decimal test passed!" << std::endl;
+}
+
+void test_cubic_witness() {
+    std::cout << "Testing witness program for x^3 + x + 5..." << std::endl;
+    
+    CircuitBuilder cb;
+    VarIdx out = cb.public_output();
+    VarIdx x = cb.private_input();
+    VarIdx sq = cb.mul(R1CS::lc_var(x), R1CS::lc_var(x));
+    VarIdx cube = cb.mul(R1CS::lc_var(sq), R1CS::lc_var(x));
+    cb.set_output(out, R1CS::lc_from_terms({Term(cube, 1), Term(x, 1), Term(0, 5)}));
+    
+    assert(cb.r1cs().num_variables() == 5);
+    assert(cb.r1cs().public_inputs() == std::vector<VarIdx>{1});
+    assert(cb.program().is_complete());
+    
+    std::vector<Fr> w = cb.witness({}, {Fr(3)});
+    assert(w.size() == 5);
+    assert(w[0] == Fr(1));
+    assert(w[out] == Fr(35));
+    assert(cb.r1cs().is_satisfied(w));
+    assert(cb.witness({}, {Fr(3)}, true) == w);
+    
+    bool threw = false;
+    try {
+        cb.witness({}, {});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "Cubic witness test passed!" << std::endl;
+}
+
+void test_gadgets() {
+    std::cout << "Testing inverse, bits and hints..." << std::endl;
+    
+    CircuitBuilder cb;
+    VarIdx a = cb.public_input();
+    VarIdx b = cb.private_input();
+    
+    VarIdx inv = cb.inverse(R1CS::lc_var(b));
+    std::vector<VarIdx> bits = cb.to_bits(R1CS::lc_from_terms({Term(a, 1), Term(b, 1)}), 16);
+    
+    // is_zero(a - b) from a hinted inverse: (a - b) * t = 1 - z, (a - b) * z = 0.
+    LinearCombination diff = R1CS::lc_from_terms({Term(a, Fr(1)), Term(b, Fr(0) - Fr(1))});
+    std::vector<VarIdx> hinted = cb.hint(2, {a, b}, [](const std::vector<Fr>& in, std::vector<Fr>& out) {
+        Fr d = in[0] - in[1];
+        out[0] = d.is_zero() ? Fr(0) : d.inverse();
+        out[1] = d.is_zero() ? Fr(1) : Fr(0);
+    });
+    VarIdx t = hinted[0];
+    VarIdx z = hinted[1];
+    cb.r1cs().add_constraint(diff, R1CS::lc_var(t), R1CS::lc_from_terms({Term(0, Fr(1)), Term(z, Fr(0) - Fr(1))}));
+    cb.r1cs().add_constraint(diff, R1CS::lc_var(z), LinearCombination());
+    
+    for (bool parallel : {false, true}) {
+        std::vector<Fr> w = cb.witness({Fr(1000)}, {Fr(234)}, parallel);
+        assert(cb.r1cs().is_satisfied(w));
+        assert(w[inv] * Fr(234) == Fr(1));
+        uint64_t sum = 0;
+        for (size_t i = 0; i < bits.size(); ++i) {
+            assert(w[bits[i]] == Fr(0) || w[bits[i]] == Fr(1));
+            if (w[bits[i]] == Fr(1)) sum |= uint64_t(1) << i;
+        }
+        assert(sum == 1234);
+        assert(w[z] == Fr(0));
+        
+        w = cb.witness({Fr(77)}, {Fr(77)}, parallel);
+        assert(cb.r1cs().is_satisfied(w));
+        assert(w[z] == Fr(1));
+        
+        // Inverse of zero comes out as zero and fails the constraint instead of aborting.
+        w = cb.witness({Fr(5)}, {Fr(0)}, parallel);
+        assert(w[inv] == Fr(0));
+        assert(!cb.r1cs().is_satisfied(w));
+    }
+    
+    std::cout << "Gadget test passed!" << std::endl;
+}
+
+void test_parallel_levels() {
+    std::cout << "Testing level-parallel witness generation..." << std::endl;
+    
+    // Many independent sub-circuits, each a short dependency chain with a division.
+    const size_t instances = 3000;
+    CircuitBuilder cb;
+    VarIdx seed = cb.public_input();
+    std::vector<VarIdx> xs;
+    for (size_t i = 0; i < instances; ++i) xs.push_back(cb.private_input());
+    
+    LinearCombination total;
+    for (size_t i = 0; i < instances; ++i) {
+        LinearCombination x = R1CS::lc_from_terms({Term(xs[i], Fr(1)), Term(seed, Fr(i + 1))});
+        VarIdx sq = cb.mul(x, x);
+        VarIdx inv = cb.inverse(R1CS::lc_from_terms({Term(sq, Fr(1)), Term(0, Fr(1))}));
+        std::vector<VarIdx> bits = cb.to_bits(R1CS::lc_var(xs[i]), 12);
+        VarIdx mix = cb.mul(R1CS::lc_var(inv), R1CS::lc_from_terms({Term(bits[0], Fr(3)), Term(bits[11], Fr(5))}));
+        total.push_back(Term(mix, Fr(1)));
+    }
+    VarIdx sum = cb.linear(total);
+    
+    std::vector<Fr> priv;
+    for (size_t i = 0; i < instances; ++i) priv.push_back(Fr((i * 2654435761ULL) % 4096));
+    
+    std::vector<Fr> serial = cb.witness({Fr(17)}, priv);
+    std::vector<Fr> parallel = cb.witness({Fr(17)}, priv, true);
+    assert(serial == parallel);
+    assert(cb.r1cs().is_satisfied(parallel));
+    assert(!parallel[sum].is_zero());
+    
+    std::cout << "Level-parallel test passed!" << std::endl;
+}
+
+static bool rejects_wtns(const std::vector<uint8_t>& bytes) {
+    try {
+        WitnessFile::parse(bytes.data(), bytes.size());
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+void test_wtns_roundtrip() {
+    std::cout << "Testing .wtns read/write..." << std::endl;
+    
+    std::vector<Fr> w = {Fr(1), Fr(35), Fr(3), Fr(0) - Fr(1)};
+    for (int i = 0; i < 200000; ++i) w.push_back(Fr::random());
+    
+    std::vector<uint8_t> bytes = WitnessFile::encode(w);
+    assert(bytes.size() == 76 + 32 * w.size());
+    assert(std::memcmp(bytes.data(), "wtns", 4) == 0);
+    assert(bytes[4] == 2 && bytes[8] == 2);
+    // Header section: field size, then the prime, then the count.
+    assert(bytes[12] == 1 && bytes[16] == 40 && bytes[24] == 32);
+    assert(bytes[28] == 0x01 && bytes[28 + 31] == 0x30);
+    // Values section: wire 1 = 35, little-endian.
+    assert(bytes[64] == 2 && bytes[76] == 1 && bytes[76 + 32] == 35);
+    
+    assert(WitnessFile::parse(bytes.data(), bytes.size()) == w);
+    
+    const std::string path = "test_witness.wtns";
+    WitnessFile::save(path, w);
+    assert(WitnessFile::load(path) == w);
+    std::remove(path.c_str());
+    
+    // Magic, truncation, a value past r, a foreign prime.
+    std::vector<uint8_t> bad = bytes;
+    bad[0] = 'x';
+    assert(rejects_wtns(bad));
+    bad = bytes;
+    bad.resize(bad.size() - 1);
+    assert(rejects_wtns(bad));
+    bad = bytes;
+    std::memset(bad.data() + 76 + 32 * 2, 0xFF, 32);
+    assert(rejects_wtns(bad));
+    bad = bytes;
+    bad[28] ^= 1;
+    assert(rejects_wtns(bad));
+    
+    std::cout << ".wtns test passed!" << std::endl;
+}
+
+int main() {
+    // Exercise the threaded path even on a single-core machine.
+    setenv("ZKMINI_THREADS", "4", 0);
+    
+    try {
+        std::cout << "=== Witness Tests ===" << std::endl;
+        
+        test_from_decimal();
+        test_cubic_witness();
+        test_gadgets();
+        test_parallel_levels();
+        test_wtns_roundtrip();
+        
+        std::cout << "All witness tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}